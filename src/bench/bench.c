@@ -0,0 +1,316 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#define SDL_MAIN_HANDLED
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL.h>
+
+#include <cdogs/log.h>
+#include <cdogs/utils.h>
+
+#define BENCH_MIN_MS 100
+#define BENCH_REPEATS 5
+#define BENCH_SEED 42
+#define BENCH_DEFAULT_THRESHOLD 10.0
+
+volatile int gBenchSink = 0;
+size_t gBenchBytes = 0;
+
+typedef struct
+{
+	char Name[64];
+	int Iterations;
+	double NsPerOp;
+	double BytesPerOp;
+} BenchResult;
+
+static double TimeRun(const Benchmark *b, const int n)
+{
+	srand(BENCH_SEED);
+	gBenchBytes = 0;
+	const Uint64 start = SDL_GetPerformanceCounter();
+	b->Run(n);
+	const Uint64 end = SDL_GetPerformanceCounter();
+	return (double)(end - start) * 1e9 / (double)SDL_GetPerformanceFrequency();
+}
+
+// Double the iteration count until a run takes at least minMs, then take
+// the best of several runs to reduce noise
+static BenchResult RunBenchmark(const Benchmark *b, const int minMs)
+{
+	BenchResult r;
+	memset(&r, 0, sizeof r);
+	strncpy(r.Name, b->Name, sizeof r.Name - 1);
+	int n = 1;
+	for (;;)
+	{
+		const double ns = TimeRun(b, n);
+		if (ns >= minMs * 1e6 || n >= (1 << 30))
+		{
+			break;
+		}
+		n *= 2;
+	}
+	r.Iterations = n;
+	double best = -1;
+	for (int i = 0; i < BENCH_REPEATS; i++)
+	{
+		const double ns = TimeRun(b, n);
+		if (best < 0 || ns < best)
+		{
+			best = ns;
+		}
+	}
+	r.NsPerOp = best / n;
+	// Runs are seeded the same so bytes sent don't vary between them
+	r.BytesPerOp = (double)gBenchBytes / n;
+	return r;
+}
+
+// Load results in the same CSV format that we write
+static void LoadBaseline(CArray *results, const char *filename)
+{
+	CArrayInit(results, sizeof(BenchResult));
+	FILE *f = fopen(filename, "r");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Cannot open baseline %s\n", filename);
+		return;
+	}
+	char buf[256];
+	while (fgets(buf, sizeof buf, f) != NULL)
+	{
+		BenchResult r;
+		memset(&r, 0, sizeof r);
+		if (sscanf(buf, "%63[^,],%d,%lf", r.Name, &r.Iterations, &r.NsPerOp) !=
+			3)
+		{
+			// Header or malformed line
+			continue;
+		}
+		CArrayPushBack(results, &r);
+	}
+	fclose(f);
+}
+static const BenchResult *FindResult(const CArray *results, const char *name)
+{
+	CA_FOREACH(const BenchResult, r, *results)
+	if (strcmp(r->Name, name) == 0)
+	{
+		return r;
+	}
+	CA_FOREACH_END()
+	return NULL;
+}
+
+static void WriteResults(FILE *f, const CArray *results)
+{
+	fprintf(f, "name,iterations,ns_per_op,bytes_per_op\n");
+	CA_FOREACH(const BenchResult, r, *results)
+	fprintf(
+		f, "%s,%d,%.2f,%.2f\n", r->Name, r->Iterations, r->NsPerOp,
+		r->BytesPerOp);
+	CA_FOREACH_END()
+}
+
+// Print comparison against baseline; returns number of regressions
+static int CompareResults(
+	const CArray *results, const CArray *baseline, const double threshold)
+{
+	int regressions = 0;
+	printf("name,ns_per_op,baseline_ns_per_op,change_pct\n");
+	CA_FOREACH(const BenchResult, r, *results)
+	const BenchResult *b = FindResult(baseline, r->Name);
+	if (b == NULL || b->NsPerOp <= 0)
+	{
+		printf("%s,%.2f,,\n", r->Name, r->NsPerOp);
+		continue;
+	}
+	const double change = (r->NsPerOp - b->NsPerOp) * 100.0 / b->NsPerOp;
+	printf("%s,%.2f,%.2f,%+.1f\n", r->Name, r->NsPerOp, b->NsPerOp, change);
+	if (change > threshold)
+	{
+		fprintf(
+			stderr, "Regression: %s is %.1f%% slower than baseline\n",
+			r->Name, change);
+		regressions++;
+	}
+	CA_FOREACH_END()
+	return regressions;
+}
+
+static void PrintUsage(void)
+{
+	printf(
+		"Usage: cdogs_bench [options] [filter]\n"
+		"  --out=FILE        write results as CSV to FILE\n"
+		"  --baseline=FILE   compare against results from a previous run\n"
+		"  --threshold=PCT   slowdown that counts as regression (default "
+		"%.0f)\n"
+		"  --min-time=MS     minimum time per timed run (default %d)\n"
+		"  --list            list benchmarks and exit\n"
+		"Only benchmarks whose names contain filter are run.\n",
+		BENCH_DEFAULT_THRESHOLD, BENCH_MIN_MS);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *outFile = NULL;
+	const char *baselineFile = NULL;
+	const char *filter = NULL;
+	double threshold = BENCH_DEFAULT_THRESHOLD;
+	int minMs = BENCH_MIN_MS;
+	bool list = false;
+	for (int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		if (strncmp(arg, "--out=", strlen("--out=")) == 0)
+		{
+			outFile = arg + strlen("--out=");
+		}
+		else if (strncmp(arg, "--baseline=", strlen("--baseline=")) == 0)
+		{
+			baselineFile = arg + strlen("--baseline=");
+		}
+		else if (strncmp(arg, "--threshold=", strlen("--threshold=")) == 0)
+		{
+			threshold = atof(arg + strlen("--threshold="));
+		}
+		else if (strncmp(arg, "--min-time=", strlen("--min-time=")) == 0)
+		{
+			minMs = MAX(1, atoi(arg + strlen("--min-time=")));
+		}
+		else if (strcmp(arg, "--list") == 0)
+		{
+			list = true;
+		}
+		else if (arg[0] == '-')
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+		else
+		{
+			filter = arg;
+		}
+	}
+
+	LogInit();
+	for (LogModule m = LM_MAIN; m < LM_COUNT; m++)
+	{
+		LogModuleSetLevel(m, LL_WARN);
+	}
+	if (SDL_Init(SDL_INIT_TIMER) != 0)
+	{
+		fprintf(stderr, "Failed to init SDL: %s\n", SDL_GetError());
+		return EXIT_FAILURE;
+	}
+
+	CArray benchmarks;
+	CArrayInit(&benchmarks, sizeof(Benchmark));
+	BenchCoreRegister(&benchmarks);
+	BenchMapRegister(&benchmarks);
+	BenchNetRegister(&benchmarks);
+
+	CArray results;
+	CArrayInit(&results, sizeof(BenchResult));
+	CA_FOREACH(const Benchmark, b, benchmarks)
+	if (filter != NULL && strstr(b->Name, filter) == NULL)
+	{
+		continue;
+	}
+	if (list)
+	{
+		printf("%s\n", b->Name);
+		continue;
+	}
+	if (b->Setup != NULL && !b->Setup())
+	{
+		fprintf(stderr, "Skipping %s\n", b->Name);
+		continue;
+	}
+	const BenchResult r = RunBenchmark(b, minMs);
+	if (b->Teardown != NULL)
+	{
+		b->Teardown();
+	}
+	fprintf(
+		stderr, "%-32s %10d iterations %14.2f ns/op", r.Name, r.Iterations,
+		r.NsPerOp);
+	if (r.BytesPerOp > 0)
+	{
+		fprintf(stderr, " %10.2f bytes/op", r.BytesPerOp);
+	}
+	fprintf(stderr, "\n");
+	CArrayPushBack(&results, &r);
+	CA_FOREACH_END()
+
+	int err = EXIT_SUCCESS;
+	if (!list)
+	{
+		if (baselineFile != NULL)
+		{
+			CArray baseline;
+			LoadBaseline(&baseline, baselineFile);
+			if (CompareResults(&results, &baseline, threshold) > 0)
+			{
+				err = EXIT_FAILURE;
+			}
+			CArrayTerminate(&baseline);
+		}
+		else
+		{
+			WriteResults(stdout, &results);
+		}
+		if (outFile != NULL)
+		{
+			FILE *f = fopen(outFile, "w");
+			if (f == NULL)
+			{
+				fprintf(stderr, "Cannot write %s\n", outFile);
+				err = EXIT_FAILURE;
+			}
+			else
+			{
+				WriteResults(f, &results);
+				fclose(f);
+			}
+		}
+	}
+
+	BenchMapTerminate();
+	CArrayTerminate(&results);
+	CArrayTerminate(&benchmarks);
+	SDL_Quit();
+	LogTerminate();
+	return err;
+}
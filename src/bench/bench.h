@@ -0,0 +1,56 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <cdogs/c_array.h>
+
+// A single micro-benchmark
+// Setup is run once before timing and may return false to skip the
+// benchmark (e.g. if game data is unavailable)
+// Run is called with the number of iterations to perform
+typedef struct
+{
+	const char *Name;
+	bool (*Setup)(void);
+	void (*Run)(const int n);
+	void (*Teardown)(void);
+} Benchmark;
+
+// Prevent the compiler from optimising out benchmark results
+extern volatile int gBenchSink;
+// Benchmarks that measure bandwidth add the bytes they send here
+extern size_t gBenchBytes;
+
+void BenchCoreRegister(CArray *benchmarks); // of Benchmark
+void BenchMapRegister(CArray *benchmarks);	// of Benchmark
+void BenchNetRegister(CArray *benchmarks);	// of Benchmark
+// Free game data loaded by the map benchmarks
+void BenchMapTerminate(void);
@@ -0,0 +1,274 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cdogs/c_hashmap/hashmap.h>
+#include <cdogs/collision/minkowski_hex.h>
+#include <cdogs/utils.h>
+
+#include "proto/msg.pb.h"
+#include "proto/nanopb/pb_decode.h"
+#include "proto/nanopb/pb_encode.h"
+
+#define ARRAY_BENCH_SIZE 1000
+#define HASHMAP_BENCH_KEYS 1000
+#define COLLIDE_BENCH_INPUTS 256
+
+static void CArrayPushGetRun(const int n)
+{
+	CArray a;
+	CArrayInit(&a, sizeof(int));
+	for (int i = 0; i < n; i++)
+	{
+		if (a.size == ARRAY_BENCH_SIZE)
+		{
+			CArrayClear(&a);
+		}
+		CArrayPushBack(&a, &i);
+		gBenchSink += *(int *)CArrayGet(&a, rand() % a.size);
+	}
+	CArrayTerminate(&a);
+}
+
+static CArray sArray;
+static bool CArrayInsertDeleteSetup(void)
+{
+	CArrayInit(&sArray, sizeof(int));
+	for (int i = 0; i < ARRAY_BENCH_SIZE; i++)
+	{
+		CArrayPushBack(&sArray, &i);
+	}
+	return true;
+}
+static void CArrayInsertDeleteRun(const int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		const size_t idx = rand() % sArray.size;
+		CArrayInsert(&sArray, idx, &i);
+		CArrayDelete(&sArray, rand() % sArray.size);
+	}
+}
+static void CArrayInsertDeleteTeardown(void)
+{
+	CArrayTerminate(&sArray);
+}
+
+static map_t sHashmap;
+static char sHashmapKeys[HASHMAP_BENCH_KEYS][16];
+static bool HashmapSetup(void)
+{
+	sHashmap = hashmap_new();
+	for (int i = 0; i < HASHMAP_BENCH_KEYS; i++)
+	{
+		sprintf(sHashmapKeys[i], "key%d", i);
+		if (hashmap_put(sHashmap, sHashmapKeys[i], NULL) != MAP_OK)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+static void HashmapGetRun(const int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		any_t value;
+		gBenchSink += hashmap_get(
+			sHashmap, sHashmapKeys[rand() % HASHMAP_BENCH_KEYS], &value);
+	}
+}
+static void HashmapPutRun(const int n)
+{
+	// Overwrite existing keys so the map size stays constant
+	for (int i = 0; i < n; i++)
+	{
+		gBenchSink += hashmap_put(
+			sHashmap, sHashmapKeys[rand() % HASHMAP_BENCH_KEYS], NULL);
+	}
+}
+static void HashmapTeardown(void)
+{
+	hashmap_free(sHashmap);
+}
+
+typedef struct
+{
+	struct vec2 PosA;
+	struct vec2 VelA;
+	struct vec2i SizeA;
+	struct vec2 PosB;
+	struct vec2 VelB;
+	struct vec2i SizeB;
+} CollideInput;
+static CollideInput sCollideInputs[COLLIDE_BENCH_INPUTS];
+static float RandFloat(const float range)
+{
+	return (float)rand() / RAND_MAX * range * 2 - range;
+}
+static bool MinkowskiHexSetup(void)
+{
+	srand(0);
+	for (int i = 0; i < COLLIDE_BENCH_INPUTS; i++)
+	{
+		CollideInput *c = &sCollideInputs[i];
+		c->PosA = svec2(RandFloat(20), RandFloat(20));
+		c->VelA = svec2(RandFloat(5), RandFloat(5));
+		c->SizeA = svec2i(rand() % 8 + 2, rand() % 8 + 2);
+		c->PosB = svec2(RandFloat(20), RandFloat(20));
+		c->VelB = svec2(RandFloat(5), RandFloat(5));
+		c->SizeB = svec2i(rand() % 8 + 2, rand() % 8 + 2);
+	}
+	return true;
+}
+static void MinkowskiHexRun(const int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		const CollideInput *c = &sCollideInputs[i % COLLIDE_BENCH_INPUTS];
+		struct vec2 colA, colB, normal;
+		gBenchSink += MinkowskiHexCollide(
+			c->PosA, c->VelA, c->SizeA, c->PosB, c->VelB, c->SizeB, &colA,
+			&colB, &normal);
+	}
+}
+
+static NActorMove MakeActorMove(const int i)
+{
+	NActorMove m = NActorMove_init_default;
+	m.UID = i;
+	m.has_Pos = true;
+	m.Pos.x = (float)i;
+	m.Pos.y = (float)(i * 2);
+	m.has_MoveVel = true;
+	m.MoveVel.x = 1.5f;
+	m.MoveVel.y = -0.5f;
+	return m;
+}
+static NAddBullet MakeAddBullet(const int i)
+{
+	NAddBullet b = NAddBullet_init_default;
+	b.UID = i;
+	strcpy(b.BulletClass, "bullet");
+	b.has_MuzzlePos = true;
+	b.MuzzlePos.x = (float)i;
+	b.MuzzlePos.y = (float)(i * 2);
+	b.MuzzleHeight = 10;
+	b.Angle = 1.25f;
+	b.Elevation = 2;
+	b.Flags = 1;
+	b.ActorUID = i + 1;
+	strcpy(b.Gun, "Machine gun");
+	return b;
+}
+static void PBEncodeActorMoveRun(const int n)
+{
+	uint8_t buf[256];
+	for (int i = 0; i < n; i++)
+	{
+		const NActorMove m = MakeActorMove(i);
+		pb_ostream_t os = pb_ostream_from_buffer(buf, sizeof buf);
+		gBenchSink += pb_encode(&os, NActorMove_fields, &m);
+		gBenchSink += (int)os.bytes_written;
+	}
+}
+static void PBDecodeActorMoveRun(const int n)
+{
+	uint8_t buf[256];
+	const NActorMove m = MakeActorMove(1234);
+	pb_ostream_t os = pb_ostream_from_buffer(buf, sizeof buf);
+	pb_encode(&os, NActorMove_fields, &m);
+	for (int i = 0; i < n; i++)
+	{
+		NActorMove d = NActorMove_init_default;
+		pb_istream_t is = pb_istream_from_buffer(buf, os.bytes_written);
+		gBenchSink += pb_decode(&is, NActorMove_fields, &d);
+		gBenchSink += d.UID;
+	}
+}
+static void PBEncodeAddBulletRun(const int n)
+{
+	uint8_t buf[512];
+	for (int i = 0; i < n; i++)
+	{
+		const NAddBullet b = MakeAddBullet(i);
+		pb_ostream_t os = pb_ostream_from_buffer(buf, sizeof buf);
+		gBenchSink += pb_encode(&os, NAddBullet_fields, &b);
+		gBenchSink += (int)os.bytes_written;
+	}
+}
+static void PBDecodeAddBulletRun(const int n)
+{
+	uint8_t buf[512];
+	const NAddBullet b = MakeAddBullet(1234);
+	pb_ostream_t os = pb_ostream_from_buffer(buf, sizeof buf);
+	pb_encode(&os, NAddBullet_fields, &b);
+	for (int i = 0; i < n; i++)
+	{
+		NAddBullet d = NAddBullet_init_default;
+		pb_istream_t is = pb_istream_from_buffer(buf, os.bytes_written);
+		gBenchSink += pb_decode(&is, NAddBullet_fields, &d);
+		gBenchSink += d.UID;
+	}
+}
+
+static void Register(
+	CArray *benchmarks, const char *name, bool (*setup)(void),
+	void (*run)(const int), void (*teardown)(void))
+{
+	Benchmark b = {name, setup, run, teardown};
+	CArrayPushBack(benchmarks, &b);
+}
+void BenchCoreRegister(CArray *benchmarks)
+{
+	Register(benchmarks, "carray_push_get", NULL, CArrayPushGetRun, NULL);
+	Register(
+		benchmarks, "carray_insert_delete", CArrayInsertDeleteSetup,
+		CArrayInsertDeleteRun, CArrayInsertDeleteTeardown);
+	Register(
+		benchmarks, "hashmap_get", HashmapSetup, HashmapGetRun,
+		HashmapTeardown);
+	Register(
+		benchmarks, "hashmap_put", HashmapSetup, HashmapPutRun,
+		HashmapTeardown);
+	Register(
+		benchmarks, "minkowski_hex_collide", MinkowskiHexSetup,
+		MinkowskiHexRun, NULL);
+	Register(
+		benchmarks, "pb_encode_actor_move", NULL, PBEncodeActorMoveRun, NULL);
+	Register(
+		benchmarks, "pb_decode_actor_move", NULL, PBDecodeActorMoveRun, NULL);
+	Register(
+		benchmarks, "pb_encode_add_bullet", NULL, PBEncodeAddBulletRun, NULL);
+	Register(
+		benchmarks, "pb_decode_add_bullet", NULL, PBDecodeAddBulletRun, NULL);
+}
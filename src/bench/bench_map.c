@@ -0,0 +1,358 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <cdogs/ammo.h>
+#include <cdogs/campaigns.h>
+#include <cdogs/character_class.h>
+#include <cdogs/collision/collision.h>
+#include <cdogs/config.h>
+#include <cdogs/draw/char_sprites.h>
+#include <cdogs/font_utils.h>
+#include <cdogs/game_events.h>
+#include <cdogs/gamedata.h>
+#include <cdogs/grafx.h>
+#include <cdogs/handle_game_events.h>
+#include <cdogs/los.h>
+#include <cdogs/map_build.h>
+#include <cdogs/map_new.h>
+#include <cdogs/map_object.h>
+#include <cdogs/mission_convert.h>
+#include <cdogs/particle.h>
+#include <cdogs/path_cache.h>
+#include <cdogs/pic_manager.h>
+#include <cdogs/pickup_class.h>
+#include <cdogs/player.h>
+#include <cdogs/sounds.h>
+#include <cdogs/utils.h>
+
+#define BENCH_CAMPAIGN "missions/ogre.cdogscpn"
+
+typedef enum
+{
+	DATA_UNLOADED,
+	DATA_LOADED,
+	DATA_MISSING
+} DataState;
+static DataState sDataState = DATA_UNLOADED;
+static bool sCampaignLoaded = false;
+static Mission sMission;
+static bool sMissionInit = false;
+static CArray sWalkable; // of struct vec2i
+
+// Load game data in the same order as the game, but headless
+static bool DataLoad(void)
+{
+	if (sDataState != DATA_UNLOADED)
+	{
+		return sDataState == DATA_LOADED;
+	}
+	char buf[CDOGS_PATH_MAX];
+	GetDataFilePath(buf, "data/map_objects.json");
+	FILE *f = fopen(buf, "r");
+	if (f == NULL)
+	{
+		fprintf(
+			stderr, "Game data not found (%s); set CDOGS_DATA_DIR\n", buf);
+		sDataState = DATA_MISSING;
+		return false;
+	}
+	fclose(f);
+
+	gConfig = ConfigDefault();
+	PicManagerInit(&gPicManager);
+	GraphicsInit(&gGraphicsDevice, &gConfig);
+	GraphicsInitializeHeadless(&gGraphicsDevice);
+	FontLoadFromJSON(&gFont, "graphics/font.png", "graphics/font.json");
+	PicManagerLoad(&gPicManager);
+	SoundInitializeNull(&gSoundDevice);
+	CharSpriteClassesInit(&gCharSpriteClasses);
+	ParticleClassesInit(&gParticleClasses, "data/particles.json");
+	AmmoInitialize(&gAmmo, "data/ammo.json");
+	BulletAndWeaponInitialize(
+		&gBulletClasses, &gWeaponClasses, "data/bullets.json",
+		"data/guns.json");
+	CharacterClassesInitialize(
+		&gCharacterClasses, "data/character_classes.json");
+	PickupClassesInit(
+		&gPickupClasses, "data/pickups.json", &gAmmo, &gWeaponClasses);
+	MapObjectsInit(
+		&gMapObjects, "data/map_objects.json", &gAmmo, &gWeaponClasses);
+	CollisionSystemInit(&gCollisionSystem);
+	CampaignInit(&gCampaign);
+	PlayerDataInit(&gPlayerDatas);
+	GameEventsInit(&gGameEvents);
+	sDataState = DATA_LOADED;
+	return true;
+}
+
+// Load the benchmark campaign and set up its first mission
+static bool CampaignReady(void)
+{
+	if (!DataLoad())
+	{
+		return false;
+	}
+	if (sCampaignLoaded)
+	{
+		return true;
+	}
+	char buf[CDOGS_PATH_MAX];
+	GetDataFilePath(buf, BENCH_CAMPAIGN);
+	CampaignEntry entry;
+	if (!CampaignEntryTryLoad(&entry, buf, GAME_MODE_NORMAL) ||
+		!CampaignLoad(&gCampaign, &entry))
+	{
+		fprintf(stderr, "Failed to load campaign %s\n", buf);
+		return false;
+	}
+	gCampaign.MissionIndex = 0;
+	MissionOptionsTerminate(&gMission);
+	CampaignAndMissionSetup(&gCampaign, &gMission);
+	sCampaignLoaded = true;
+	return true;
+}
+
+static void CampaignLoadRun(const int n)
+{
+	char buf[CDOGS_PATH_MAX];
+	GetDataFilePath(buf, BENCH_CAMPAIGN);
+	for (int i = 0; i < n; i++)
+	{
+		CampaignSetting c;
+		CampaignSettingInit(&c);
+		gBenchSink += MapNewLoad(buf, &c);
+		gBenchSink += (int)c.Missions.size;
+		CampaignSettingTerminate(&c);
+	}
+}
+
+static void MissionBuild(const Mission *m, const bool loadDynamic)
+{
+	MapBuild(
+		&gMap, m, loadDynamic, 0, gCampaign.Entry.Mode,
+		&gCampaign.Setting.characters);
+}
+
+// Copy the campaign's first mission, converted to a particular map type
+static bool MissionSetupType(const MapType type)
+{
+	if (!CampaignReady())
+	{
+		return false;
+	}
+	MissionCopy(&sMission, CampaignGetCurrentMission(&gCampaign));
+	sMissionInit = true;
+	if (type == MAPTYPE_STATIC)
+	{
+		// Static maps are saved from a generated map
+		MissionConvertToType(&sMission, &gMap, MAPTYPE_CLASSIC);
+		gMission.missionData = &sMission;
+		MissionBuild(&sMission, false);
+	}
+	MissionConvertToType(&sMission, &gMap, type);
+	gMission.missionData = &sMission;
+	return true;
+}
+static bool MapBuildClassicSetup(void)
+{
+	return MissionSetupType(MAPTYPE_CLASSIC);
+}
+static bool MapBuildCaveSetup(void)
+{
+	return MissionSetupType(MAPTYPE_CAVE);
+}
+static bool MapBuildInteriorSetup(void)
+{
+	return MissionSetupType(MAPTYPE_INTERIOR);
+}
+static bool MapBuildStaticSetup(void)
+{
+	return MissionSetupType(MAPTYPE_STATIC);
+}
+static void MapBuildRun(const int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		MissionBuild(&sMission, false);
+		gBenchSink += gMap.Size.x;
+	}
+}
+static void MapBuildTeardown(void)
+{
+	gMission.missionData = CampaignGetCurrentMission(&gCampaign);
+	MissionTerminate(&sMission);
+	sMissionInit = false;
+}
+
+// Build the campaign's first mission with all its objects, for the
+// pathfinding, LOS and collision benchmarks
+static bool MapLoadedSetup(void)
+{
+	if (!CampaignReady())
+	{
+		return false;
+	}
+	srand(0);
+	MissionBuild(gMission.missionData, true);
+	HandleGameEvents(&gGameEvents, NULL, NULL, NULL, NULL);
+	CArrayInit(&sWalkable, sizeof(struct vec2i));
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), gMap.Size))
+	if (TileCanWalk(MapGetTile(&gMap, _v)))
+	{
+		CArrayPushBack(&sWalkable, &_v);
+	}
+	RECT_FOREACH_END()
+	return sWalkable.size > 0;
+}
+static struct vec2i RandomWalkable(void)
+{
+	return *(const struct vec2i *)CArrayGet(
+		&sWalkable, rand() % sWalkable.size);
+}
+static void MapLoadedTeardown(void)
+{
+	CArrayTerminate(&sWalkable);
+}
+
+static void PathfindRun(const int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		CachedPath c = PathCacheCreate(
+			&gPathCache, RandomWalkable(), RandomWalkable(), false, false);
+		gBenchSink += (int)ASPathGetCount(c.Path);
+		CachedPathDestroy(&c);
+	}
+}
+
+static void LOSRun(const int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		LOSReset(&gMap.LOS);
+		LOSCalcFrom(&gMap, RandomWalkable(), false);
+	}
+}
+
+static bool CountOverlap(
+	Thing *ti, void *data, const struct vec2 colA, const struct vec2 colB,
+	const struct vec2 normal)
+{
+	UNUSED(ti);
+	UNUSED(colA);
+	UNUSED(colB);
+	UNUSED(normal);
+	(*(int *)data)++;
+	return true;
+}
+static void OverlapThingsRun(const int n)
+{
+	const CollisionParams params = {
+		THING_IMPASSABLE | THING_CAN_BE_SHOT, COLLISIONTEAM_NONE, false,
+		true};
+	for (int i = 0; i < n; i++)
+	{
+		int count = 0;
+		const struct vec2 pos = Vec2CenterOfTile(RandomWalkable());
+		const struct vec2 vel = svec2(
+			(float)(rand() % 9 - 4), (float)(rand() % 9 - 4));
+		OverlapThings(
+			NULL, pos, vel, svec2i(8, 8), params, CountOverlap, &count, NULL,
+			NULL, NULL);
+		gBenchSink += count;
+	}
+}
+
+static void Register(
+	CArray *benchmarks, const char *name, bool (*setup)(void),
+	void (*run)(const int), void (*teardown)(void))
+{
+	Benchmark b = {name, setup, run, teardown};
+	CArrayPushBack(benchmarks, &b);
+}
+void BenchMapRegister(CArray *benchmarks)
+{
+	Register(
+		benchmarks, "campaign_json_load", DataLoad, CampaignLoadRun, NULL);
+	Register(
+		benchmarks, "map_build_classic", MapBuildClassicSetup, MapBuildRun,
+		MapBuildTeardown);
+	Register(
+		benchmarks, "map_build_cave", MapBuildCaveSetup, MapBuildRun,
+		MapBuildTeardown);
+	Register(
+		benchmarks, "map_build_interior", MapBuildInteriorSetup, MapBuildRun,
+		MapBuildTeardown);
+	Register(
+		benchmarks, "map_build_static", MapBuildStaticSetup, MapBuildRun,
+		MapBuildTeardown);
+	Register(
+		benchmarks, "pathfind_astar", MapLoadedSetup, PathfindRun,
+		MapLoadedTeardown);
+	Register(
+		benchmarks, "los_calc_from", MapLoadedSetup, LOSRun,
+		MapLoadedTeardown);
+	Register(
+		benchmarks, "overlap_things", MapLoadedSetup, OverlapThingsRun,
+		MapLoadedTeardown);
+}
+
+void BenchMapTerminate(void)
+{
+	if (sDataState != DATA_LOADED)
+	{
+		return;
+	}
+	if (sMissionInit)
+	{
+		MissionTerminate(&sMission);
+	}
+	GameEventsTerminate(&gGameEvents);
+	PlayerDataTerminate(&gPlayerDatas);
+	MapObjectsTerminate(&gMapObjects);
+	PickupClassesTerminate(&gPickupClasses);
+	ParticleClassesTerminate(&gParticleClasses);
+	AmmoTerminate(&gAmmo);
+	WeaponClassesTerminate(&gWeaponClasses);
+	BulletTerminate(&gBulletClasses);
+	CharacterClassesTerminate(&gCharacterClasses);
+	MissionOptionsTerminate(&gMission);
+	MapTerminate(&gMap);
+	CampaignTerminate(&gCampaign);
+	CollisionSystemTerminate(&gCollisionSystem);
+	CharSpriteClassesTerminate(&gCharSpriteClasses);
+	PicManagerTerminate(&gPicManager);
+	FontTerminate(&gFont);
+	GraphicsTerminate(&gGraphicsDevice);
+	SoundTerminate(&gSoundDevice, true);
+	ConfigDestroy(&gConfig);
+}
@@ -0,0 +1,225 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "bench.h"
+
+#include <stdlib.h>
+
+#include <cdogs/animation.h>
+#include <cdogs/defs.h>
+#include <cdogs/net_snapshot.h>
+#include <cdogs/net_util.h>
+
+// Bandwidth of keeping clients in sync with moving actors, sent as per-change
+// events or as snapshot deltas. Each iteration is one game tick.
+// The client is a loopback stand-in that drops some snapshots and
+// acknowledges the rest one snapshot late.
+
+#define NET_BENCH_ACTORS 32
+// Chance (1 in n) per tick that an actor changes its command
+#define NET_BENCH_CMD_CHANGE 30
+// Chance (1 in n) that a snapshot is lost
+#define NET_BENCH_LOSS 20
+
+typedef struct
+{
+	struct vec2 Pos;
+	struct vec2 Vel;
+	direction_e Dir;
+	ActorAnimation State;
+	int Health;
+} BenchActor;
+static BenchActor sActors[NET_BENCH_ACTORS];
+
+static void SimReset(void)
+{
+	for (int i = 0; i < NET_BENCH_ACTORS; i++)
+	{
+		BenchActor *a = &sActors[i];
+		a->Pos = svec2((float)(rand() % 1000), (float)(rand() % 1000));
+		a->Vel = svec2_zero();
+		a->Dir = DIRECTION_DOWN;
+		a->State = ACTORANIMATION_STAND;
+		a->Health = 100;
+	}
+}
+// Returns whether the actor changed its command, as players and AI do
+static bool SimTick(BenchActor *a)
+{
+	bool changed = false;
+	if (rand() % NET_BENCH_CMD_CHANGE == 0)
+	{
+		changed = true;
+		if (rand() % 4 == 0)
+		{
+			a->Vel = svec2_zero();
+			a->State = ACTORANIMATION_STAND;
+		}
+		else
+		{
+			a->Dir = (direction_e)(rand() % DIRECTION_COUNT);
+			const struct vec2i d = Vec2iFromDirection(a->Dir);
+			a->Vel = svec2_scale(svec2_normalize(svec2_assign_vec2i(d)), 1.1f);
+			a->State = ACTORANIMATION_WALKING;
+		}
+	}
+	if (rand() % 500 == 0)
+	{
+		a->Health -= 10;
+	}
+	a->Pos = svec2_add(a->Pos, a->Vel);
+	return changed;
+}
+
+static void AddEventBytes(const GameEventType e, const void *data)
+{
+	ENetPacket *p = NetEncode(e, data);
+	gBenchBytes += p->dataLength + NET_BATCH_LEN_SIZE;
+	enet_packet_destroy(p);
+}
+static void EventsRun(const int n)
+{
+	SimReset();
+	for (int t = 0; t < n; t++)
+	{
+		for (int i = 0; i < NET_BENCH_ACTORS; i++)
+		{
+			BenchActor *a = &sActors[i];
+			const direction_e dir = a->Dir;
+			const ActorAnimation state = a->State;
+			if (!SimTick(a))
+			{
+				continue;
+			}
+			NActorMove am = NActorMove_init_default;
+			am.UID = i;
+			am.has_Pos = am.has_MoveVel = true;
+			am.Pos = Vec2ToNet(a->Pos);
+			am.MoveVel = Vec2ToNet(a->Vel);
+			AddEventBytes(GAME_EVENT_ACTOR_MOVE, &am);
+			if (a->Dir != dir)
+			{
+				NActorDir ad = NActorDir_init_default;
+				ad.UID = i;
+				ad.Dir = (int32_t)a->Dir;
+				AddEventBytes(GAME_EVENT_ACTOR_DIR, &ad);
+			}
+			if (a->State != state)
+			{
+				NActorState as = NActorState_init_default;
+				as.UID = i;
+				as.State = (int32_t)a->State;
+				AddEventBytes(GAME_EVENT_ACTOR_STATE, &as);
+			}
+		}
+	}
+}
+
+static NetSnapshotHistory sServer;
+static NetSnapshotHistory sClient;
+static CArray sBuf;
+static bool SnapshotSetup(void)
+{
+	NetSnapshotHistoryInit(&sServer);
+	NetSnapshotHistoryInit(&sClient);
+	CArrayInit(&sBuf, sizeof(uint8_t));
+	return true;
+}
+static void SnapshotTeardown(void);
+static void SnapshotRun(const int n)
+{
+	// Start each run from no baseline
+	SnapshotTeardown();
+	SnapshotSetup();
+	SimReset();
+	uint32_t seq = 0;
+	uint32_t ack = 0;
+	uint32_t pendingAck = 0;
+	for (int t = 1; t <= n; t++)
+	{
+		for (int i = 0; i < NET_BENCH_ACTORS; i++)
+		{
+			SimTick(&sActors[i]);
+		}
+		if (t % NET_SNAPSHOT_INTERVAL != 0)
+		{
+			continue;
+		}
+		seq++;
+		NetSnapshot *s = NetSnapshotHistoryNext(&sServer, seq);
+		s->Seq = seq;
+		s->Tick = (uint32_t)t;
+		for (int i = 0; i < NET_BENCH_ACTORS; i++)
+		{
+			const BenchActor *a = &sActors[i];
+			NetSnapshotEntity e =
+				NetSnapshotEntityNew(SNAPSHOT_ACTOR, i, a->Pos, a->Vel);
+			e.Dir = (int)a->Dir;
+			e.State = (int)a->State;
+			e.Health = a->Health;
+			NetSnapshotAdd(s, &e);
+		}
+		NetSnapshotWriteDelta(
+			&sBuf, NetSnapshotHistoryGet(&sServer, ack), s);
+		gBenchBytes += sBuf.size;
+
+		// Loopback client
+		ack = pendingAck;
+		if (rand() % NET_BENCH_LOSS == 0)
+		{
+			continue;
+		}
+		const NetSnapshot *r =
+			NetSnapshotHistoryRead(&sClient, sBuf.data, sBuf.size);
+		if (r != NULL)
+		{
+			pendingAck = r->Seq;
+			gBenchSink += (int)r->Entities.size;
+		}
+	}
+}
+static void SnapshotTeardown(void)
+{
+	NetSnapshotHistoryTerminate(&sServer);
+	NetSnapshotHistoryTerminate(&sClient);
+	CArrayTerminate(&sBuf);
+}
+
+static void Register(
+	CArray *benchmarks, const char *name, bool (*setup)(void),
+	void (*run)(const int), void (*teardown)(void))
+{
+	Benchmark b = {name, setup, run, teardown};
+	CArrayPushBack(benchmarks, &b);
+}
+void BenchNetRegister(CArray *benchmarks)
+{
+	Register(benchmarks, "net_bandwidth_events", NULL, EventsRun, NULL);
+	Register(
+		benchmarks, "net_bandwidth_snapshots", SnapshotSetup, SnapshotRun,
+		SnapshotTeardown);
+}
@@ -80,6 +80,7 @@
 #include <cdogs/pickup.h>
 #include <cdogs/pics.h>
 #include <cdogs/player_template.h>
+#include <cdogs/profiler.h>
 #include <cdogs/sounds.h>
 #include <cdogs/triggers.h>
 #include <cdogs/utils.h>
@@ -88,9 +89,11 @@
 #include "briefing_screens.h"
 #include "command_line.h"
 #include "credits.h"
+#include "headless.h"
 #include "loading_screens.h"
 #include "mainmenu.h"
 #include "prep.h"
+#include "replay.h"
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -140,7 +143,15 @@ int main(int argc, char *argv[])
 	ProcessCommandLine(buf, argc, argv);
 	LOG(LM_MAIN, LL_INFO, "Command line (%d args):%s", argc, buf);
     int demoQuitTimer = 0;
-	if (!ParseArgs(argc, argv, &connectAddr, &loadCampaign, &demoQuitTimer))
+	HeadlessOptions headless = HeadlessOptionsDefault();
+#ifdef CDOGS_DEDICATED_SERVER
+	HeadlessOptionsSetServer(&headless);
+#endif
+	ReplayInit(&gReplay);
+	ProfilerInit(&gProfiler);
+	if (!ParseArgs(
+			argc, argv, &connectAddr, &loadCampaign, &demoQuitTimer,
+			&headless))
 	{
 		goto bail;
 	}
@@ -151,13 +162,14 @@ int main(int argc, char *argv[])
 #else
 	const int sdlFlags = SDL_INIT_AUDIO | SDL_INIT_VIDEO;
 #endif
-	if (SDL_Init(sdlFlags) != 0)
+	// Headless: no video, audio or joysticks, only timers
+	if (SDL_Init(headless.Enabled ? SDL_INIT_TIMER : sdlFlags) != 0)
 	{
 		LOG(LM_MAIN, LL_ERROR, "Could not initialise SDL: %s", SDL_GetError());
 		err = EXIT_FAILURE;
 		goto bail;
 	}
-	if (SDLJBN_Init() != 0)
+	if (!headless.Enabled && SDLJBN_Init() != 0)
 	{
 		LOG(LM_MAIN, LL_ERROR, "Could not initialise SDLJBN: %s",
 			SDLJBN_GetError());
@@ -168,7 +180,14 @@ int main(int argc, char *argv[])
 
 	PicManagerInit(&gPicManager);
 	GraphicsInit(&gGraphicsDevice, &gConfig);
-	GraphicsInitialize(&gGraphicsDevice);
+	if (headless.Enabled)
+	{
+		GraphicsInitializeHeadless(&gGraphicsDevice);
+	}
+	else
+	{
+		GraphicsInitialize(&gGraphicsDevice);
+	}
 	if (!gGraphicsDevice.IsInitialized)
 	{
 		LOG(LM_MAIN, LL_WARN,
@@ -195,7 +214,10 @@ int main(int argc, char *argv[])
 	LoadingScreenDraw(&gLoadingScreen, "Loading autosaves...", 0.09f);
 	AutosaveInit(&gAutosave);
 #ifndef __EMSCRIPTEN__
-	AutosaveLoad(&gAutosave, GetConfigFilePath(AUTOSAVE_FILE));
+	if (!headless.Enabled)
+	{
+		AutosaveLoad(&gAutosave, GetConfigFilePath(AUTOSAVE_FILE));
+	}
 #endif
 
 	LoadingScreenDraw(&gLoadingScreen, "Initializing network client...", 0.18f);
@@ -210,8 +232,15 @@ int main(int argc, char *argv[])
 #endif
 
 	LoadingScreenDraw(&gLoadingScreen, "Initializing sound device...", 0.25f);
-	SoundInitialize(&gSoundDevice, "sounds");
-	if (!gSoundDevice.isInitialised)
+	if (headless.Enabled)
+	{
+		SoundInitializeNull(&gSoundDevice);
+	}
+	else
+	{
+		SoundInitialize(&gSoundDevice, "sounds");
+	}
+	if (!headless.Enabled && !gSoundDevice.isInitialised)
 	{
 		LOG(LM_MAIN, LL_ERROR, "Sound initialization failed!");
 	}
@@ -247,6 +276,12 @@ int main(int argc, char *argv[])
 	CampaignInit(&gCampaign);
 	PlayerDataInit(&gPlayerDatas);
 
+	if (headless.Enabled)
+	{
+		err = HeadlessRun(&headless, loadCampaign);
+		goto bail;
+	}
+
 	LoadingScreenDraw(&gLoadingScreen, "Loading main menu...", 1.0f);
 	LoopRunner l = LoopRunnerNew();
 	LoopRunnerPush(&l, MainMenu(&gGraphicsDevice, &l));
@@ -308,6 +343,7 @@ bail:
 	MissionOptionsTerminate(&gMission);
 	MapTerminate(&gMap);
 	NetClientTerminate(&gNetClient);
+	NetPacketPoolTerminate();
 	atexit(enet_deinitialize);
 	EventTerminate(&gEventHandlers);
 	CampaignTerminate(&gCampaign);
@@ -317,15 +353,23 @@ bail:
 	PicManagerTerminate(&gPicManager);
 	FontTerminate(&gFont);
 	GraphicsTerminate(&gGraphicsDevice);
-	AutosaveSave(&gAutosave, GetConfigFilePath(AUTOSAVE_FILE));
+	if (!headless.Enabled)
+	{
+		AutosaveSave(&gAutosave, GetConfigFilePath(AUTOSAVE_FILE));
+	}
 	AutosaveTerminate(&gAutosave);
 	PlayerTemplatesTerminate(&gPlayerTemplates);
+	ReplayTerminate(&gReplay);
+	ProfilerTerminate(&gProfiler);
 	SoundTerminate(&gSoundDevice, true);
 	ConfigDestroy(&gConfig);
 	LogTerminate();
 	LoadingScreenTerminate(&gLoadingScreen);
 
-	SDLJBN_Quit();
+	if (!headless.Enabled)
+	{
+		SDLJBN_Quit();
+	}
 	SDL_Quit();
 
 	return err;
@@ -56,13 +56,16 @@
 #include "draw/draw.h"
 #include "draw/draw_actor.h"
 #include "draw/drawtools.h"
+#include "draw/sprite_batch.h"
 #include "font.h"
 #include "gamedata.h"
+#include "log.h"
 #include "map.h"
 #include "mission.h"
 #include "objs.h"
 #include "pic_manager.h"
 #include "pickup.h"
+#include "texture.h"
 
 #define MAP_SCALE_DEFAULT 2
 #define MASK_ALPHA 128;
@@ -165,12 +168,6 @@ static void DisplaySummary(void)
 	CA_FOREACH_END()
 }
 
-static color_t DoorColor(const int x, const int y)
-{
-	const int l = MapGetDoorKeycardFlag(&gMap, svec2i(x, y));
-	return KeyColor(l);
-}
-
 void DrawDot(Thing *t, color_t color, struct vec2i pos, int scale)
 {
 	const struct vec2i dotPos = Vec2ToTile(t->Pos);
@@ -178,59 +175,159 @@ void DrawDot(Thing *t, color_t color, struct vec2i pos, int scale)
 	DrawRectangle(&gGraphicsDevice, pos, svec2i(scale, scale), color, false);
 }
 
+AutomapCache gAutomapCache;
+
+void AutomapCacheInit(AutomapCache *c)
+{
+	memset(c, 0, sizeof *c);
+	CArrayInit(&c->Texels, sizeof(Uint32));
+}
+void AutomapCacheTerminate(AutomapCache *c)
+{
+	AutomapCacheClear(c);
+	CArrayTerminate(&c->Texels);
+}
+
+void AutomapCacheClear(AutomapCache *c)
+{
+	SpriteBatchFlush(&gSpriteBatch);
+	if (c->Tex != NULL)
+	{
+		SDL_DestroyTexture(c->Tex);
+		c->Tex = NULL;
+	}
+	c->Renderer = NULL;
+	// Redo everything for the next texture
+	c->DirtyMin = svec2i_zero();
+	c->DirtyMax = svec2i_subtract(c->Size, svec2i_one());
+}
+
+void AutomapCacheReset(AutomapCache *c, const Map *map)
+{
+	if (!svec2i_is_equal(map->Size, c->Size))
+	{
+		AutomapCacheClear(c);
+		c->Size = map->Size;
+		CArrayResize(&c->Texels, c->Size.x * c->Size.y, NULL);
+	}
+	c->DirtyMin = svec2i_zero();
+	c->DirtyMax = svec2i_subtract(c->Size, svec2i_one());
+}
+
+void AutomapCacheMarkTileDirty(AutomapCache *c, const struct vec2i tile)
+{
+	if (tile.x < 0 || tile.y < 0 || tile.x >= c->Size.x ||
+		tile.y >= c->Size.y)
+	{
+		return;
+	}
+	c->DirtyMin = svec2i(MIN(c->DirtyMin.x, tile.x), MIN(c->DirtyMin.y, tile.y));
+	c->DirtyMax = svec2i(MAX(c->DirtyMax.x, tile.x), MAX(c->DirtyMax.y, tile.y));
+}
+
+static color_t TileColor(Map *map, const struct vec2i pos, const bool showAll)
+{
+	const Tile *tile = MapGetTile(map, pos);
+	if (tile->Class->Pic == NULL || !(tile->isVisited || showAll))
+	{
+		return colorTransparent;
+	}
+	switch (tile->Class->Type)
+	{
+	case TILE_CLASS_WALL:
+		return colorWall;
+	case TILE_CLASS_DOOR:
+		return KeyColor(MapGetDoorKeycardFlag(map, pos));
+	case TILE_CLASS_FLOOR:
+		return tile->Class->IsRoom ? colorRoom : colorFloor;
+	default:
+		CASSERT(false, "Unknown tile class type");
+		return colorTransparent;
+	}
+}
+
+static bool AutomapCacheUpdate(
+	AutomapCache *c, SDL_Renderer *r, Map *map, const bool showAll)
+{
+	if (r != c->Renderer)
+	{
+		AutomapCacheClear(c);
+		c->Renderer = r;
+	}
+	if (showAll != c->ShowAll)
+	{
+		c->ShowAll = showAll;
+		AutomapCacheReset(c, map);
+	}
+	if (c->Tex == NULL)
+	{
+		if (svec2i_is_zero(c->Size))
+		{
+			return false;
+		}
+		c->Tex = TextureCreate(
+			r, SDL_TEXTUREACCESS_STREAMING, c->Size, SDL_BLENDMODE_BLEND,
+			255);
+		if (c->Tex == NULL)
+		{
+			return false;
+		}
+#if SDL_VERSION_ATLEAST(2, 0, 12)
+		if (SDL_SetTextureScaleMode(c->Tex, SDL_ScaleModeNearest) != 0)
+		{
+			LOG(LM_GFX, LL_WARN, "cannot set automap scale mode: %s",
+				SDL_GetError());
+		}
+#endif
+	}
+	if (c->DirtyMin.x > c->DirtyMax.x || c->DirtyMin.y > c->DirtyMax.y)
+	{
+		return true;
+	}
+
+	const Rect2i dirty = Rect2iNew(
+		c->DirtyMin,
+		svec2i_add(svec2i_subtract(c->DirtyMax, c->DirtyMin), svec2i_one()));
+	RECT_FOREACH(dirty)
+	*(Uint32 *)CArrayGet(&c->Texels, _v.x + _v.y * c->Size.x) =
+		COLOR2PIXEL(TileColor(map, _v, showAll));
+	RECT_FOREACH_END()
+	// The texture may still be queued from an earlier draw
+	SpriteBatchFlush(&gSpriteBatch);
+	const SDL_Rect rect = {
+		dirty.Pos.x, dirty.Pos.y, dirty.Size.x, dirty.Size.y};
+	if (SDL_UpdateTexture(
+			c->Tex, &rect,
+			CArrayGet(&c->Texels, dirty.Pos.x + dirty.Pos.y * c->Size.x),
+			c->Size.x * sizeof(Uint32)) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot update automap texture: %s",
+			SDL_GetError());
+	}
+	c->DirtyMin = c->Size;
+	c->DirtyMax = svec2i(-1, -1);
+	return true;
+}
+
 static void DrawMap(
 	Map *map, struct vec2i center, struct vec2i centerOn, struct vec2i size,
 	int scale, int flags)
 {
-	int x, y;
-	struct vec2i mapPos =
+	const struct vec2i mapPos =
 		svec2i_add(center, svec2i_scale(centerOn, (float)-scale));
-	for (y = 0; y < gMap.Size.y; y++)
+	SDL_Renderer *r = gGraphicsDevice.gameWindow.renderer;
+	if (AutomapCacheUpdate(
+			&gAutomapCache, r, map, !!(flags & AUTOMAP_FLAGS_SHOWALL)))
 	{
-		int i;
-		for (i = 0; i < scale; i++)
+		color_t mask = colorWhite;
+		if (flags & AUTOMAP_FLAGS_MASK)
 		{
-			for (x = 0; x < gMap.Size.x; x++)
-			{
-				Tile *tile = MapGetTile(map, svec2i(x, y));
-				if (tile->Class->Pic != NULL &&
-					(tile->isVisited || (flags & AUTOMAP_FLAGS_SHOWALL)))
-				{
-					int j;
-					for (j = 0; j < scale; j++)
-					{
-						struct vec2i drawPos = svec2i(
-							mapPos.x + x * scale + j,
-							mapPos.y + y * scale + i);
-						color_t color = colorTransparent;
-						switch (tile->Class->Type)
-						{
-						case TILE_CLASS_WALL:
-							color = colorWall;
-							break;
-						case TILE_CLASS_DOOR:
-							color = DoorColor(x, y);
-							break;
-						case TILE_CLASS_FLOOR:
-							color =
-								tile->Class->IsRoom ? colorRoom : colorFloor;
-							break;
-						default:
-							CASSERT(false, "Unknown tile class type");
-							break;
-						}
-						if (!ColorEquals(color, colorTransparent))
-						{
-							if (flags & AUTOMAP_FLAGS_MASK)
-							{
-								color.a = MASK_ALPHA;
-							}
-							DrawPoint(drawPos, color);
-						}
-					}
-				}
-			}
+			mask.a = MASK_ALPHA;
 		}
+		TextureRender(
+			gAutomapCache.Tex, r, Rect2iNew(svec2i_zero(), gAutomapCache.Size),
+			Rect2iNew(mapPos, svec2i_scale(gAutomapCache.Size, (float)scale)),
+			mask, 0, SDL_FLIP_NONE);
 	}
 	if (flags & AUTOMAP_FLAGS_MASK)
 	{
@@ -34,6 +34,32 @@
 #define AUTOMAP_FLAGS_SHOWALL 0x01
 #define AUTOMAP_FLAGS_MASK 0x02
 
+// The automap's tiles are drawn from a texture with one texel per map tile.
+// Only tiles that are explored or changed are redone and uploaded, so
+// drawing the map costs one scaled quad regardless of its size.
+typedef struct
+{
+	SDL_Renderer *Renderer;
+	SDL_Texture *Tex;
+	struct vec2i Size; // in tiles
+	CArray Texels;	   // of Uint32
+	bool ShowAll;
+	// Tiles to redo since the last upload
+	struct vec2i DirtyMin;
+	struct vec2i DirtyMax;
+} AutomapCache;
+
+extern AutomapCache gAutomapCache;
+
+void AutomapCacheInit(AutomapCache *c);
+void AutomapCacheTerminate(AutomapCache *c);
+// Free the texture; done before the renderer is destroyed
+void AutomapCacheClear(AutomapCache *c);
+// Size the cache for a new map and redo all its tiles
+void AutomapCacheReset(AutomapCache *c, const Map *map);
+// Redo a tile that has been explored or changed
+void AutomapCacheMarkTileDirty(AutomapCache *c, const struct vec2i tile);
+
 void AutomapDraw(
 	GraphicsDevice *g, SDL_Renderer *renderer, const int flags,
 	const bool showExit);
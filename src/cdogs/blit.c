@@ -36,6 +36,7 @@
 #include <SDL.h>
 
 #include "config.h"
+#include "draw/sprite_batch.h"
 #include "log.h"
 
 color_t *CharColorGetByType(CharColors *c, const CharColorType t)
@@ -183,6 +184,21 @@ void CharColorsGetMaskedName(char *buf, const char *base, const CharColors *c)
 		buf, "%s/%s/%s/%s/%s/%s/%s/%s/%s/%s", base, bufSkin, bufArms, bufBody, bufLegs,
 		bufHair, bufFeet, bufFacehair, bufHat, bufGlasses);
 }
+uint64_t CharColorsHash(uint64_t h, const CharColors *c)
+{
+	const color_t colors[] = {
+		c->Skin, c->Arms,	  c->Body, c->Legs,	  c->Hair,
+		c->Feet, c->Facehair, c->Hat,  c->Glasses};
+	return Hash64(h, colors, sizeof colors);
+}
+bool CharColorsEqual(const CharColors *a, const CharColors *b)
+{
+	return ColorEquals(a->Skin, b->Skin) && ColorEquals(a->Arms, b->Arms) &&
+		   ColorEquals(a->Body, b->Body) && ColorEquals(a->Legs, b->Legs) &&
+		   ColorEquals(a->Hair, b->Hair) && ColorEquals(a->Feet, b->Feet) &&
+		   ColorEquals(a->Facehair, b->Facehair) &&
+		   ColorEquals(a->Hat, b->Hat) && ColorEquals(a->Glasses, b->Glasses);
+}
 
 void BlitClearBuf(GraphicsDevice *g)
 {
@@ -197,6 +213,12 @@ void BlitFillBuf(GraphicsDevice *g, const color_t c)
 }
 void BlitUpdateFromBuf(GraphicsDevice *g, SDL_Texture *t)
 {
+	if (g->IsHeadless)
+	{
+		return;
+	}
+	// The texture may still be drawn by queued sprites
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_UpdateTexture(
 			t, NULL, g->buf, g->cachedConfig.Res.x * sizeof(Uint32)) != 0)
 	{
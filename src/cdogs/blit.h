@@ -69,6 +69,9 @@ CharColorType CharColorTypeFromColor(const color_t c, const CharColorType headPa
 CharColors CharColorsFromOneColor(const color_t color);
 color_t CharColorsGetChannelMask(const CharColors *c, const uint8_t alpha);
 void CharColorsGetMaskedName(char *buf, const char *base, const CharColors *c);
+// Numeric alternative to the masked name, for hashing into cache keys
+uint64_t CharColorsHash(uint64_t h, const CharColors *c);
+bool CharColorsEqual(const CharColors *a, const CharColors *b);
 
 #define BLIT_BRIGHTNESS_MIN (-10)
 #define BLIT_BRIGHTNESS_MAX 10
@@ -119,6 +119,7 @@ static struct vec2 GetFollowPlayerPos(
 	const struct vec2 lastPos, const PlayerData *p);
 void CameraUpdate(Camera *camera, const int ticks, const int ms)
 {
+	camera->prevPosition = camera->lastPosition;
 	camera->HUD.DrawData = HUDGetDrawData();
 	if (camera->HUD.DrawData.NumScreens == 0)
 	{
@@ -286,12 +287,15 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData)
 
 	const struct vec2 noise = camera->shake.Delta;
 
+	const struct vec2 drawPos =
+		DrawPosInterpolate(camera->prevPosition, camera->lastPosition);
+
 	GraphicsResetClip(gGraphicsDevice.gameWindow.renderer);
 	if (drawData.NumScreens == 0)
 	{
 		DoBuffer(
 			&camera->Buffer,
-			camera->lastPosition,
+			drawPos,
 			X_TILES, noise, centerOffset);
 	}
 	else
@@ -321,7 +325,7 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData)
 
 			DoBuffer(
 				&camera->Buffer,
-				camera->lastPosition,
+				drawPos,
 				X_TILES, noise, centerOffset);
 		}
 		else if (drawData.NumScreens == 2)
@@ -339,7 +343,7 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData)
 				{
 					continue;
 				}
-				camera->lastPosition = a->thing.Pos;
+				camera->lastPosition = ThingDrawPos(&a->thing);
 				struct vec2i centerOffsetPlayer = centerOffset;
 				const Rect2i clip = Rect2iNew(
 					svec2i((i & 1) ? w / 2 : 0, 0), svec2i(w / 2, h));
@@ -373,7 +377,7 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData)
 				{
 					continue;
 				}
-				camera->lastPosition = a->thing.Pos;
+				camera->lastPosition = ThingDrawPos(&a->thing);
 				struct vec2i centerOffsetPlayer = centerOffset;
 				const Rect2i clip = Rect2iNew(
 					svec2i((i & 1) ? w / 2 : 0, (i < 2) ? 0 : h / 2 - 1),
@@ -43,6 +43,8 @@ typedef struct
 {
 	DrawBuffer Buffer;
 	struct vec2 lastPosition;
+	// Position at the previous update, for interpolated drawing
+	struct vec2 prevPosition;
 	HUD HUD;
 	ScreenShake shake;
 	SpectateMode spectateMode;
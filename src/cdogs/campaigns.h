@@ -75,6 +75,9 @@ typedef struct
 	CampaignSetting Setting;
 	CampaignEntry Entry;
 	int MissionIndex;
+	// Seed used to generate quick play campaigns; set before loading to
+	// regenerate a specific campaign, otherwise a random one is chosen
+	unsigned int QuickPlaySeed;
 	bool IsLoaded;
 	// TODO: it may be possible to completely remove IsClient and rely on
 	// protocol definitions
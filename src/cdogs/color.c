@@ -31,6 +31,14 @@
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLOR_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define COLOR_NEON
+#include <arm_neon.h>
+#endif
 
 #include "utils.h"
 
@@ -94,6 +102,56 @@ color_t ColorMult(color_t c, color_t m)
 	c.a = (uint8_t)((int)c.a * m.a / 255);
 	return c;
 }
+// The SIMD paths divide the 16-bit products t by 255, rounding down like
+// ColorMult, as (t + 1 + (t >> 8)) >> 8, which is exact for t <= 255 * 255
+void ColorMultPixels(
+	uint32_t *dst, const uint32_t *src, const uint32_t *masks, const size_t n)
+{
+	size_t i = 0;
+#if defined(COLOR_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	for (; i + 4 <= n; i += 4)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i m = _mm_loadu_si128((const __m128i *)(masks + i));
+		__m128i lo = _mm_mullo_epi16(
+			_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(m, zero));
+		__m128i hi = _mm_mullo_epi16(
+			_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(m, zero));
+		lo = _mm_srli_epi16(
+			_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(
+			_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)), 8);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#elif defined(COLOR_NEON)
+	const uint16x8_t one = vdupq_n_u16(1);
+	for (; i + 4 <= n; i += 4)
+	{
+		const uint8x16_t s = vreinterpretq_u8_u32(vld1q_u32(src + i));
+		const uint8x16_t m = vreinterpretq_u8_u32(vld1q_u32(masks + i));
+		uint16x8_t lo = vmull_u8(vget_low_u8(s), vget_low_u8(m));
+		uint16x8_t hi = vmull_u8(vget_high_u8(s), vget_high_u8(m));
+		lo = vshrq_n_u16(vaddq_u16(vaddq_u16(lo, one), vshrq_n_u16(lo, 8)), 8);
+		hi = vshrq_n_u16(vaddq_u16(vaddq_u16(hi, one), vshrq_n_u16(hi, 8)), 8);
+		vst1q_u32(
+			dst + i, vreinterpretq_u32_u8(
+						 vcombine_u8(vmovn_u16(lo), vmovn_u16(hi))));
+	}
+#endif
+	for (; i < n; i++)
+	{
+		uint32_t p = 0;
+		for (int shift = 0; shift < 32; shift += 8)
+		{
+			const uint32_t t =
+				((src[i] >> shift) & 0xff) * ((masks[i] >> shift) & 0xff);
+			p |= (t / 255) << shift;
+		}
+		dst[i] = p;
+	}
+}
 color_t ColorAlphaBlend(color_t a, color_t b)
 {
 	a.r = (uint8_t)(((int)a.r * (255 - b.a) + (int)b.r * b.a) / 255);
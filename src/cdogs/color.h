@@ -31,6 +31,7 @@
 #include "sys_specifics.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 typedef struct
@@ -93,6 +94,10 @@ extern color_t colorLightBlue;
 extern color_t colorSelectedBG;
 
 color_t ColorMult(color_t c, color_t m);
+// Multiply n pixels by n mask pixels, the same as ColorMult on each of their
+// 8-bit channels; dst may be src
+void ColorMultPixels(
+	uint32_t *dst, const uint32_t *src, const uint32_t *masks, const size_t n);
 color_t ColorAlphaBlend(color_t a, color_t b);
 
 typedef struct
@@ -645,6 +645,7 @@ Config ConfigDefault(void)
 		"Gore", GORE_LOW, GORE_NONE, GORE_HIGH, StrGoreAmount, GoreAmountStr));
 	ConfigGroupAdd(&gfx, ConfigNewBool("Brass", true));
 	ConfigGroupAdd(&gfx, ConfigNewBool("SecondWindow", false));
+	ConfigGroupAdd(&gfx, ConfigNewBool("FrameInterpolation", false));
 	ConfigGroupAdd(&root, gfx);
 
 	Config input = ConfigNewGroup("Input");
@@ -680,6 +681,8 @@ Config ConfigDefault(void)
 	Config itf = ConfigNewGroup("Interface");
 	ConfigGroupAdd(&itf, ConfigNewBool("ShowFPS", false));
 	ConfigGroupAdd(&itf, ConfigNewBool("ShowTime", false));
+	ConfigGroupAdd(&itf, ConfigNewBool("ShowProfiler", false));
+	ConfigGroupAdd(&itf, ConfigNewBool("ShowNetStats", false));
 	ConfigGroupAdd(&itf, ConfigNewBool("ShowHUDMap", true));
 	ConfigGroupAdd(&itf, ConfigNewEnum(
 		"AIChatter", AICHATTER_SELDOM, AICHATTER_NONE, AICHATTER_ALWAYS,
@@ -59,6 +59,8 @@
 #include "draw/draw.h"
 #include "draw/draw_actor.h"
 #include "draw/drawtools.h"
+#include "draw/floor_cache.h"
+#include "draw/fog_mask.h"
 #include "font.h"
 #include "game_events.h"
 #include "net_util.h"
@@ -66,6 +68,7 @@
 #include "pic_manager.h"
 #include "pickup.h"
 #include "pics.h"
+#include "profiler.h"
 #include "texture.h"
 
 // #define DEBUG_DRAW_HITBOXES
@@ -122,179 +125,238 @@ static void DrawLOSPic(
 static void DrawThing(
 	DrawBuffer *b, const Thing *t, const struct vec2i offset);
 
-static void DrawTiles(
-	DrawBuffer *b, const struct vec2i offset,
-	void (*drawTileFunc)(
-		DrawBuffer *, const struct vec2i, const Tile *, const struct vec2i,
-		const bool))
+// Build the draw commands for every layer in one pass over the tiles
+static void AddTileCmds(
+	DrawBuffer *b, const Tile *t, const int row, const struct vec2i pos,
+	const bool hud, const bool floor);
+static void AddDrawCmds(
+	DrawBuffer *b, const struct vec2i offset, const bool hud,
+	const bool floor)
 {
-	const bool useFog = ConfigGetBool(&gConfig, "Game.Fog");
+	CArrayClear(&b->drawCmds);
 	const Tile **tile = DrawBufferGetFirstTile(b);
 	struct vec2i pos;
 	int x, y;
 	for (y = 0, pos.y = b->dy + offset.y; y < Y_TILES;
 		 y++, pos.y += TILE_HEIGHT)
 	{
-		CArrayClear(&b->displaylist);
 		for (x = 0, pos.x = b->dx + offset.x; x < b->Size.x;
 			 x++, tile++, pos.x += TILE_WIDTH)
 		{
 			if (*tile == NULL)
 				continue;
-			drawTileFunc(b, offset, *tile, pos, useFog);
+			AddTileCmds(b, *tile, y, pos, hud, floor);
 		}
-		DrawBufferSortDisplayList(b);
-		CA_FOREACH(const Thing *, tp, b->displaylist)
-		DrawThing(b, *tp, offset);
-		CA_FOREACH_END()
 		tile += X_TILES - b->Size.x;
 	}
+	DrawBufferSortCmds(b);
 }
+static bool HasObjectiveHighlight(const Thing *ti);
+static void AddTileCmds(
+	DrawBuffer *b, const Tile *t, const int row, const struct vec2i pos,
+	const bool hud, const bool floor)
+{
+	// Floor tiles (which do not obstruct anything), unless drawn from the
+	// floor cache, and walls; within their rows, these are drawn before things
+	if (floor && t->Class != NULL && t->Class->Pic != NULL &&
+		t->Class->Pic->Data != NULL && t->Class->Type != TILE_CLASS_WALL)
+	{
+		DrawBufferAddCmd(b, DRAW_LAYER_FLOOR, row, 0, t, NULL, pos);
+	}
+	if (t->Class->Type == TILE_CLASS_WALL || t->Class->Type == TILE_CLASS_DOOR)
+	{
+		DrawBufferAddCmd(b, DRAW_LAYER_WALLS, row, 0, t, NULL, pos);
+	}
 
-static void DrawFloor(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawThingsBelow(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawWallsAndThings(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawThingsAbove(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawObjectiveHighlights(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawChatters(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawPickupMenus(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
+	const float rowY = (float)((b->yStart + row) * TILE_HEIGHT);
+	CA_FOREACH(ThingId, tid, t->things)
+	const Thing *ti = ThingIdGetThing(tid);
+	if (hud)
+	{
+		if (HasObjectiveHighlight(ti))
+		{
+			DrawBufferAddCmd(b, DRAW_LAYER_OBJECTIVES, row, 0, t, ti, pos);
+		}
+		if (ti->kind == KIND_CHARACTER)
+		{
+			DrawBufferAddCmd(b, DRAW_LAYER_CHATTERS, row, 0, t, ti, pos);
+			DrawBufferAddCmd(b, DRAW_LAYER_PICKUP_MENUS, row, 0, t, ti, pos);
+		}
+	}
+	// Draw the items that are in LOS, in order of y
+	if (t->outOfSight)
+	{
+		continue;
+	}
+	DrawLayer layer = DRAW_LAYER_WALLS;
+	if (ThingDrawBelow(ti))
+	{
+		layer = DRAW_LAYER_BELOW;
+	}
+	else if (ThingDrawAbove(ti))
+	{
+		layer = DRAW_LAYER_ABOVE;
+	}
+	// Sub-pixel y within the row; things go after the row's tiles
+	const float dy = MAX(ti->Pos.y - rowY, 0.0f);
+	DrawBufferAddCmd(
+		b, layer, row, 1 + (uint32_t)(dy * 256), t, ti, pos);
+	CA_FOREACH_END()
+}
+
+static bool DrawFloorCache(
+	DrawBuffer *b, const struct vec2i offset, const bool useFog);
+static void DrawFloor(const DrawCmd *c, const bool useFog);
+static void DrawWall(const DrawCmd *c, const bool useFog);
+static void DrawObjectiveHighlight(
+	DrawBuffer *b, const struct vec2i offset, const DrawCmd *c);
+static void DrawChatter(
+	DrawBuffer *b, const struct vec2i offset, const DrawCmd *c,
+	const bool useFog);
+static void DrawPickupMenuCmd(
+	DrawBuffer *b, const struct vec2i offset, const DrawCmd *c,
+	const bool useFog);
 static void DrawExtra(
 	DrawBuffer *b, struct vec2i offset, const DrawBufferArgs *args);
 
+static const ProfilePhase layerProfiles[DRAW_LAYER_COUNT] = {
+	PROFILE_DRAW_FLOOR, PROFILE_DRAW_BELOW, PROFILE_DRAW_WALLS,
+	PROFILE_DRAW_ABOVE, PROFILE_DRAW_HUD,	PROFILE_DRAW_HUD,
+	PROFILE_DRAW_HUD};
 void DrawBufferDraw(
 	DrawBuffer *b, struct vec2i offset, const DrawBufferArgs *args)
 {
-	// First draw the floor tiles (which do not obstruct anything)
-	DrawTiles(b, offset, DrawFloor);
-	// Then draw things that are below everything like debris (wrecks)
-	DrawTiles(b, offset, DrawThingsBelow);
-	// Now draw walls and (non-wreck) things in proper order
-	DrawTiles(b, offset, DrawWallsAndThings);
-	// Draw things that are above everything
-	DrawTiles(b, offset, DrawThingsAbove);
-	if (args->HUD)
-	{
-		// Draw objective highlights, for visible and always-visible objectives
-		DrawTiles(b, offset, DrawObjectiveHighlights);
-		// Draw actor chatter
-		DrawTiles(b, offset, DrawChatters);
-		// Draw actor pickup menus
-		DrawTiles(b, offset, DrawPickupMenus);
+	const bool useFog = ConfigGetBool(&gConfig, "Game.Fog");
+	Uint64 t = ProfilerBegin();
+	const bool floorCached = DrawFloorCache(b, offset, useFog);
+	ProfilerEnd(PROFILE_DRAW_FLOOR, t);
+	AddDrawCmds(b, offset, args->HUD, !floorCached);
+
+	// Draw in layer order: floor, things below everything like debris
+	// (wrecks), walls and things, things above everything, then the HUD
+	// layers of objective highlights, actor chatter and pickup menus
+	DrawLayer layer = DRAW_LAYER_COUNT;
+	CA_FOREACH(const DrawCmd, c, b->drawCmds)
+	const DrawLayer cLayer = DRAW_CMD_LAYER(c->Key);
+	if (cLayer != layer)
+	{
+		if (layer != DRAW_LAYER_COUNT)
+		{
+			ProfilerEnd(layerProfiles[layer], t);
+		}
+		layer = cLayer;
+		t = ProfilerBegin();
+	}
+	switch (layer)
+	{
+	case DRAW_LAYER_FLOOR:
+		DrawFloor(c, useFog);
+		break;
+	case DRAW_LAYER_WALLS:
+		if (c->Thing == NULL)
+		{
+			DrawWall(c, useFog);
+			break;
+		}
+		DrawThing(b, c->Thing, offset);
+		break;
+	case DRAW_LAYER_BELOW:
+	case DRAW_LAYER_ABOVE: // fallthrough
+		DrawThing(b, c->Thing, offset);
+		break;
+	case DRAW_LAYER_OBJECTIVES:
+		DrawObjectiveHighlight(b, offset, c);
+		break;
+	case DRAW_LAYER_CHATTERS:
+		DrawChatter(b, offset, c, useFog);
+		break;
+	case DRAW_LAYER_PICKUP_MENUS:
+		DrawPickupMenuCmd(b, offset, c, useFog);
+		break;
+	default:
+		CASSERT(false, "unknown draw layer");
+		break;
 	}
+	CA_FOREACH_END()
+	if (layer != DRAW_LAYER_COUNT)
+	{
+		ProfilerEnd(layerProfiles[layer], t);
+	}
+
 	// Draw editor-only things
+	t = ProfilerBegin();
 	DrawExtra(b, offset, args);
+	ProfilerEnd(PROFILE_DRAW_EXTRA, t);
 }
 
-static void DrawFloor(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static bool DrawFloorCache(
+	DrawBuffer *b, const struct vec2i offset, const bool useFog)
 {
-	UNUSED(b);
-	UNUSED(offset);
-	if (t->Class != NULL && t->Class->Pic != NULL &&
-		t->Class->Pic->Data != NULL && t->Class->Type != TILE_CLASS_WALL)
+	SDL_Renderer *r = gGraphicsDevice.gameWindow.renderer;
+	const Rect2i tiles =
+		Rect2iNew(svec2i(b->xStart, b->yStart), svec2i(b->Size.x, Y_TILES));
+	const struct vec2i pos = svec2i(b->dx + offset.x, b->dy + offset.y);
+	if (!FogMaskSetMap(&gFogMask, r, b->map) ||
+		!FloorCacheDraw(&gFloorCache, r, b->map, tiles, pos))
+	{
+		return false;
+	}
+
+	// Line of sight goes on top of the cached floor as the fog mask, by
+	// TileLOS: clear in sight, darkened as much as the fog color when out of
+	// sight, and black when unvisited
+	const color_t fog = {0, 0, 0, (Uint8)(255 - colorFog.r)};
+	const Uint32 texels[] = {
+		COLOR2PIXEL(colorTransparent), COLOR2PIXEL(fog),
+		COLOR2PIXEL(colorBlack)};
+	const Tile **tile = DrawBufferGetFirstTile(b);
+	struct vec2i v;
+	for (v.y = b->yStart; v.y < b->yStart + Y_TILES; v.y++)
 	{
-		DrawLOSPic(t, t->Class->Pic, pos, useFog);
+		for (v.x = b->xStart; v.x < b->xStart + b->Size.x; v.x++, tile++)
+		{
+			if (*tile == NULL)
+				continue;
+			FogMaskSetTile(&gFogMask, v, texels[GetTileLOS(*tile, useFog)]);
+		}
+		tile += X_TILES - b->Size.x;
 	}
+	FogMaskDraw(&gFogMask, r, tiles, pos);
+	return true;
 }
-
-static void DrawThingsBelow(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static void DrawFloor(const DrawCmd *c, const bool useFog)
 {
-	UNUSED(pos);
-	UNUSED(offset);
-	UNUSED(useFog);
-	if (t->outOfSight)
-	{
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ThingDrawBelow(ti))
-	{
-		CArrayPushBack(&b->displaylist, &ti);
-	}
-	CA_FOREACH_END()
+	DrawLOSPic(c->Tile, c->Tile->Class->Pic, c->Pos, useFog);
 }
 
-static void DrawWallsAndThings(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static void DrawWall(const DrawCmd *c, const bool useFog)
 {
-	UNUSED(offset);
+	const Tile *t = c->Tile;
 	if (t->Class->Type == TILE_CLASS_WALL)
 	{
 		DrawLOSPic(
-			t, t->Class->Pic, svec2i_add(pos, svec2i(0, WALL_OFFSET_Y)),
+			t, t->Class->Pic, svec2i_add(c->Pos, svec2i(0, WALL_OFFSET_Y)),
 			useFog);
 	}
-	else if (t->Class->Type == TILE_CLASS_DOOR)
+	else
 	{
 		const color_t mask = GetLOSMask(t, useFog);
 		if (!ColorEquals(mask, colorTransparent))
 		{
-			DoorDraw(&t->Door, pos, mask);
+			DoorDraw(&t->Door, c->Pos, mask);
 		}
 	}
-
-	// Draw the items that are in LOS
-	if (t->outOfSight)
-	{
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ThingDrawBelow(ti) || ThingDrawAbove(ti))
-	{
-		continue;
-	}
-	CArrayPushBack(&b->displaylist, &ti);
-	CA_FOREACH_END()
 }
 
-static void DrawThingsAbove(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static bool HasObjectiveHighlight(const Thing *ti)
 {
-	UNUSED(offset);
-	UNUSED(pos);
-	UNUSED(useFog);
-	if (t->outOfSight)
-	{
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ThingDrawAbove(ti))
-	{
-		CArrayPushBack(&b->displaylist, &ti);
-	}
-	CA_FOREACH_END()
+	return (ti->flags & THING_OBJECTIVE) || ti->kind == KIND_PICKUP;
 }
-
-static void DrawObjectiveHighlights(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static void DrawObjectiveHighlight(
+	DrawBuffer *b, const struct vec2i offset, const DrawCmd *c)
 {
-	UNUSED(pos);
-	UNUSED(useFog);
-	CA_FOREACH(ThingId, tid, t->things)
-	Thing *ti = ThingIdGetThing(tid);
+	const Tile *t = c->Tile;
+	const Thing *ti = c->Thing;
 	const Pic *pic = NULL;
 	color_t color = colorWhite;
 	struct vec2i drawOffsetExtra = svec2i_zero();
@@ -307,11 +369,11 @@ static void DrawObjectiveHighlights(
 			CArrayGet(&gMission.missionData->Objectives, objective);
 		if (o->Flags & OBJECTIVE_HIDDEN)
 		{
-			continue;
+			return;
 		}
 		if (!(o->Flags & OBJECTIVE_POSKNOWN) && t->outOfSight)
 		{
-			continue;
+			return;
 		}
 		switch (o->Type)
 		{
@@ -325,7 +387,7 @@ static void DrawObjectiveHighlights(
 			break;
 		default:
 			CASSERT(false, "unexpected objective to draw");
-			continue;
+			return;
 		}
 		color = o->color;
 		if (ti->kind == KIND_CHARACTER)
@@ -338,13 +400,13 @@ static void DrawObjectiveHighlights(
 		// Require LOS for non-deathmatch modes
 		if (!IsPVP(gCampaign.Entry.Mode) && t->outOfSight)
 		{
-			continue;
+			return;
 		}
 		// Gun pickup or keycard
 		const Pickup *p = CArrayGet(&gPickups, ti->id);
 		if (!PickupClassHasKeyEffect(p->class) && !PickupIsManual(p))
 		{
-			continue;
+			return;
 		}
 		pic = CPicGetPic(&p->thing.CPic, 0);
 		color = colorDarker;
@@ -354,7 +416,8 @@ static void DrawObjectiveHighlights(
 	if (pic != NULL)
 	{
 		const struct vec2i picPos = svec2i_add(
-			svec2i_subtract(svec2i_floor(ti->Pos), svec2i(b->xTop, b->yTop)),
+			svec2i_subtract(
+				svec2i_floor(ThingDrawPos(ti)), svec2i(b->xTop, b->yTop)),
 			offset);
 		color.a = (Uint8)Pulse256(gMission.time);
 		// Centre the drawing
@@ -364,73 +427,54 @@ static void DrawObjectiveHighlights(
 			svec2i_add(picPos, svec2i_add(drawOffset, drawOffsetExtra)), color,
 			0, svec2_one(), SDL_FLIP_NONE, Rect2iZero());
 	}
-	CA_FOREACH_END()
 }
 
 #define ACTOR_HEIGHT 25
-static void DrawChatters(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static void DrawChatter(
+	DrawBuffer *b, const struct vec2i offset, const DrawCmd *c,
+	const bool useFog)
 {
-	UNUSED(pos);
-	UNUSED(useFog);
-	CA_FOREACH(ThingId, tid, t->things)
 	// Draw the items that are in LOS
-	if (t->outOfSight)
+	if (c->Tile->outOfSight)
 	{
-		continue;
-	}
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ti->kind != KIND_CHARACTER)
-	{
-		continue;
+		return;
 	}
-
-	const TActor *a = CArrayGet(&gActors, ti->id);
+	const TActor *a = CArrayGet(&gActors, c->Thing->id);
 	// Draw character text
 	if (strlen(a->Chatter) > 0)
 	{
+		const struct vec2 drawPos = ThingDrawPos(&a->thing);
 		const struct vec2i textPos = svec2i(
-			(int)a->thing.Pos.x - b->xTop + offset.x -
-				FontStrW(a->Chatter) / 2,
-			(int)a->thing.Pos.y - b->yTop + offset.y - ACTOR_HEIGHT);
-		const color_t mask = GetLOSMask(t, useFog);
+			(int)drawPos.x - b->xTop + offset.x - FontStrW(a->Chatter) / 2,
+			(int)drawPos.y - b->yTop + offset.y - ACTOR_HEIGHT);
+		const color_t mask = GetLOSMask(c->Tile, useFog);
 		if (!ColorEquals(mask, colorTransparent))
 		{
 			FontStrMask(a->Chatter, textPos, mask);
 		}
 	}
-	CA_FOREACH_END()
 }
 
 static void DrawPickupMenu(
 	DrawBuffer *b, const TActor *a, const struct vec2i offset);
-static void DrawPickupMenus(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static void DrawPickupMenuCmd(
+	DrawBuffer *b, const struct vec2i offset, const DrawCmd *c,
+	const bool useFog)
 {
-	UNUSED(pos);
-	CA_FOREACH(ThingId, tid, t->things)
 	// Draw the items that are in LOS
-	if (t->outOfSight || ColorEquals(GetLOSMask(t, useFog), colorTransparent))
-	{
-		continue;
-	}
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ti->kind != KIND_CHARACTER)
+	if (c->Tile->outOfSight ||
+		ColorEquals(GetLOSMask(c->Tile, useFog), colorTransparent))
 	{
-		continue;
+		return;
 	}
-
-	const TActor *a = CArrayGet(&gActors, ti->id);
+	const TActor *a = CArrayGet(&gActors, c->Thing->id);
 	// Draw pickup menu
 	if (!a->pickupMenu.pickup || !ActorIsLocalPlayer(a->uid))
 	{
-		continue;
+		return;
 	}
 
 	DrawPickupMenu(b, a, offset);
-	CA_FOREACH_END()
 }
 static void DrawPickupMenu(
 	DrawBuffer *b, const TActor *a, const struct vec2i offset)
@@ -448,9 +492,10 @@ static void DrawPickupMenu(
 	size.y += ssize.y;
 	CA_FOREACH_END()
 
+	const struct vec2 drawPos = ThingDrawPos(&a->thing);
 	struct vec2i pos = svec2i(
-		(int)a->thing.Pos.x - b->xTop + offset.x - size.x / 2,
-		(int)a->thing.Pos.y - b->yTop + offset.y - size.y / 2);
+		(int)drawPos.x - b->xTop + offset.x - size.x / 2,
+		(int)drawPos.y - b->yTop + offset.y - size.y / 2);
 	const int startX = pos.x;
 	// Draw box bg with a bit of padding
 	const color_t cbg = {64, 64, 64, 128};
@@ -480,7 +525,7 @@ static void DrawThing(DrawBuffer *b, const Thing *t, const struct vec2i offset)
 {
 	const struct vec2i picPos = svec2i_add(
 		svec2i_subtract(
-			svec2i_floor(svec2_add(t->Pos, t->drawShake)),
+			svec2i_floor(svec2_add(ThingDrawPos(t), t->drawShake)),
 			svec2i(b->xTop, b->yTop)),
 		offset);
 
@@ -688,7 +733,8 @@ static void DrawGuideImage(
 	color_t mask = colorWhite;
 	mask.a = alpha;
 	TextureRender(
-		guideImage->Tex, gGraphicsDevice.gameWindow.renderer, Rect2iZero(),
+		guideImage->Tex, gGraphicsDevice.gameWindow.renderer,
+		PicTexSrc(guideImage, Rect2iZero()),
 		Rect2iNew(
 			pos, svec2i(
 					 (mint_t)MROUND(guideImage->size.x * xScale),
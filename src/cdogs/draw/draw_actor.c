@@ -226,16 +226,25 @@ ActorPics GetCharacterPics(
 
 	return pics;
 }
+static const Pic *GetHeadPicCached(
+	const CharacterClass *c, const direction_e dir, const bool isGrimacing,
+	const CharColors *colors, const uint64_t colorsKey);
+static const Pic *GetHeadPartPicCached(
+	const char *name, const HeadPart hp, const direction_e dir,
+	const bool isGrimacing, const CharColors *colors,
+	const uint64_t colorsKey);
 static const Pic *GetBodyPic(
 	PicManager *pm, const CharSprites *cs, const direction_e dir,
 	const ActorAnimation anim, const int frame, const int numBarrels,
-	const int grips, const gunstate_e barrelState, const CharColors *colors);
+	const int grips, const gunstate_e barrelState, const CharColors *colors,
+	const uint64_t colorsKey);
 static const Pic *GetLegsPic(
 	PicManager *pm, const CharSprites *cs, const direction_e dir,
-	const ActorAnimation anim, const int frame, const CharColors *colors);
+	const ActorAnimation anim, const int frame, const CharColors *colors,
+	const uint64_t colorsKey);
 static const Pic *GetGunPic(
 	PicManager *pm, const char *gunSprites, const direction_e dir,
-	const int gunState, const CharColors *colors);
+	const int gunState, const CharColors *colors, const uint64_t colorsKey);
 static ActorPics GetUnorderedPics(
 	const Character *c, const direction_e dir, const direction_e legDir,
 	const ActorAnimation anim, const int frame, const WeaponClass *gun,
@@ -287,6 +296,8 @@ static ActorPics GetUnorderedPics(
 	{
 		colors = &c->Colors;
 	}
+	// Hash the colors once for all the sprite lookups
+	const uint64_t colorsKey = CharColorsHash(HASH64_INIT, colors);
 
 	// Head
 	direction_e headDir = dir;
@@ -313,7 +324,8 @@ static ActorPics GetUnorderedPics(
 		}
 	}
 	const int grips = gun == NULL ? 0 : WC_BARREL_ATTR(*gun, Grips, 0);
-	pics.Head = GetHeadPic(c->Class, headDir, grimace, colors);
+	pics.Head =
+		GetHeadPicCached(c->Class, headDir, grimace, colors, colorsKey);
 	pics.HeadOffset = GetActorDrawOffset(
 		pics.Head, BODY_PART_HEAD, c->Class->Sprites, anim, frame, dir,
 		GUNSTATE_READY);
@@ -322,8 +334,8 @@ static ActorPics GetUnorderedPics(
 	{
 		if (c->Class->HasHeadParts[hp])
 		{
-			pics.HeadParts[hp] =
-				GetHeadPartPic(c->HeadParts[hp], hp, headDir, grimace, colors);
+			pics.HeadParts[hp] = GetHeadPartPicCached(
+				c->HeadParts[hp], hp, headDir, grimace, colors, colorsKey);
 			pics.HeadPartOffsets[hp] = GetActorDrawOffset(
 				pics.HeadParts[hp], BODY_PART_HEAD, c->Class->Sprites, anim,
 				frame, dir, GUNSTATE_READY);
@@ -335,7 +347,7 @@ static ActorPics GetUnorderedPics(
 	{
 		pics.Guns[i] = GetGunPic(
 			&gPicManager, WC_BARREL_ATTR(*gun, Sprites, i), dir,
-			barrelStates[i], colors);
+			barrelStates[i], colors, colorsKey);
 		if (pics.Guns[i] != NULL)
 		{
 			pics.GunOffsets[i] = GetActorDrawOffset(
@@ -354,19 +366,46 @@ static ActorPics GetUnorderedPics(
 	// Body
 	pics.Body = GetBodyPic(
 		&gPicManager, c->Class->Sprites, dir, anim, frame, numBarrels, grips,
-		barrelStates[0], colors);
+		barrelStates[0], colors, colorsKey);
 	pics.BodyOffset = GetActorDrawOffset(
 		pics.Body, BODY_PART_BODY, c->Class->Sprites, anim, frame, dir,
 		GUNSTATE_READY);
 
 	// Legs
 	pics.Legs = GetLegsPic(
-		&gPicManager, c->Class->Sprites, legDir, anim, frame, colors);
+		&gPicManager, c->Class->Sprites, legDir, anim, frame, colors,
+		colorsKey);
 	pics.LegsOffset = GetActorDrawOffset(
 		pics.Legs, BODY_PART_LEGS, c->Class->Sprites, anim, frame, legDir,
 		GUNSTATE_READY);
 	return pics;
 }
+void PreloadCharacterPics(const Character *c, const WeaponClass *gun)
+{
+	if (c->Class == NULL)
+	{
+		return;
+	}
+	// Each sprite sheet has all the directions and frames, so just get one
+	// pic per animation and gun pose
+	const ActorAnimation anims[] = {
+		ACTORANIMATION_IDLE, ACTORANIMATION_WALKING};
+	const gunstate_e states[] = {GUNSTATE_READY, GUNSTATE_FIRING};
+	for (int i = 0; i < 2; i++)
+	{
+		for (int j = 0; j < 2; j++)
+		{
+			gunstate_e barrelStates[MAX_BARRELS];
+			for (int k = 0; k < MAX_BARRELS; k++)
+			{
+				barrelStates[k] = states[j];
+			}
+			GetUnorderedPics(
+				c, DIRECTION_UP, DIRECTION_UP, anims[i], 0, gun, barrelStates,
+				false, colorTransparent, NULL, NULL, 0);
+		}
+	}
+}
 static direction_e GetLegDirAndFrame(
 	const TActor *a, const direction_e bodyDir, int *frame)
 {
@@ -546,9 +585,48 @@ static void DrawLaserSightSingle(
 	DrawLine(from, to, color);
 }
 
+// Masked character sprites are cached by a key of the kind of sprites,
+// their name and colors, so that drawing actors doesn't format any names
+typedef enum
+{
+	UPPER_POSE_NONE,
+	UPPER_POSE_HANDGUN,
+	UPPER_POSE_DUALGUN,
+	UPPER_POSE_RIFLE,
+	UPPER_POSE_RIFLEFIRE,
+	UPPER_POSE_COUNT
+} UpperPose;
+static const char *upperPoseNames[UPPER_POSE_COUNT] = {
+	"", "_handgun", "_dualgun", "_rifle", "_riflefire"};
+typedef enum
+{
+	CHAR_SHEET_HEAD,
+	CHAR_SHEET_HEAD_PART, // + HeadPart
+	CHAR_SHEET_UPPER =
+		CHAR_SHEET_HEAD_PART + HEAD_PART_COUNT, // + run * poses + UpperPose
+	CHAR_SHEET_LEGS = CHAR_SHEET_UPPER + 2 * UPPER_POSE_COUNT, // + run
+	CHAR_SHEET_GUN = CHAR_SHEET_LEGS + 2
+} CharSheet;
+static CharSpritesKey MakeCharSpritesKey(
+	const uint64_t colorsKey, const int sheet, const char *name,
+	const CharColors *colors)
+{
+	const CharSpritesKey key = {
+		Hash64Str(Hash64(colorsKey, &sheet, sizeof sheet), name), sheet, name,
+		colors};
+	return key;
+}
+
 const Pic *GetHeadPic(
 	const CharacterClass *c, const direction_e dir, const bool isGrimacing,
 	const CharColors *colors)
+{
+	return GetHeadPicCached(
+		c, dir, isGrimacing, colors, CharColorsHash(HASH64_INIT, colors));
+}
+static const Pic *GetHeadPicCached(
+	const CharacterClass *c, const direction_e dir, const bool isGrimacing,
+	const CharColors *colors, const uint64_t colorsKey)
 {
 	if (strlen(c->HeadSprites) == 0)
 	{
@@ -558,13 +636,27 @@ const Pic *GetHeadPic(
 	const int row = isGrimacing ? 1 : 0;
 	const int idx = (int)dir + row * 8;
 	// Get or generate masked sprites
-	const NamedSprites *ns =
-		PicManagerGetCharSprites(&gPicManager, c->HeadSprites, colors);
+	const CharSpritesKey key = MakeCharSpritesKey(
+		colorsKey, CHAR_SHEET_HEAD, c->HeadSprites, colors);
+	const NamedSprites *ns;
+	if (!PicManagerFindCharSprites(&gPicManager, &key, &ns))
+	{
+		ns = PicManagerAddCharSprites(&gPicManager, &key, c->HeadSprites);
+	}
 	return CArrayGet(&ns->pics, idx);
 }
 const Pic *GetHeadPartPic(
 	const char *name, const HeadPart hp, const direction_e dir,
 	const bool isGrimacing, const CharColors *colors)
+{
+	return GetHeadPartPicCached(
+		name, hp, dir, isGrimacing, colors,
+		CharColorsHash(HASH64_INIT, colors));
+}
+static const Pic *GetHeadPartPicCached(
+	const char *name, const HeadPart hp, const direction_e dir,
+	const bool isGrimacing, const CharColors *colors,
+	const uint64_t colorsKey)
 {
 	if (name == NULL)
 	{
@@ -573,54 +665,68 @@ const Pic *GetHeadPartPic(
 	const int row = isGrimacing ? 1 : 0;
 	const int idx = (int)dir + row * 8;
 	// Get or generate masked sprites
-	char buf[CDOGS_PATH_MAX];
-	const char *subpaths[] = {"hairs", "facehairs", "hats", "glasses"};
-	sprintf(buf, "chars/%s/%s", subpaths[hp], name);
-	const NamedSprites *ns =
-		PicManagerGetCharSprites(&gPicManager, buf, colors);
+	const CharSpritesKey key = MakeCharSpritesKey(
+		colorsKey, CHAR_SHEET_HEAD_PART + (int)hp, name, colors);
+	const NamedSprites *ns;
+	if (!PicManagerFindCharSprites(&gPicManager, &key, &ns))
+	{
+		char buf[CDOGS_PATH_MAX];
+		const char *subpaths[] = {"hairs", "facehairs", "hats", "glasses"};
+		sprintf(buf, "chars/%s/%s", subpaths[hp], name);
+		ns = PicManagerAddCharSprites(&gPicManager, &key, buf);
+	}
 	return CArrayGet(&ns->pics, idx);
 }
 static const Pic *GetBodyPic(
 	PicManager *pm, const CharSprites *cs, const direction_e dir,
 	const ActorAnimation anim, const int frame, const int numBarrels,
-	const int grips, const gunstate_e barrelState, const CharColors *colors)
+	const int grips, const gunstate_e barrelState, const CharColors *colors,
+	const uint64_t colorsKey)
 {
-	const int stride = anim == ACTORANIMATION_WALKING ? 8 : 1;
+	const bool isRun = anim == ACTORANIMATION_WALKING;
+	const int stride = isRun ? 8 : 1;
 	const int col = frame % stride;
 	const int row = (int)dir;
 	const int idx = col + row * stride;
-	char buf[CDOGS_PATH_MAX];
 	CASSERT(numBarrels <= 2, "up to 2 barrels supported");
 	const NamedSprites *ns = NULL;
-	const char *upperPose = "";
+	UpperPose pose = UPPER_POSE_NONE;
 	if (numBarrels == 1)
 	{
-		upperPose = "_handgun";
+		pose = UPPER_POSE_HANDGUN;
 	}
 	if (numBarrels == 2)
 	{
-		upperPose = "_dualgun";
+		pose = UPPER_POSE_DUALGUN;
 	}
 	if (grips == 2)
 	{
-		upperPose = "_rifle";
+		pose = UPPER_POSE_RIFLE;
 		if (barrelState == GUNSTATE_FIRING || barrelState == GUNSTATE_RECOIL)
 		{
-			upperPose = "_riflefire";
+			pose = UPPER_POSE_RIFLEFIRE;
 		}
 	}
 	for (;;)
 	{
-		sprintf(
-			buf, "chars/bodies/%s/upper_%s%s", cs->Name,
-			anim == ACTORANIMATION_WALKING ? "run" : "idle",
-			upperPose); // TODO: other gun holding poses
 		// Get or generate masked sprites
-		ns = PicManagerGetCharSprites(pm, buf, colors);
+		const CharSpritesKey key = MakeCharSpritesKey(
+			colorsKey,
+			CHAR_SHEET_UPPER + (isRun ? UPPER_POSE_COUNT : 0) + (int)pose,
+			cs->Name, colors);
+		if (!PicManagerFindCharSprites(pm, &key, &ns))
+		{
+			char buf[CDOGS_PATH_MAX];
+			sprintf(
+				buf, "chars/bodies/%s/upper_%s%s", cs->Name,
+				isRun ? "run" : "idle",
+				upperPoseNames[pose]); // TODO: other gun holding poses
+			ns = PicManagerAddCharSprites(pm, &key, buf);
+		}
 		// TODO: provide dualgun sprites for all body types
-		if (ns == NULL && strcmp(upperPose, "_handgun") != 0)
+		if (ns == NULL && pose != UPPER_POSE_HANDGUN)
 		{
-			upperPose = "_handgun";
+			pose = UPPER_POSE_HANDGUN;
 			continue;
 		}
 		break;
@@ -629,27 +735,40 @@ static const Pic *GetBodyPic(
 }
 static const Pic *GetLegsPic(
 	PicManager *pm, const CharSprites *cs, const direction_e dir,
-	const ActorAnimation anim, const int frame, const CharColors *colors)
+	const ActorAnimation anim, const int frame, const CharColors *colors,
+	const uint64_t colorsKey)
 {
-	const int stride = anim == ACTORANIMATION_WALKING ? 8 : 1;
+	const bool isRun = anim == ACTORANIMATION_WALKING;
+	const int stride = isRun ? 8 : 1;
 	const int col = frame % stride;
 	const int row = (int)dir;
 	const int idx = col + row * stride;
-	char buf[CDOGS_PATH_MAX];
-	sprintf(
-		buf, "chars/bodies/%s/legs_%s", cs->Name,
-		anim == ACTORANIMATION_WALKING ? "run" : "idle");
 	// Get or generate masked sprites
-	const NamedSprites *ns = PicManagerGetCharSprites(pm, buf, colors);
+	const CharSpritesKey key = MakeCharSpritesKey(
+		colorsKey, CHAR_SHEET_LEGS + (isRun ? 1 : 0), cs->Name, colors);
+	const NamedSprites *ns;
+	if (!PicManagerFindCharSprites(pm, &key, &ns))
+	{
+		char buf[CDOGS_PATH_MAX];
+		sprintf(
+			buf, "chars/bodies/%s/legs_%s", cs->Name, isRun ? "run" : "idle");
+		ns = PicManagerAddCharSprites(pm, &key, buf);
+	}
 	return CArrayGet(&ns->pics, idx);
 }
 static const Pic *GetGunPic(
 	PicManager *pm, const char *gunSprites, const direction_e dir,
-	const int gunState, const CharColors *colors)
+	const int gunState, const CharColors *colors, const uint64_t colorsKey)
 {
 	const int idx = (gunState == GUNSTATE_READY ? 8 : 0) + dir;
 	// Get or generate masked sprites
-	const NamedSprites *ns = PicManagerGetCharSprites(pm, gunSprites, colors);
+	const CharSpritesKey key =
+		MakeCharSpritesKey(colorsKey, CHAR_SHEET_GUN, gunSprites, colors);
+	const NamedSprites *ns;
+	if (!PicManagerFindCharSprites(pm, &key, &ns))
+	{
+		ns = PicManagerAddCharSprites(pm, &key, gunSprites);
+	}
 	if (ns == NULL)
 	{
 		return NULL;
@@ -49,10 +49,10 @@
 #include "draw/draw_buffer.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include "algorithms.h"
 #include "log.h"
-#include "los.h"
 
 
 void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g)
@@ -60,19 +60,22 @@ void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g)
 	b->OrigSize = size;
 	CArrayInitFillZero(&b->tiles, sizeof(Tile *), size.x * size.y);
 	b->g = g;
-	CArrayInit(&b->displaylist, sizeof(const Thing *));
-	CArrayReserve(&b->displaylist, 32);
+	CArrayInit(&b->drawCmds, sizeof(DrawCmd));
+	CArrayReserve(&b->drawCmds, 256);
+	CArrayInit(&b->drawCmdsTmp, sizeof(DrawCmd));
 }
 void DrawBufferTerminate(DrawBuffer *b)
 {
 	CArrayTerminate(&b->tiles);
-	CArrayTerminate(&b->displaylist);
+	CArrayTerminate(&b->drawCmds);
+	CArrayTerminate(&b->drawCmdsTmp);
 }
 
 void DrawBufferSetFromMap(
 	DrawBuffer *buffer, const Map *map, const struct vec2 origin,
 	const int width)
 {
+	buffer->map = map;
 	buffer->Size = svec2i(width, buffer->OrigSize.y);
 
 	buffer->xTop = (int)origin.x - TILE_WIDTH * width / 2;
@@ -118,43 +121,73 @@ void DrawBufferSetFromMap(
 // Set visibility and draw order for wall/door columns
 void DrawBufferFix(DrawBuffer *buffer)
 {
-	int tileIdx = 0;
+	// Buffered tiles are all in the map, so read line of sight directly
+	const bool *los = gMap.LOS.LOS.data;
+	Tile **tile = CArrayGet(&buffer->tiles, 0);
 	for (int y = 0; y < Y_TILES; y++)
 	{
-		for (int x = 0; x < buffer->Size.x; x++, tileIdx++)
+		for (int x = 0; x < buffer->Size.x; x++, tile++)
 		{
-			Tile **tile = CArrayGet(&buffer->tiles, tileIdx);
 			if (*tile == NULL) continue;
-			const struct vec2i mapTile =
-				svec2i(x + buffer->xStart, y + buffer->yStart);
-			(*tile)->outOfSight = !LOSTileIsVisible(&gMap, mapTile);
+			(*tile)->outOfSight =
+				!los[(y + buffer->yStart) * gMap.Size.x + x + buffer->xStart];
 		}
-		tileIdx += X_TILES - buffer->Size.x;
+		tile += X_TILES - buffer->Size.x;
 	}
 }
 
-static int CompareY(const void *v1, const void *v2);
-void DrawBufferSortDisplayList(DrawBuffer *buffer)
+void DrawBufferAddCmd(
+	DrawBuffer *b, const DrawLayer layer, const int row, const uint32_t sub,
+	const Tile *t, const Thing *ti, const struct vec2i pos)
 {
-	qsort(
-		buffer->displaylist.data,
-		buffer->displaylist.size,
-		buffer->displaylist.elemSize,
-		CompareY);
+	DrawCmd c;
+	c.Key = ((uint32_t)layer << DRAW_CMD_LAYER_SHIFT) |
+			((uint32_t)row << DRAW_CMD_ROW_SHIFT) | MIN(sub, DRAW_CMD_SUB_MAX);
+	c.Tile = t;
+	c.Thing = ti;
+	c.Pos = pos;
+	CArrayPushBack(&b->drawCmds, &c);
 }
-static int CompareY(const void *v1, const void *v2)
+
+void DrawBufferSortCmds(DrawBuffer *b)
 {
-	const Thing * const *t1 = v1;
-	const Thing * const *t2 = v2;
-	if ((*t1)->Pos.y < (*t2)->Pos.y)
+	// LSD radix sort a byte at a time; each pass is a stable counting sort
+	const size_t n = b->drawCmds.size;
+	if (n < 2)
 	{
-		return -1;
+		return;
 	}
-	else if ((*t1)->Pos.y > (*t2)->Pos.y)
+	CArrayResize(&b->drawCmdsTmp, n, NULL);
+	for (int shift = 0; shift < 32; shift += 8)
 	{
-		return 1;
+		const DrawCmd *src = b->drawCmds.data;
+		size_t offsets[256];
+		memset(offsets, 0, sizeof offsets);
+		for (size_t i = 0; i < n; i++)
+		{
+			offsets[(src[i].Key >> shift) & 0xFF]++;
+		}
+		// Skip bytes that are the same for all commands
+		if (offsets[(src[0].Key >> shift) & 0xFF] == n)
+		{
+			continue;
+		}
+		size_t total = 0;
+		for (int i = 0; i < 256; i++)
+		{
+			const size_t count = offsets[i];
+			offsets[i] = total;
+			total += count;
+		}
+		DrawCmd *dst = b->drawCmdsTmp.data;
+		for (size_t i = 0; i < n; i++)
+		{
+			dst[offsets[(src[i].Key >> shift) & 0xFF]++] = src[i];
+		}
+		const CArray tmp = b->drawCmds;
+		b->drawCmds = b->drawCmdsTmp;
+		b->drawCmdsTmp = tmp;
 	}
-	return 0;
 }
 
 const Tile **DrawBufferGetFirstTile(const DrawBuffer *b)
@@ -50,6 +50,33 @@
 
 #include "map.h"
 
+// Things in the buffer are drawn layer by layer; within a layer, row by row,
+// and within a row, tiles first then things in order of y
+typedef enum
+{
+	DRAW_LAYER_FLOOR,
+	DRAW_LAYER_BELOW,
+	DRAW_LAYER_WALLS,
+	DRAW_LAYER_ABOVE,
+	DRAW_LAYER_OBJECTIVES,
+	DRAW_LAYER_CHATTERS,
+	DRAW_LAYER_PICKUP_MENUS,
+	DRAW_LAYER_COUNT
+} DrawLayer;
+typedef struct
+{
+	// Sort key of layer, row and y within the row
+	uint32_t Key;
+	const Tile *Tile;
+	// NULL for tile draws
+	const Thing *Thing;
+	struct vec2i Pos;
+} DrawCmd;
+#define DRAW_CMD_LAYER_SHIFT 29
+#define DRAW_CMD_ROW_SHIFT 20
+#define DRAW_CMD_SUB_MAX ((1u << DRAW_CMD_ROW_SHIFT) - 1)
+#define DRAW_CMD_LAYER(_key) ((DrawLayer)((_key) >> DRAW_CMD_LAYER_SHIFT))
+
 typedef struct
 {
 	GraphicsDevice *g;
@@ -59,7 +86,9 @@ typedef struct
 	struct vec2i OrigSize;
 	struct vec2i Size;	// size in tiles
 	CArray tiles;	// of Tile *
-	CArray displaylist;	// of const Thing *, to determine draw order
+	CArray drawCmds;	// of DrawCmd, built and sorted each draw
+	CArray drawCmdsTmp;	// of DrawCmd, scratch space for sorting
+	const Map *map;
 } DrawBuffer;
 
 void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g);
@@ -69,5 +98,9 @@ void DrawBufferSetFromMap(
 	DrawBuffer *buffer, const Map *map, const struct vec2 origin,
 	const int width);
 void DrawBufferFix(DrawBuffer *buffer);
-void DrawBufferSortDisplayList(DrawBuffer *buffer);
+void DrawBufferAddCmd(
+	DrawBuffer *b, const DrawLayer layer, const int row, const uint32_t sub,
+	const Tile *t, const Thing *ti, const struct vec2i pos);
+// Stable sort of the draw commands by key
+void DrawBufferSortCmds(DrawBuffer *b);
 const Tile **DrawBufferGetFirstTile(const DrawBuffer *b);
@@ -50,6 +50,7 @@
 #include "algorithms.h"
 #include "config.h"
 #include "draw/drawtools.h"
+#include "draw/sprite_batch.h"
 #include "log.h"
 #include "palette.h"
 #include "pic_manager.h"
@@ -61,6 +62,7 @@
 
 void DrawPoint(const struct vec2i pos, const color_t c)
 {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderDrawBlendMode(
 		gGraphicsDevice.gameWindow.renderer, SDL_BLENDMODE_BLEND) != 0)
 	{
@@ -167,6 +169,7 @@ void DrawRectangle(
 	GraphicsDevice *g, const struct vec2i pos, const struct vec2i size,
 	const color_t color, const bool filled)
 {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderDrawBlendMode(
 		g->gameWindow.renderer, SDL_BLENDMODE_BLEND) != 0)
 	{
@@ -192,6 +195,7 @@ void DrawRectangle(
 
 void DrawCross(GraphicsDevice *g, const struct vec2i pos, const color_t c)
 {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderDrawBlendMode(
 		g->gameWindow.renderer, SDL_BLENDMODE_BLEND) != 0)
 	{
@@ -0,0 +1,290 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "floor_cache.h"
+
+#include <string.h>
+
+#include "draw/sprite_batch.h"
+#include "grafx.h"
+#include "log.h"
+#include "pic.h"
+#include "texture.h"
+#include "utils.h"
+
+FloorCache gFloorCache;
+
+
+void FloorCacheInit(FloorCache *c)
+{
+	memset(c, 0, sizeof *c);
+	CArrayInit(&c->Chunks, sizeof(FloorChunk));
+}
+void FloorCacheTerminate(FloorCache *c)
+{
+	FloorCacheClear(c);
+	CArrayTerminate(&c->Chunks);
+}
+
+void FloorCacheClear(FloorCache *c)
+{
+	SpriteBatchFlush(&gSpriteBatch);
+	CA_FOREACH(FloorChunk, ch, c->Chunks)
+	if (ch->Tex != NULL)
+	{
+		SDL_DestroyTexture(ch->Tex);
+		ch->Tex = NULL;
+	}
+	ch->Dirty = true;
+	CA_FOREACH_END()
+	c->Renderer = NULL;
+}
+
+void FloorCacheReset(FloorCache *c, const Map *map)
+{
+	c->Map = map;
+	CA_FOREACH(FloorChunk, ch, c->Chunks)
+	ch->Dirty = true;
+	CA_FOREACH_END()
+}
+void FloorCacheMarkTileDirty(
+	FloorCache *c, const Map *map, const struct vec2i tile)
+{
+	if (map != c->Map || !MapIsTileIn(map, tile))
+	{
+		return;
+	}
+	const struct vec2i chunk =
+		svec2i_scale_divide(tile, FLOOR_CACHE_CHUNK_TILES);
+	// Chunks are only allocated once drawn
+	if (chunk.x >= c->Size.x || chunk.y >= c->Size.y)
+	{
+		return;
+	}
+	FloorChunk *ch = CArrayGet(&c->Chunks, chunk.x + chunk.y * c->Size.x);
+	ch->Dirty = true;
+}
+
+static bool SetRenderer(FloorCache *c, SDL_Renderer *r);
+static void ResizeChunks(FloorCache *c, const Map *map);
+static void RenderChunk(
+	FloorCache *c, SDL_Renderer *r, FloorChunk *ch, const struct vec2i chunk);
+static void DrawChunk(
+	const FloorChunk *ch, SDL_Renderer *r, const struct vec2i chunk,
+	const Rect2i tiles, const struct vec2i pos);
+bool FloorCacheDraw(
+	FloorCache *c, SDL_Renderer *r, const Map *map, const Rect2i tiles,
+	const struct vec2i pos)
+{
+	if (!SetRenderer(c, r))
+	{
+		return false;
+	}
+	if (map != c->Map)
+	{
+		FloorCacheReset(c, map);
+	}
+	ResizeChunks(c, map);
+
+	// Chunks that overlap the tiles, clamped to the map
+	const struct vec2i tStart =
+		svec2i(MAX(tiles.Pos.x, 0), MAX(tiles.Pos.y, 0));
+	const struct vec2i tEnd = svec2i(
+		MIN(tiles.Pos.x + tiles.Size.x, map->Size.x),
+		MIN(tiles.Pos.y + tiles.Size.y, map->Size.y));
+	if (tStart.x >= tEnd.x || tStart.y >= tEnd.y)
+	{
+		return true;
+	}
+	const Rect2i chunks = Rect2iNew(
+		svec2i_scale_divide(tStart, FLOOR_CACHE_CHUNK_TILES),
+		svec2i(
+			(tEnd.x - 1) / FLOOR_CACHE_CHUNK_TILES -
+				tStart.x / FLOOR_CACHE_CHUNK_TILES + 1,
+			(tEnd.y - 1) / FLOOR_CACHE_CHUNK_TILES -
+				tStart.y / FLOOR_CACHE_CHUNK_TILES + 1));
+
+	// Redraw dirty chunks first, as this switches render targets
+	bool hasDirty = false;
+	RECT_FOREACH(chunks)
+	const FloorChunk *ch = CArrayGet(&c->Chunks, _v.x + _v.y * c->Size.x);
+	hasDirty = hasDirty || ch->Dirty || ch->Tex == NULL;
+	RECT_FOREACH_END()
+	if (hasDirty)
+	{
+		SpriteBatchFlush(&gSpriteBatch);
+		SDL_Texture *target = SDL_GetRenderTarget(r);
+		const Rect2i clip = GraphicsGetClip(r);
+		RECT_FOREACH(chunks)
+		FloorChunk *ch = CArrayGet(&c->Chunks, _v.x + _v.y * c->Size.x);
+		if (ch->Dirty || ch->Tex == NULL)
+		{
+			RenderChunk(c, r, ch, _v);
+		}
+		RECT_FOREACH_END()
+		if (SDL_SetRenderTarget(r, target) != 0)
+		{
+			LOG(LM_GFX, LL_ERROR, "cannot set render target: %s",
+				SDL_GetError());
+		}
+		GraphicsSetClip(r, clip);
+	}
+
+	RECT_FOREACH(chunks)
+	const FloorChunk *ch = CArrayGet(&c->Chunks, _v.x + _v.y * c->Size.x);
+	DrawChunk(ch, r, _v, tiles, pos);
+	RECT_FOREACH_END()
+	return true;
+}
+static bool SetRenderer(FloorCache *c, SDL_Renderer *r)
+{
+	if (r == c->Renderer)
+	{
+		return c->Supported;
+	}
+	FloorCacheClear(c);
+	c->Renderer = r;
+	SDL_RendererInfo ri;
+	if (SDL_GetRendererInfo(r, &ri) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot get renderer info: %s", SDL_GetError());
+		c->Supported = false;
+	}
+	else
+	{
+		c->Supported = !!(ri.flags & SDL_RENDERER_TARGETTEXTURE);
+	}
+	if (!c->Supported)
+	{
+		LOG(LM_GFX, LL_WARN,
+			"renderer does not support render to texture; "
+			"floor tiles will not be cached");
+	}
+	return c->Supported;
+}
+static void ResizeChunks(FloorCache *c, const Map *map)
+{
+	const struct vec2i size = svec2i(
+		(map->Size.x + FLOOR_CACHE_CHUNK_TILES - 1) / FLOOR_CACHE_CHUNK_TILES,
+		(map->Size.y + FLOOR_CACHE_CHUNK_TILES - 1) /
+			FLOOR_CACHE_CHUNK_TILES);
+	if (svec2i_is_equal(size, c->Size))
+	{
+		return;
+	}
+	SDL_Renderer *r = c->Renderer;
+	FloorCacheClear(c);
+	c->Renderer = r;
+	c->Size = size;
+	const FloorChunk empty = {NULL, true};
+	CArrayResize(&c->Chunks, size.x * size.y, &empty);
+}
+static bool HasFloorPic(const Tile *t);
+static void RenderChunk(
+	FloorCache *c, SDL_Renderer *r, FloorChunk *ch, const struct vec2i chunk)
+{
+	if (ch->Tex == NULL)
+	{
+		ch->Tex = TextureCreate(
+			r, SDL_TEXTUREACCESS_TARGET,
+			svec2i(
+				FLOOR_CACHE_CHUNK_TILES * TILE_WIDTH,
+				FLOOR_CACHE_CHUNK_TILES * TILE_HEIGHT),
+			SDL_BLENDMODE_BLEND, 255);
+		if (ch->Tex == NULL)
+		{
+			return;
+		}
+	}
+	if (SDL_SetRenderTarget(r, ch->Tex) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
+		return;
+	}
+	if (SDL_SetRenderDrawColor(r, 0, 0, 0, 0) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to set draw color: %s", SDL_GetError());
+	}
+	if (SDL_RenderClear(r) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to clear chunk: %s", SDL_GetError());
+	}
+	const struct vec2i origin = svec2i_scale(chunk, FLOOR_CACHE_CHUNK_TILES);
+	RECT_FOREACH(Rect2iNew(
+		origin, svec2i(FLOOR_CACHE_CHUNK_TILES, FLOOR_CACHE_CHUNK_TILES)))
+	if (!MapIsTileIn(c->Map, _v))
+	{
+		continue;
+	}
+	const Tile *t = MapGetTile(c->Map, _v);
+	if (!HasFloorPic(t))
+	{
+		continue;
+	}
+	const struct vec2i tilePos = svec2i_subtract(_v, origin);
+	PicRender(
+		t->Class->Pic, r,
+		svec2i(tilePos.x * TILE_WIDTH, tilePos.y * TILE_HEIGHT), colorWhite,
+		0, svec2_one(), SDL_FLIP_NONE, Rect2iZero());
+	RECT_FOREACH_END()
+	SpriteBatchFlush(&gSpriteBatch);
+	ch->Dirty = false;
+}
+static bool HasFloorPic(const Tile *t)
+{
+	return t->Class != NULL && t->Class->Pic != NULL &&
+		   t->Class->Pic->Data != NULL && t->Class->Type != TILE_CLASS_WALL;
+}
+static void DrawChunk(
+	const FloorChunk *ch, SDL_Renderer *r, const struct vec2i chunk,
+	const Rect2i tiles, const struct vec2i pos)
+{
+	if (ch->Tex == NULL)
+	{
+		return;
+	}
+	// Only draw the part of the chunk inside the tiles, so as not to draw
+	// over neighbouring views
+	const struct vec2i origin = svec2i_scale(chunk, FLOOR_CACHE_CHUNK_TILES);
+	const struct vec2i start = svec2i(
+		MAX(origin.x, tiles.Pos.x), MAX(origin.y, tiles.Pos.y));
+	const struct vec2i end = svec2i(
+		MIN(origin.x + FLOOR_CACHE_CHUNK_TILES, tiles.Pos.x + tiles.Size.x),
+		MIN(origin.y + FLOOR_CACHE_CHUNK_TILES, tiles.Pos.y + tiles.Size.y));
+	const struct vec2i tileSize = svec2i(TILE_WIDTH, TILE_HEIGHT);
+	const struct vec2i size =
+		svec2i_multiply(svec2i_subtract(end, start), tileSize);
+	const Rect2i src = Rect2iNew(
+		svec2i_multiply(svec2i_subtract(start, origin), tileSize), size);
+	const Rect2i dest = Rect2iNew(
+		svec2i_add(
+			pos,
+			svec2i_multiply(svec2i_subtract(start, tiles.Pos), tileSize)),
+		size);
+	TextureRender(
+		ch->Tex, r, src, dest, colorWhite, 0, SDL_FLIP_NONE);
+}
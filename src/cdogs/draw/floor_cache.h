@@ -0,0 +1,74 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <SDL.h>
+
+#include "c_array.h"
+#include "map.h"
+#include "vector.h"
+
+// Floor tiles only change when the map is built or tiles are set, so they
+// are pre-rendered in chunks to render target textures, and each frame only
+// the visible chunks are drawn instead of every floor tile
+#define FLOOR_CACHE_CHUNK_TILES 16
+
+typedef struct
+{
+	SDL_Texture *Tex;
+	bool Dirty;
+} FloorChunk;
+
+typedef struct
+{
+	SDL_Renderer *Renderer;
+	bool Supported;
+	const Map *Map;
+	struct vec2i Size; // in chunks
+	CArray Chunks;	   // of FloorChunk
+} FloorCache;
+
+// Note: reset by Map
+extern FloorCache gFloorCache;
+
+void FloorCacheInit(FloorCache *c);
+void FloorCacheTerminate(FloorCache *c);
+// Free all chunk textures; done before the renderer is destroyed
+void FloorCacheClear(FloorCache *c);
+// Start caching a new map; all chunks are redrawn when next visible
+void FloorCacheReset(FloorCache *c, const Map *map);
+// Redraw the chunk containing this tile when next visible
+void FloorCacheMarkTileDirty(
+	FloorCache *c, const Map *map, const struct vec2i tile);
+// Draw the floor of the tiles in the rect, with the first tile at pos.
+// Dirty chunks are redrawn first.
+// Returns false if render targets aren't supported, so the floor must be
+// drawn tile by tile.
+bool FloorCacheDraw(
+	FloorCache *c, SDL_Renderer *r, const Map *map, const Rect2i tiles,
+	const struct vec2i pos);
@@ -0,0 +1,166 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "fog_mask.h"
+
+#include <string.h>
+
+#include "draw/sprite_batch.h"
+#include "log.h"
+#include "texture.h"
+#include "tile_class.h"
+#include "utils.h"
+
+FogMask gFogMask;
+
+
+void FogMaskInit(FogMask *f)
+{
+	memset(f, 0, sizeof *f);
+	CArrayInit(&f->Texels, sizeof(Uint32));
+}
+void FogMaskTerminate(FogMask *f)
+{
+	FogMaskClear(f);
+	CArrayTerminate(&f->Texels);
+}
+
+void FogMaskClear(FogMask *f)
+{
+	SpriteBatchFlush(&gSpriteBatch);
+	if (f->Tex != NULL)
+	{
+		SDL_DestroyTexture(f->Tex);
+		f->Tex = NULL;
+	}
+	f->Renderer = NULL;
+}
+
+bool FogMaskSetMap(FogMask *f, SDL_Renderer *r, const Map *map)
+{
+	if (!svec2i_is_equal(map->Size, f->Size))
+	{
+		FogMaskClear(f);
+		f->Size = map->Size;
+		CArrayResize(&f->Texels, f->Size.x * f->Size.y, NULL);
+		CArrayFillZero(&f->Texels);
+	}
+	if (r != f->Renderer)
+	{
+		FogMaskClear(f);
+		f->Renderer = r;
+	}
+	if (f->Tex != NULL)
+	{
+		return true;
+	}
+	if (svec2i_is_zero(f->Size))
+	{
+		return false;
+	}
+	f->Tex = TextureCreate(
+		r, SDL_TEXTUREACCESS_STREAMING, f->Size, SDL_BLENDMODE_BLEND, 255);
+	if (f->Tex == NULL)
+	{
+		return false;
+	}
+#if SDL_VERSION_ATLEAST(2, 0, 12)
+	if (SDL_SetTextureScaleMode(f->Tex, SDL_ScaleModeLinear) != 0)
+	{
+		LOG(LM_GFX, LL_WARN, "cannot set fog scale mode: %s", SDL_GetError());
+	}
+#endif
+	// Upload everything on first draw
+	f->DirtyMin = svec2i_zero();
+	f->DirtyMax = svec2i_subtract(f->Size, svec2i_one());
+	return true;
+}
+
+void FogMaskSetTile(FogMask *f, const struct vec2i tile, const Uint32 texel)
+{
+	Uint32 *t = CArrayGet(&f->Texels, tile.x + tile.y * f->Size.x);
+	if (*t == texel)
+	{
+		return;
+	}
+	*t = texel;
+	f->DirtyMin = svec2i(MIN(f->DirtyMin.x, tile.x), MIN(f->DirtyMin.y, tile.y));
+	f->DirtyMax = svec2i(MAX(f->DirtyMax.x, tile.x), MAX(f->DirtyMax.y, tile.y));
+}
+
+static void ResetDirty(FogMask *f);
+void FogMaskDraw(
+	FogMask *f, SDL_Renderer *r, const Rect2i tiles, const struct vec2i pos)
+{
+	if (f->Tex == NULL)
+	{
+		return;
+	}
+	if (f->DirtyMin.x <= f->DirtyMax.x && f->DirtyMin.y <= f->DirtyMax.y)
+	{
+		// The texture may still be queued from another view
+		SpriteBatchFlush(&gSpriteBatch);
+		const SDL_Rect rect = {
+			f->DirtyMin.x, f->DirtyMin.y, f->DirtyMax.x - f->DirtyMin.x + 1,
+			f->DirtyMax.y - f->DirtyMin.y + 1};
+		if (SDL_UpdateTexture(
+				f->Tex, &rect,
+				CArrayGet(&f->Texels, f->DirtyMin.x + f->DirtyMin.y * f->Size.x),
+				f->Size.x * sizeof(Uint32)) != 0)
+		{
+			LOG(LM_GFX, LL_ERROR, "cannot update fog texture: %s",
+				SDL_GetError());
+		}
+		ResetDirty(f);
+	}
+
+	// Only draw the part of the map inside the tiles
+	const struct vec2i start =
+		svec2i(MAX(tiles.Pos.x, 0), MAX(tiles.Pos.y, 0));
+	const struct vec2i end = svec2i(
+		MIN(tiles.Pos.x + tiles.Size.x, f->Size.x),
+		MIN(tiles.Pos.y + tiles.Size.y, f->Size.y));
+	if (start.x >= end.x || start.y >= end.y)
+	{
+		return;
+	}
+	const struct vec2i tileSize = svec2i(TILE_WIDTH, TILE_HEIGHT);
+	const struct vec2i size = svec2i_subtract(end, start);
+	const Rect2i dest = Rect2iNew(
+		svec2i_add(
+			pos,
+			svec2i_multiply(svec2i_subtract(start, tiles.Pos), tileSize)),
+		svec2i_multiply(size, tileSize));
+	TextureRender(
+		f->Tex, r, Rect2iNew(start, size), dest, colorWhite, 0,
+		SDL_FLIP_NONE);
+}
+static void ResetDirty(FogMask *f)
+{
+	f->DirtyMin = f->Size;
+	f->DirtyMax = svec2i(-1, -1);
+}
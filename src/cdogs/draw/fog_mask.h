@@ -0,0 +1,64 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <SDL.h>
+
+#include "c_array.h"
+#include "map.h"
+#include "vector.h"
+
+// Line of sight is drawn as a black texture with one texel per map tile,
+// whose alpha darkens out of sight tiles and hides unvisited ones.
+// Only texels that change are uploaded, and the texture is drawn over each
+// view as one bilinear filtered quad, which also softens the fog edges.
+typedef struct
+{
+	SDL_Renderer *Renderer;
+	SDL_Texture *Tex;
+	struct vec2i Size; // in tiles
+	CArray Texels;	   // of Uint32
+	// Texels changed since the last upload, in tiles
+	struct vec2i DirtyMin;
+	struct vec2i DirtyMax;
+} FogMask;
+
+extern FogMask gFogMask;
+
+void FogMaskInit(FogMask *f);
+void FogMaskTerminate(FogMask *f);
+// Free the texture; done before the renderer is destroyed
+void FogMaskClear(FogMask *f);
+// Prepare the mask for a map before setting its tiles.
+// Returns false if the texture cannot be created.
+bool FogMaskSetMap(FogMask *f, SDL_Renderer *r, const Map *map);
+void FogMaskSetTile(FogMask *f, const struct vec2i tile, const Uint32 texel);
+// Upload changed texels, then draw the fog over the tiles in the rect,
+// with the first tile at pos
+void FogMaskDraw(
+	FogMask *f, SDL_Renderer *r, const Rect2i tiles, const struct vec2i pos);
@@ -0,0 +1,210 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "sprite_batch.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "log.h"
+#include "utils.h"
+
+SpriteBatch gSpriteBatch;
+
+
+void SpriteBatchInit(SpriteBatch *b)
+{
+	memset(b, 0, sizeof *b);
+	CArrayInit(&b->Vertices, sizeof(SDL_Vertex));
+	CArrayInit(&b->Indices, sizeof(int));
+}
+void SpriteBatchTerminate(SpriteBatch *b)
+{
+	CArrayTerminate(&b->Vertices);
+	CArrayTerminate(&b->Indices);
+}
+
+#if SPRITE_BATCH_ENABLED
+static void AddQuad(
+	SpriteBatch *b, const Rect2i src, const Rect2i dest, const color_t mask,
+	const double angle, const SDL_RendererFlip flip);
+#endif
+void SpriteBatchAdd(
+	SpriteBatch *b, SDL_Texture *t, SDL_Renderer *r, const Rect2i src,
+	const Rect2i dest, const color_t mask, const double angle,
+	const SDL_RendererFlip flip)
+{
+	b->Sprites++;
+#if SPRITE_BATCH_ENABLED
+	if (t != b->Tex || r != b->Renderer)
+	{
+		SpriteBatchFlush(b);
+		if (SDL_QueryTexture(t, NULL, NULL, &b->TexSize.x, &b->TexSize.y) !=
+			0)
+		{
+			LOG(LM_GFX, LL_ERROR, "cannot query texture: %s", SDL_GetError());
+			return;
+		}
+		b->Tex = t;
+		b->Renderer = r;
+	}
+	AddQuad(b, src, dest, mask, angle, flip);
+#else
+	b->DrawCalls++;
+	if (SDL_SetTextureColorMod(t, mask.r, mask.g, mask.b) != 0)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Failed to set texture mask: %s",
+			SDL_GetError());
+	}
+	if (mask.a < 255 && SDL_SetTextureAlphaMod(t, mask.a) != 0)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Failed to set texture alpha: %s",
+			SDL_GetError());
+	}
+	const SDL_Rect srcRect = {src.Pos.x, src.Pos.y, src.Size.x, src.Size.y};
+	const SDL_Rect *srcP = Rect2iIsZero(src) ? NULL : &srcRect;
+	const SDL_Rect destRect = {
+		dest.Pos.x, dest.Pos.y, dest.Size.x, dest.Size.y};
+	const SDL_Rect *dstP = Rect2iIsZero(dest) ? NULL : &destRect;
+
+	if (SDL_RenderCopyEx(r, t, srcP, dstP, angle, NULL, flip) != 0)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Failed to render texture: %s", SDL_GetError());
+	}
+	// Reset
+	// TODO: not sure why this reset is necessary and we can't always set alpha
+	if (mask.a < 255 && SDL_SetTextureAlphaMod(t, 255) != 0)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Failed to reset texture alpha: %s",
+			SDL_GetError());
+	}
+#endif
+}
+#if SPRITE_BATCH_ENABLED
+static void AddQuad(
+	SpriteBatch *b, const Rect2i src, const Rect2i dest, const color_t mask,
+	const double angle, const SDL_RendererFlip flip)
+{
+	const Rect2i s =
+		Rect2iIsZero(src) ? Rect2iNew(svec2i_zero(), b->TexSize) : src;
+	Rect2i d = dest;
+	if (Rect2iIsZero(d))
+	{
+		// Fill the render target, or the logical screen
+		int lw, lh;
+		SDL_RenderGetLogicalSize(b->Renderer, &lw, &lh);
+		if (SDL_GetRenderTarget(b->Renderer) == NULL && lw > 0 && lh > 0)
+		{
+			d.Size = svec2i(lw, lh);
+		}
+		else
+		{
+			SDL_GetRendererOutputSize(b->Renderer, &d.Size.x, &d.Size.y);
+		}
+	}
+
+	// Texture coordinates, swapped to flip
+	float u0 = (float)s.Pos.x / b->TexSize.x;
+	float v0 = (float)s.Pos.y / b->TexSize.y;
+	float u1 = (float)(s.Pos.x + s.Size.x) / b->TexSize.x;
+	float v1 = (float)(s.Pos.y + s.Size.y) / b->TexSize.y;
+	if (flip & SDL_FLIP_HORIZONTAL)
+	{
+		const float tmp = u0;
+		u0 = u1;
+		u1 = tmp;
+	}
+	if (flip & SDL_FLIP_VERTICAL)
+	{
+		const float tmp = v0;
+		v0 = v1;
+		v1 = tmp;
+	}
+
+	// Corners relative to the dest centre, rotated clockwise about it
+	const float hw = d.Size.x / 2.0f;
+	const float hh = d.Size.y / 2.0f;
+	const struct vec2 centre = svec2(d.Pos.x + hw, d.Pos.y + hh);
+	const struct vec2 corners[4] = {
+		{-hw, -hh}, {hw, -hh}, {hw, hh}, {-hw, hh}};
+	const struct vec2 uvs[4] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+	const float c = angle != 0 ? (float)cos(angle * MPI / 180) : 1;
+	const float sn = angle != 0 ? (float)sin(angle * MPI / 180) : 0;
+	const SDL_Color color = {mask.r, mask.g, mask.b, mask.a};
+	const int first = (int)b->Vertices.size;
+	for (int i = 0; i < 4; i++)
+	{
+		SDL_Vertex v;
+		v.position.x = centre.x + corners[i].x * c - corners[i].y * sn;
+		v.position.y = centre.y + corners[i].x * sn + corners[i].y * c;
+		v.color = color;
+		v.tex_coord.x = uvs[i].x;
+		v.tex_coord.y = uvs[i].y;
+		CArrayPushBack(&b->Vertices, &v);
+	}
+	const int indices[6] = {first,	   first + 1, first + 2,
+							first + 2, first + 3, first};
+	for (int i = 0; i < 6; i++)
+	{
+		CArrayPushBack(&b->Indices, &indices[i]);
+	}
+}
+#endif
+
+void SpriteBatchFlush(SpriteBatch *b)
+{
+#if SPRITE_BATCH_ENABLED
+	if (b->Vertices.size == 0)
+	{
+		return;
+	}
+	b->DrawCalls++;
+	// Forget the texture too, in case it is destroyed after this
+	if (SDL_RenderGeometry(
+			b->Renderer, b->Tex, b->Vertices.data, (int)b->Vertices.size,
+			b->Indices.data, (int)b->Indices.size) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to render geometry: %s",
+			SDL_GetError());
+	}
+	CArrayClear(&b->Vertices);
+	CArrayClear(&b->Indices);
+	b->Tex = NULL;
+	b->Renderer = NULL;
+#else
+	UNUSED(b);
+#endif
+}
+
+void SpriteBatchEndFrame(SpriteBatch *b)
+{
+	SpriteBatchFlush(b);
+	b->FrameDrawCalls = b->DrawCalls;
+	b->FrameSprites = b->Sprites;
+	b->DrawCalls = 0;
+	b->Sprites = 0;
+}
@@ -0,0 +1,67 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <SDL.h>
+
+#include "c_array.h"
+#include "vector.h"
+
+// Textured quads are queued and drawn with as few SDL_RenderGeometry calls
+// as possible; quads are batched while they share a texture (atlas page), so
+// any other renderer state change must flush the batch first
+#define SPRITE_BATCH_ENABLED SDL_VERSION_ATLEAST(2, 0, 18)
+
+typedef struct
+{
+	SDL_Renderer *Renderer;
+	SDL_Texture *Tex;
+	struct vec2i TexSize;
+	CArray Vertices; // of SDL_Vertex
+	CArray Indices;	 // of int
+	// Counts for the frame being drawn, and for the last complete frame
+	int DrawCalls;
+	int Sprites;
+	int FrameDrawCalls;
+	int FrameSprites;
+} SpriteBatch;
+
+extern SpriteBatch gSpriteBatch;
+
+void SpriteBatchInit(SpriteBatch *b);
+void SpriteBatchTerminate(SpriteBatch *b);
+// Queue a textured quad; src is in texels, and a zero rect is the whole
+// texture or render target. Same arguments as SDL_RenderCopyEx.
+void SpriteBatchAdd(
+	SpriteBatch *b, SDL_Texture *t, SDL_Renderer *r, const Rect2i src,
+	const Rect2i dest, const color_t mask, const double angle,
+	const SDL_RendererFlip flip);
+// Draw all queued quads
+void SpriteBatchFlush(SpriteBatch *b);
+// Record the counts for the frame just drawn
+void SpriteBatchEndFrame(SpriteBatch *b);
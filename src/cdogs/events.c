@@ -209,7 +209,8 @@ void EventPoll(
 					svec2i(e.window.data1, e.window.data2), false, scale,
 					gGraphicsDevice.cachedConfig.ScaleMode,
 					gGraphicsDevice.cachedConfig.Brightness,
-					gGraphicsDevice.cachedConfig.SecondWindow);
+					gGraphicsDevice.cachedConfig.SecondWindow,
+					gGraphicsDevice.cachedConfig.VSync);
 				GraphicsInitialize(&gGraphicsDevice);
 			}
 			break;
@@ -221,6 +222,14 @@ void EventPoll(
 				break;
 			}
 			break;
+		case SDL_RENDER_TARGETS_RESET:
+			LOG(LM_GFX, LL_WARN, "render targets reset");
+			GraphicsOnRenderReset(false);
+			break;
+		case SDL_RENDER_DEVICE_RESET:
+			LOG(LM_GFX, LL_WARN, "render device reset");
+			GraphicsOnRenderReset(true);
+			break;
 		case SDL_QUIT:
 			handlers->HasQuit = true;
 			break;
@@ -526,6 +535,7 @@ void InputGetButtonNameColor(
 		JoyButtonNameColor(dIndex, cmd, buf, color);
 		return;
 	case INPUT_DEVICE_AI:
+	case INPUT_DEVICE_REPLAY:
 		return;
 	default:
 		CASSERT(false, "unknown input device");
@@ -551,6 +561,7 @@ void InputGetDirectionNames(
 		strcpy(buf, "directions");
 		break;
 	case INPUT_DEVICE_AI:
+	case INPUT_DEVICE_REPLAY:
 		break;
 	case INPUT_DEVICE_UNSET:
 		break;
@@ -572,6 +583,7 @@ bool InputHasGrenadeButton(const input_device_e d, const int dIndex)
 	case INPUT_DEVICE_JOYSTICK:
 		return true;
 	case INPUT_DEVICE_AI:
+	case INPUT_DEVICE_REPLAY:
 		return false;
 	default:
 		CASSERT(false, "unknown input device");
@@ -36,9 +36,51 @@
 
 #define FIRST_CHAR 0
 #define LAST_CHAR 255
+#define FONT_ATLAS_PAGE_SIZE 512
+#define FONT_RUNS_MAX 256
+// Open addressed, so kept at most half full; a power of 2
+#define FONT_RUNS_TABLE_SIZE (FONT_RUNS_MAX * 2)
+// Longer strings are laid out every time instead of cached
+#define FONT_RUN_STR_MAX 512
 
 Font gFont;
 
+// Strings are laid out into runs of glyphs, cached by their text and wrap
+// width so that text drawn every frame skips layout. Runs are found by hash
+// and kept in recently used order; when full, the least recently used run
+// is replaced.
+typedef struct
+{
+	const Pic *Ch;
+	struct vec2i Pos;
+} FontGlyph;
+typedef struct FontRun
+{
+	uint64_t Key;
+	char Str[FONT_RUN_STR_MAX];
+	int Width;
+	struct vec2i Size;
+	// Cursor position after the last glyph
+	struct vec2i End;
+	CArray Glyphs; // of FontGlyph
+	// Neighbours in the recently used list
+	struct FontRun *Prev;
+	struct FontRun *Next;
+} FontRun;
+typedef struct
+{
+	FontRun Runs[FONT_RUNS_MAX];
+	int Count;
+	// Runs by key, NULL for empty slots
+	FontRun *Table[FONT_RUNS_TABLE_SIZE];
+	// Most and least recently used runs
+	FontRun *Head;
+	FontRun *Tail;
+	// For strings too long to cache
+	FontRun Scratch;
+} FontRuns;
+static FontRuns sRuns;
+
 FontOpts FontOptsNew(void)
 {
 	FontOpts opts;
@@ -67,6 +109,10 @@ void FontLoad(
 	}
 
 	CArrayInit(&f->Chars, sizeof(Pic));
+	PicAtlasInit(
+		&f->Atlas, svec2i(FONT_ATLAS_PAGE_SIZE, FONT_ATLAS_PAGE_SIZE));
+	// Cached runs point to the old glyphs
+	FontRunsClear();
 
 	// Check that the image is big enough for the dimensions
 	const struct vec2i step = svec2i(
@@ -108,6 +154,11 @@ void FontLoad(
 			{
 				PicTrim(&p, true, false);
 			}
+			if (!PicIsNone(&p) && !PicAtlasAdd(&f->Atlas, &p))
+			{
+				LOG(LM_GFX, LL_WARN, "cannot add glyph %d to font atlas",
+					chars);
+			}
 			CArrayPushBack(&f->Chars, &p);
 		}
 	}
@@ -115,10 +166,22 @@ void FontLoad(
 }
 void FontTerminate(Font *f)
 {
+	FontRunsClear();
 	CA_FOREACH(Pic, p, f->Chars)
 	PicFree(p);
 	CA_FOREACH_END()
 	CArrayTerminate(&f->Chars);
+	PicAtlasTerminate(&f->Atlas);
+}
+
+void FontRunsClear(void)
+{
+	for (int i = 0; i < sRuns.Count; i++)
+	{
+		CArrayTerminate(&sRuns.Runs[i].Glyphs);
+	}
+	CArrayTerminate(&sRuns.Scratch.Glyphs);
+	memset(&sRuns, 0, sizeof sRuns);
 }
 
 int FontW(const char c)
@@ -204,8 +267,7 @@ struct vec2i FontCh(const char c, const struct vec2i pos)
 {
 	return FontChMask(c, pos, colorWhite);
 }
-struct vec2i FontChMask(
-	const char c, const struct vec2i pos, const color_t mask)
+static const Pic *GetChPic(const char c)
 {
 	int idx = (int)c - FIRST_CHAR;
 	if (idx < 0)
@@ -217,7 +279,12 @@ struct vec2i FontChMask(
 		fprintf(stderr, "invalid char %d\n", idx);
 		idx = FIRST_CHAR;
 	}
-	const Pic *pic = CArrayGet(&gFont.Chars, idx);
+	return CArrayGet(&gFont.Chars, idx);
+}
+struct vec2i FontChMask(
+	const char c, const struct vec2i pos, const color_t mask)
+{
+	const Pic *pic = GetChPic(c);
 	PicRender(
 		pic, gGraphicsDevice.gameWindow.renderer, pos, mask, 0, svec2_one(),
 		SDL_FLIP_NONE, Rect2iZero());
@@ -228,54 +295,213 @@ struct vec2i FontStr(const char *s, struct vec2i pos)
 {
 	return FontStrMask(s, pos, colorWhite);
 }
+static const FontRun *GetRun(const char *s, const int width);
+static struct vec2i DrawRun(
+	const FontRun *r, const struct vec2i pos, const color_t mask);
 struct vec2i FontStrMask(const char *s, struct vec2i pos, const color_t mask)
 {
 	if (s == NULL)
 	{
 		return pos;
 	}
-	int left = pos.x;
-	while (*s)
+	return DrawRun(GetRun(s, 0), pos, mask);
+}
+struct vec2i FontStrMaskWrap(
+	const char *s, struct vec2i pos, color_t mask, const int width)
+{
+	return DrawRun(GetRun(s, width), pos, mask);
+}
+static struct vec2i GetStrPos(
+	const struct vec2i textSize, struct vec2i pos, const FontOpts opts);
+void FontStrOpt(const char *s, struct vec2i pos, const FontOpts opts)
+{
+	if (s == NULL)
 	{
-		if (*s == '\n')
+		return;
+	}
+	const FontRun *r = GetRun(s, 0);
+	pos = GetStrPos(r->Size, pos, opts);
+	DrawRun(r, pos, opts.Mask);
+}
+static FontRun **FindRunSlot(
+	const uint64_t key, const char *s, const int width);
+static FontRun *NewRun(void);
+static void RunsPushFront(FontRun *r);
+static void RunsUnlink(FontRun *r);
+static void LayoutRunWrap(FontRun *r, const char *s, const int width);
+static const FontRun *GetRun(const char *s, const int width)
+{
+	if (strlen(s) >= FONT_RUN_STR_MAX)
+	{
+		FontRun *r = &sRuns.Scratch;
+		if (r->Glyphs.elemSize == 0)
 		{
-			pos.x = left;
-			pos.y += FontH();
+			CArrayInit(&r->Glyphs, sizeof(FontGlyph));
 		}
-		else
+		CArrayClear(&r->Glyphs);
+		LayoutRunWrap(r, s, width);
+		return r;
+	}
+	const uint64_t key =
+		Hash64Str(Hash64(HASH64_INIT, &width, sizeof width), s);
+	FontRun *r = *FindRunSlot(key, s, width);
+	if (r != NULL)
+	{
+		RunsUnlink(r);
+		RunsPushFront(r);
+		return r;
+	}
+
+	// Evicting may move other runs in the table, so find the slot after
+	r = NewRun();
+	*FindRunSlot(key, s, width) = r;
+	RunsPushFront(r);
+	r->Key = key;
+	strcpy(r->Str, s);
+	r->Width = width;
+	LayoutRunWrap(r, s, width);
+	return r;
+}
+static FontRun **FindRunSlot(
+	const uint64_t key, const char *s, const int width)
+{
+	// Linear probe; the table size is a power of 2
+	const size_t mask = FONT_RUNS_TABLE_SIZE - 1;
+	for (size_t i = (size_t)key & mask;; i = (i + 1) & mask)
+	{
+		FontRun *r = sRuns.Table[i];
+		if (r == NULL ||
+			(r->Key == key && r->Width == width && strcmp(r->Str, s) == 0))
 		{
-			pos = FontChMask(*s, pos, mask);
+			return &sRuns.Table[i];
 		}
-		s++;
 	}
-	return pos;
 }
-struct vec2i FontStrMaskWrap(
-	const char *s, struct vec2i pos, color_t mask, const int width)
+static void RemoveRunSlot(const FontRun *r);
+static FontRun *NewRun(void)
 {
+	if (sRuns.Count < FONT_RUNS_MAX)
+	{
+		FontRun *r = &sRuns.Runs[sRuns.Count];
+		sRuns.Count++;
+		CArrayInit(&r->Glyphs, sizeof(FontGlyph));
+		return r;
+	}
+	// Replace the least recently used run
+	FontRun *lru = sRuns.Tail;
+	RunsUnlink(lru);
+	RemoveRunSlot(lru);
+	CArrayClear(&lru->Glyphs);
+	return lru;
+}
+static void RemoveRunSlot(const FontRun *r)
+{
+	const size_t mask = FONT_RUNS_TABLE_SIZE - 1;
+	size_t i = (size_t)r->Key & mask;
+	while (sRuns.Table[i] != r)
+	{
+		i = (i + 1) & mask;
+	}
+	// Shift back the runs after it that probed past this slot, so that
+	// lookups don't stop early at the gap
+	for (size_t j = (i + 1) & mask; sRuns.Table[j] != NULL; j = (j + 1) & mask)
+	{
+		const size_t home = (size_t)sRuns.Table[j]->Key & mask;
+		// Whether home is cyclically outside (i, j]
+		const bool canMove =
+			i <= j ? (home <= i || home > j) : (home <= i && home > j);
+		if (canMove)
+		{
+			sRuns.Table[i] = sRuns.Table[j];
+			i = j;
+		}
+	}
+	sRuns.Table[i] = NULL;
+}
+static void RunsPushFront(FontRun *r)
+{
+	r->Prev = NULL;
+	r->Next = sRuns.Head;
+	if (sRuns.Head != NULL)
+	{
+		sRuns.Head->Prev = r;
+	}
+	else
+	{
+		sRuns.Tail = r;
+	}
+	sRuns.Head = r;
+}
+static void RunsUnlink(FontRun *r)
+{
+	if (r->Prev != NULL)
+	{
+		r->Prev->Next = r->Next;
+	}
+	else
+	{
+		sRuns.Head = r->Next;
+	}
+	if (r->Next != NULL)
+	{
+		r->Next->Prev = r->Prev;
+	}
+	else
+	{
+		sRuns.Tail = r->Prev;
+	}
+	r->Prev = r->Next = NULL;
+}
+static void LayoutRun(FontRun *r, const char *s);
+static void LayoutRunWrap(FontRun *r, const char *s, const int width)
+{
+	if (width == 0)
+	{
+		LayoutRun(r, s);
+		return;
+	}
 	char buf[1024];
 	CASSERT(strlen(s) < 1024, "string too long to wrap");
 	FontSplitLines(s, buf, width);
-	return FontStrMask(buf, pos, mask);
+	LayoutRun(r, buf);
 }
-static struct vec2i GetStrPos(
-	const char *s, struct vec2i pos, const FontOpts opts);
-void FontStrOpt(const char *s, struct vec2i pos, const FontOpts opts)
+static void LayoutRun(FontRun *r, const char *s)
 {
-	if (s == NULL)
+	r->Size = FontStrSize(s);
+	struct vec2i pos = svec2i_zero();
+	for (; *s; s++)
 	{
-		return;
+		if (*s == '\n')
+		{
+			pos.x = 0;
+			pos.y += FontH();
+			continue;
+		}
+		FontGlyph g;
+		g.Ch = GetChPic(*s);
+		g.Pos = pos;
+		CArrayPushBack(&r->Glyphs, &g);
+		// Add gap between characters
+		pos.x += g.Ch->size.x + gFont.Gap.x;
 	}
-	pos = GetStrPos(s, pos, opts);
-	FontStrMask(s, pos, opts.Mask);
+	r->End = pos;
+}
+static struct vec2i DrawRun(
+	const FontRun *r, const struct vec2i pos, const color_t mask)
+{
+	CA_FOREACH(const FontGlyph, g, r->Glyphs)
+	PicRender(
+		g->Ch, gGraphicsDevice.gameWindow.renderer, svec2i_add(pos, g->Pos),
+		mask, 0, svec2_one(), SDL_FLIP_NONE, Rect2iZero());
+	CA_FOREACH_END()
+	return svec2i_add(pos, r->End);
 }
 static int GetAlign(
 	const FontAlign align, const int pos, const int pad, const int area,
 	const int size);
 static struct vec2i GetStrPos(
-	const char *s, struct vec2i pos, const FontOpts opts)
+	const struct vec2i textSize, struct vec2i pos, const FontOpts opts)
 {
-	const struct vec2i textSize = FontStrSize(s);
 	return svec2i(
 		GetAlign(opts.HAlign, pos.x, opts.Pad.x, opts.Area.x, textSize.x),
 		GetAlign(opts.VAlign, pos.y, opts.Pad.y, opts.Area.y, textSize.y));
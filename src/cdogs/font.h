@@ -28,6 +28,7 @@
 #include <SDL_surface.h>
 
 #include "c_array.h"
+#include "pic_atlas.h"
 #include "vector.h"
 
 #define ARROW_LEFT "\x11"
@@ -50,6 +51,8 @@ typedef struct
 	} Padding;
 	struct vec2i Gap;
 	CArray Chars; // of Pic
+	// All the glyphs share a page, so a string is drawn as one batch
+	PicAtlas Atlas;
 } Font;
 
 typedef enum
@@ -75,6 +78,8 @@ void FontLoad(
 	Font *f, const char *imgPath, const bool isProportional,
 	const struct vec2i spaceSize);
 void FontTerminate(Font *f);
+// Forget cached string layouts
+void FontRunsClear(void);
 
 int FontW(const char c);
 int FontH(void);
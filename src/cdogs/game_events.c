@@ -31,6 +31,7 @@
 #include <string.h>
 
 #include "actors.h"
+#include "bullet_class.h"
 #include "net_client.h"
 #include "net_server.h"
 #include "pickup.h"
@@ -120,11 +121,53 @@ static GameEventEntry sGameEventEntries[] = {
 	{GAME_EVENT_MISSION_INCOMPLETE, true, false, true, true, NULL},
 	{GAME_EVENT_MISSION_PICKUP, true, false, true, true, NULL},
 	{GAME_EVENT_MISSION_END, true, false, true, true, NMissionEnd_fields}};
+
 GameEventEntry GameEventGetEntry(const GameEventType e)
 {
 	return sGameEventEntries[(int)e];
 }
 
+// Sounds can be heard about a screen away, well beyond sight range
+#define SOUND_INTEREST_REACH (TILE_WIDTH * 24)
+bool GameEventGetInterest(const GameEvent *e, struct vec2 *pos, float *reach)
+{
+	*reach = 0;
+	switch (e->Type)
+	{
+	case GAME_EVENT_SOUND_AT:
+		*pos = NetToVec2(e->u.SoundAt.Pos);
+		*reach = SOUND_INTEREST_REACH;
+		return true;
+	case GAME_EVENT_GUN_FIRE:
+		*pos = NetToVec2(e->u.GunFire.MuzzlePos);
+		*reach = SOUND_INTEREST_REACH;
+		return true;
+	case GAME_EVENT_GUN_RELOAD:
+		*pos = NetToVec2(e->u.GunReload.Pos);
+		*reach = SOUND_INTEREST_REACH;
+		return true;
+	case GAME_EVENT_BULLET_BOUNCE:
+		*pos = NetToVec2(e->u.BulletBounce.Pos);
+		*reach = SOUND_INTEREST_REACH;
+		return true;
+	case GAME_EVENT_ADD_BULLET: {
+		*pos = NetToVec2(e->u.AddBullet.MuzzlePos);
+		// Bullets can fly into view from as far as they can travel
+		const BulletClass *b = StrBulletClass(e->u.AddBullet.BulletClass);
+		if (b != NULL)
+		{
+			*reach = b->SpeedHigh * (float)b->RangeHigh;
+		}
+		return true;
+	}
+	default:
+		// Includes gun states: they are only sent on change and snapshots
+		// don't carry them, so a peer that missed one would never be
+		// corrected
+		return false;
+	}
+}
+
 void GameEventsEnqueue(CArray *store, GameEvent e)
 {
 	if (store->elemSize == 0)
@@ -135,9 +178,10 @@ void GameEventsEnqueue(CArray *store, GameEvent e)
 	// If we're the client, pass along to server, but only if it's for a local
 	// player Otherwise we'd ping-pong the same updates from the server
 	const GameEventEntry gee = sGameEventEntries[e.Type];
-	if (gee.Broadcast)
+	// Clients get some state from snapshots instead
+	if (gee.Broadcast && !NetSnapshotReplacesEvent(gee.Type))
 	{
-		NetServerSendMsg(&gNetServer, NET_SERVER_BCAST, gee.Type, &e.u);
+		NetServerBroadcastEvent(&gNetServer, &e);
 	}
 	if (gee.Submit)
 	{
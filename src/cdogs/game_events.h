@@ -113,6 +113,22 @@ typedef enum
 	GAME_EVENT_MISSION_END
 } GameEventType;
 
+// Network channels; each is sequenced independently of the others
+typedef enum
+{
+	// Reliable and ordered; for all game events, since those that change
+	// state are only sent on change and would never be corrected if lost
+	NET_CHANNEL_RELIABLE,
+	// Unreliable-sequenced; for snapshots and their acks, which are
+	// superseded by newer ones, so late packets are dropped and lost packets
+	// are not resent
+	NET_CHANNEL_STATE,
+	// Reliable; fragments of the compressed world sent to joining clients,
+	// so that the bulk transfer doesn't hold up the other channels
+	NET_CHANNEL_WORLD,
+	NET_CHANNEL_COUNT
+} NetChannel;
+
 // Which game events should be passed along to server or client
 typedef struct
 {
@@ -209,3 +225,7 @@ void GameEventsClear(CArray *store);
 
 GameEvent GameEventNew(GameEventType type);
 GameEvent GameEventNewActorAdd(const struct vec2 pos, const Character *c, const PlayerData *p);
+// For transient events that only matter near where they happen, get that
+// position and how far beyond sight they can still be seen or heard.
+// Returns false for events that always matter.
+bool GameEventGetInterest(const GameEvent *e, struct vec2 *pos, float *reach);
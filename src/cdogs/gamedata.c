@@ -87,6 +87,11 @@ bool CampaignLoad(Campaign *co, const CampaignEntry *entry)
 	CampaignSettingInit(&co->Setting);
 	if (entry->Mode == GAME_MODE_QUICK_PLAY)
 	{
+		if (co->QuickPlaySeed == 0)
+		{
+			co->QuickPlaySeed = (unsigned int)rand() + 1;
+		}
+		srand(co->QuickPlaySeed);
 		SetupQuickPlayCampaign(&co->Setting, false);
 		co->IsLoaded = true;
 	}
@@ -115,6 +120,7 @@ bool CampaignLoad(Campaign *co, const CampaignEntry *entry)
 void CampaignUnload(Campaign *co)
 {
 	co->MissionIndex = 0;
+	co->QuickPlaySeed = 0;
 	co->IsLoaded = false;
 	co->IsClient = false;	// TODO: select is client from menu
 	co->OptionsSet = false;
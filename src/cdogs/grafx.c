@@ -56,13 +56,18 @@
 #include <SDL_events.h>
 #include <SDL_mouse.h>
 
+#include "automap.h"
 #include "blit.h"
 #include "config.h"
 #include "defs.h"
 #include "draw/drawtools.h"
+#include "draw/floor_cache.h"
+#include "draw/fog_mask.h"
+#include "draw/sprite_batch.h"
 #include "files.h"
 #include "font_utils.h"
 #include "grafx_bg.h"
+#include "hud/hud_layer.h"
 #include "log.h"
 #include "palette.h"
 #include "utils.h"
@@ -72,6 +77,11 @@ GraphicsDevice gGraphicsDevice;
 void GraphicsInit(GraphicsDevice *device, Config *c)
 {
 	memset(device, 0, sizeof *device);
+	SpriteBatchInit(&gSpriteBatch);
+	FloorCacheInit(&gFloorCache);
+	FogMaskInit(&gFogMask);
+	AutomapCacheInit(&gAutomapCache);
+	HUDLayerInit(&gHUDLayer);
 	GraphicsConfigSetFromConfig(&device->cachedConfig, c);
 	device->cachedConfig.RestartFlags = RESTART_ALL;
 }
@@ -124,10 +134,17 @@ void GraphicsInitialize(GraphicsDevice *g)
 			windowDim.Pos = svec2i_zero();
 		}
 		LOG(LM_GFX, LL_DEBUG, "destroying previous renderer");
+		FloorCacheClear(&gFloorCache);
+		FogMaskClear(&gFogMask);
+		AutomapCacheClear(&gAutomapCache);
+		HUDLayerClear(&gHUDLayer);
 		WindowContextDestroy(&g->gameWindow);
 		WindowContextDestroy(&g->secondWindow);
 		SDL_FreeFormat(g->Format);
 
+		SDL_SetHint(
+			SDL_HINT_RENDER_VSYNC, g->cachedConfig.VSync ? "1" : "0");
+
 		char title[32];
 		sprintf(
 			title, "C-Dogs SDL %s%s",
@@ -259,6 +276,7 @@ void GraphicsInitialize(GraphicsDevice *g)
 	{
 		if (!initWindow && !initTextures)
 		{
+			SpriteBatchFlush(&gSpriteBatch);
 			SDL_DestroyTexture(g->brightnessOverlay);
 		}
 
@@ -285,15 +303,53 @@ void GraphicsInitialize(GraphicsDevice *g)
 	g->cachedConfig.RestartFlags = 0;
 }
 
+// Initialise a graphics device without a window or renderer, for running
+// the game simulation only. Pixel formats and the blit buffer are still set
+// up since game logic reads pic data.
+void GraphicsInitializeHeadless(GraphicsDevice *g)
+{
+	LOG(LM_GFX, LL_INFO, "headless graphics mode(%dx%d)",
+		g->cachedConfig.Res.x, g->cachedConfig.Res.y);
+	g->IsHeadless = true;
+	SDL_FreeFormat(g->Format);
+	g->Format = SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888);
+	CFREE(g->buf);
+	CCALLOC(g->buf, GraphicsGetMemSize(&g->cachedConfig));
+	g->IsInitialized = true;
+	g->cachedConfig.RestartFlags = 0;
+}
+
 void GraphicsTerminate(GraphicsDevice *g)
 {
+	FloorCacheTerminate(&gFloorCache);
+	FogMaskTerminate(&gFogMask);
+	AutomapCacheTerminate(&gAutomapCache);
+	HUDLayerTerminate(&gHUDLayer);
 	WindowContextDestroy(&g->gameWindow);
 	WindowContextDestroy(&g->secondWindow);
+	SpriteBatchTerminate(&gSpriteBatch);
 	SDL_FreeFormat(g->Format);
 	SDL_VideoQuit();
 	CFREE(g->buf);
 }
 
+void GraphicsOnRenderReset(const bool deviceReset)
+{
+	if (deviceReset)
+	{
+		// The cached textures are lost; free them so they are recreated and
+		// redrawn when next drawn
+		FloorCacheClear(&gFloorCache);
+		HUDLayerClear(&gHUDLayer);
+	}
+	else
+	{
+		// Only the render target contents are lost
+		FloorCacheReset(&gFloorCache, gFloorCache.Map);
+		gHUDLayer.Drawn = false;
+	}
+}
+
 int GraphicsGetScreenSize(GraphicsConfig *config)
 {
 	return config->Res.x * config->Res.y;
@@ -307,7 +363,7 @@ int GraphicsGetMemSize(GraphicsConfig *config)
 void GraphicsConfigSet(
 	GraphicsConfig *c, struct vec2i windowSize, const bool fullscreen,
 	const int scaleFactor, const ScaleMode scaleMode, const int brightness,
-	const bool secondWindow)
+	const bool secondWindow, const bool vsync)
 {
 #define SET(_lhs, _rhs, _flag)                                                \
 	if ((_lhs) != (_rhs))                                                     \
@@ -336,6 +392,7 @@ void GraphicsConfigSet(
 	SET(c->ScaleMode, scaleMode, RESTART_SCALE_MODE);
 	SET(c->Brightness, brightness, RESTART_BRIGHTNESS);
 	SET(c->SecondWindow, secondWindow, RESTART_WINDOW);
+	SET(c->VSync, vsync, RESTART_WINDOW);
 	const struct vec2i res = svec2i_scale_divide(windowSize, scaleFactor);
 	if (!svec2i_is_equal(res, c->Res))
 	{
@@ -355,11 +412,14 @@ void GraphicsConfigSetFromConfig(GraphicsConfig *gc, Config *c)
 		ConfigGetInt(c, "Graphics.ScaleFactor"),
 		(ScaleMode)ConfigGetEnum(c, "Graphics.ScaleMode"),
 		ConfigGetInt(c, "Graphics.Brightness"),
-		ConfigGetBool(c, "Graphics.SecondWindow"));
+		ConfigGetBool(c, "Graphics.SecondWindow"),
+		// Interpolated frames are paced by the display refresh rate
+		ConfigGetBool(c, "Graphics.FrameInterpolation"));
 }
 
 void GraphicsSetClip(SDL_Renderer *renderer, const Rect2i r)
 {
+	SpriteBatchFlush(&gSpriteBatch);
 	const SDL_Rect rect = {r.Pos.x, r.Pos.y, r.Size.x, r.Size.y};
 	if (SDL_RenderSetClipRect(renderer, Rect2iIsZero(r) ? NULL : &rect) != 0)
 	{
@@ -376,6 +436,7 @@ Rect2i GraphicsGetClip(SDL_Renderer *renderer)
 
 void GraphicsResetClip(SDL_Renderer *renderer)
 {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_RenderSetClipRect(renderer, NULL) != 0)
 	{
 		LOG(LM_MAIN, LL_ERROR, "Could not reset clip rect: %s",
@@ -71,6 +71,7 @@ typedef struct
 	ScaleMode ScaleMode;
 	int Brightness;
 	bool SecondWindow;
+	bool VSync;
 	bool IsEditor;
 
 	int RestartFlags;
@@ -80,6 +81,8 @@ typedef struct
 {
 	int IsInitialized;
 	int IsWindowInitialized;
+	// Null device: no window or renderer; pics have pixel data only
+	bool IsHeadless;
 	SDL_Surface *icon;
 	SDL_Texture *screen;
 	SDL_Texture *hud;
@@ -100,14 +103,18 @@ extern GraphicsDevice gGraphicsDevice;
 
 void GraphicsInit(GraphicsDevice *device, Config *c);
 void GraphicsInitialize(GraphicsDevice *g);
+void GraphicsInitializeHeadless(GraphicsDevice *g);
 void GraphicsTerminate(GraphicsDevice *g);
+// Redraw cached render targets after the renderer lost them; on device reset
+// their textures are recreated too
+void GraphicsOnRenderReset(const bool deviceReset);
 int GraphicsGetScreenSize(GraphicsConfig *config);
 int GraphicsGetMemSize(GraphicsConfig *config);
 void GraphicsConfigSet(
 	GraphicsConfig *c,
 	struct vec2i res, const bool fullscreen,
 	const int scaleFactor, const ScaleMode scaleMode, const int brightness,
-	const bool secondWindow);
+	const bool secondWindow, const bool vsync);
 void GraphicsConfigSetFromConfig(GraphicsConfig *gc, Config *c);
 
 void GraphicsSetClip(SDL_Renderer *renderer, const Rect2i r);
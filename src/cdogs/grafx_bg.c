@@ -31,6 +31,7 @@
 #include "ai.h"
 #include "draw/draw.h"
 #include "draw/drawtools.h"
+#include "draw/sprite_batch.h"
 #include "game_events.h"
 #include "handle_game_events.h"
 #include "log.h"
@@ -79,12 +80,14 @@ static void DrawBackgroundWithRenderer(
 				"renderer does not support render to texture");
 		}
 	}
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderTarget(wc->renderer, target) != 0)
 	{
 		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
 	}
 	wc->bkgMask = ColorTint(colorWhite, tint);
 	DrawBackground(g, src, buffer, &gMap, pos, args);
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderTarget(wc->renderer, NULL) != 0)
 	{
 		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
@@ -103,6 +106,10 @@ static void DrawBackground(
 
 void GrafxRedrawBackground(GraphicsDevice *g, const struct vec2 pos)
 {
+	if (g->IsHeadless)
+	{
+		return;
+	}
 	memset(g->buf, 0, GraphicsGetMemSize(&g->cachedConfig));
 	DrawBuffer buffer;
 	DrawBufferInit(&buffer, svec2i(X_TILES, Y_TILES), g);
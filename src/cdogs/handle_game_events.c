@@ -31,7 +31,9 @@
 #include "actor_placement.h"
 #include "actors.h"
 #include "ai_utils.h"
+#include "automap.h"
 #include "damage.h"
+#include "draw/floor_cache.h"
 #include "events.h"
 #include "game_events.h"
 #include "joystick.h"
@@ -95,6 +97,8 @@ static void HandleGameEvent(
 			t->Door.Class = doorClass;
 			t->Door.Class2 = doorClass2;
 			DoorStateInit(&t->Door, false);
+			FloorCacheMarkTileDirty(&gFloorCache, &gMap, pos);
+			AutomapCacheMarkTileDirty(&gAutomapCache, pos);
 			pos.x++;
 			if (pos.x == gMap.Size.x)
 			{
@@ -201,7 +205,7 @@ static void HandleGameEvent(
 		break;
 	case GAME_EVENT_ACTOR_STATE: {
 		TActor *a = ActorGetByUID(e.u.ActorState.UID);
-		if (!a->isInUse)
+		if (a == NULL || !a->isInUse)
 			break;
 		a->anim =
 			AnimationGetActorAnimation((ActorAnimation)e.u.ActorState.State);
@@ -209,7 +213,7 @@ static void HandleGameEvent(
 	break;
 	case GAME_EVENT_ACTOR_DIR: {
 		TActor *a = ActorGetByUID(e.u.ActorDir.UID);
-		if (!a->isInUse)
+		if (a == NULL || !a->isInUse)
 			break;
 		a->direction = (direction_e)e.u.ActorDir.Dir;
 	}
@@ -429,7 +433,7 @@ static void HandleGameEvent(
 	break;
 	case GAME_EVENT_GUN_STATE: {
 		TActor *a = ActorGetByUID(e.u.GunState.ActorUID);
-		if (!a->isInUse)
+		if (a == NULL || !a->isInUse)
 			break;
 		WeaponBarrelSetState(
 			ACTOR_GET_WEAPON(a), e.u.GunState.Barrel,
@@ -28,6 +28,7 @@
 */
 #include "fps.h"
 
+#include "draw/sprite_batch.h"
 #include "font.h"
 #include "grafx.h"
 
@@ -50,9 +51,11 @@ void FPSCounterUpdate(FPSCounter *counter, int ms)
 }
 void FPSCounterDraw(FPSCounter *counter)
 {
-	char s[50];
+	char s[100];
 	counter->framesDrawn++;
-	sprintf(s, "FPS: %d", counter->fps);
+	sprintf(
+		s, "FPS: %d\nDraw calls: %d (%d sprites)", counter->fps,
+		gSpriteBatch.FrameDrawCalls, gSpriteBatch.FrameSprites);
 
 	FontOpts opts = FontOptsNew();
 	opts.HAlign = ALIGN_END;
@@ -39,10 +39,12 @@
 #include "font.h"
 #include "game_events.h"
 #include "hud_defs.h"
+#include "hud_layer.h"
 #include "mission.h"
 #include "pic_manager.h"
 #include "player.h"
 #include "player_hud.h"
+#include "profiler_hud.h"
 
 void HUDInit(HUD *hud, GraphicsDevice *device, struct MissionOptions *mission)
 {
@@ -52,6 +54,7 @@ void HUDInit(HUD *hud, GraphicsDevice *device, struct MissionOptions *mission)
 	hud->messageTicks = 0;
 	hud->device = device;
 	FPSCounterInit(&hud->fpsCounter);
+	NetStatsHUDInit(&hud->netStats);
 	WallClockInit(&hud->clock);
 	HUDNumPopupsInit(&hud->numPopups, mission);
 	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++)
@@ -82,6 +85,7 @@ void HUDUpdate(HUD *hud, const int ms)
 		}
 	}
 	FPSCounterUpdate(&hud->fpsCounter, ms);
+	NetStatsHUDUpdate(&hud->netStats, ms);
 	WallClockUpdate(&hud->clock, ms);
 	HUDPopupsUpdate(&hud->numPopups, ms);
 
@@ -119,19 +123,24 @@ static void DrawSharedRadar(GraphicsDevice *device, bool showExit)
 }
 
 static void DrawPlayerAreas(HUD *hud, const int numViews);
-static void DrawDeathmatchScores(HUD *hud);
+static uint64_t GetPanelsKey(const HUD *hud);
+static void DrawPanels(void *data);
 static void DrawMissionState(HUD *hud);
 static void DrawHUDMessage(HUD *hud);
-static void DrawKeycards(HUD *hud);
-static void DrawMissionTime(HUD *hud);
-static void DrawObjectiveCounts(HUD *hud);
+static void DrawObjectivePopups(HUD *hud);
 void HUDDraw(HUD *hud, const int numViews, const bool paused)
 {
 	if (ConfigGetBool(&gConfig, "Graphics.ShowHUD"))
 	{
 		DrawPlayerAreas(hud, numViews);
 
-		DrawDeathmatchScores(hud);
+		HUDLayerDraw(
+			&gHUDLayer, hud->device->gameWindow.renderer,
+			hud->device->cachedConfig.Res, GetPanelsKey(hud), DrawPanels, hud);
+		if (HasObjectives(gCampaign.Entry.Mode))
+		{
+			DrawObjectivePopups(hud);
+		}
 		DrawHUDMessage(hud);
 		if (ConfigGetBool(&gConfig, "Interface.ShowFPS"))
 		{
@@ -141,11 +150,13 @@ void HUDDraw(HUD *hud, const int numViews, const bool paused)
 		{
 			WallClockDraw(&hud->clock);
 		}
-		DrawKeycards(hud);
-		DrawMissionTime(hud);
-		if (HasObjectives(gCampaign.Entry.Mode))
+		if (ConfigGetBool(&gConfig, "Interface.ShowProfiler"))
 		{
-			DrawObjectiveCounts(hud);
+			ProfilerHUDDraw(&gProfiler);
+		}
+		if (ConfigGetBool(&gConfig, "Interface.ShowNetStats"))
+		{
+			NetStatsHUDDraw(&hud->netStats);
 		}
 	}
 
@@ -228,12 +239,65 @@ static void DrawPlayerAreas(HUD *hud, const int numViews)
 	}
 }
 
-static void DrawDeathmatchScores(HUD *hud)
+// Panels drawn into the retained HUD layer; the key must cover everything
+// they draw, so that they are redrawn when any of it changes
+static bool ShowDeathmatchScores(const HUD *hud);
+static uint64_t GetPanelsKey(const HUD *hud)
+{
+	uint64_t h = HASH64_INIT;
+	h = Hash64(h, &hud->mission, sizeof hud->mission);
+	h = Hash64(
+		h, &hud->mission->missionData, sizeof hud->mission->missionData);
+	const bool showScores = ShowDeathmatchScores(hud);
+	h = Hash64(h, &showScores, sizeof showScores);
+	if (showScores)
+	{
+		CA_FOREACH(const PlayerData, p, gPlayerDatas)
+		h = Hash64Str(h, p->name);
+		h = Hash64(h, &p->Lives, sizeof p->Lives);
+		h = Hash64(h, &p->Stats.Kills, sizeof p->Stats.Kills);
+		CA_FOREACH_END()
+	}
+	h = Hash64(h, &hud->mission->KeyFlags, sizeof hud->mission->KeyFlags);
+	// Mission time is only shown to the second
+	const int missionTimeSeconds = gMission.time / FPS_FRAMELIMIT;
+	h = Hash64(h, &missionTimeSeconds, sizeof missionTimeSeconds);
+	if (HasObjectives(gCampaign.Entry.Mode))
+	{
+		CA_FOREACH(const Objective, o, hud->mission->missionData->Objectives)
+		h = Hash64(h, &o->Required, sizeof o->Required);
+		h = Hash64(h, &o->done, sizeof o->done);
+		h = Hash64(h, &o->Flags, sizeof o->Flags);
+		CA_FOREACH_END()
+	}
+	return h;
+}
+static void DrawDeathmatchScores(HUD *hud);
+static void DrawKeycards(HUD *hud);
+static void DrawMissionTime(HUD *hud);
+static void DrawObjectiveCounts(HUD *hud);
+static void DrawPanels(void *data)
+{
+	HUD *hud = data;
+	DrawDeathmatchScores(hud);
+	DrawKeycards(hud);
+	DrawMissionTime(hud);
+	if (HasObjectives(gCampaign.Entry.Mode))
+	{
+		DrawObjectiveCounts(hud);
+	}
+}
+
+static bool ShowDeathmatchScores(const HUD *hud)
 {
 	// Only draw deathmatch scores if single screen and non-local players exist
-	if (gCampaign.Entry.Mode != GAME_MODE_DEATHMATCH ||
-		hud->DrawData.NumScreens != 1 ||
-		GetNumPlayers(PLAYER_ANY, false, false) <= 1)
+	return gCampaign.Entry.Mode == GAME_MODE_DEATHMATCH &&
+		   hud->DrawData.NumScreens == 1 &&
+		   GetNumPlayers(PLAYER_ANY, false, false) > 1;
+}
+static void DrawDeathmatchScores(HUD *hud)
+{
+	if (!ShowDeathmatchScores(hud))
 	{
 		return;
 	}
@@ -377,6 +441,7 @@ static void DrawMissionTime(HUD *hud)
 	FontStrOpt(s, svec2i_zero(), opts);
 }
 
+static void GetObjectiveCountStr(char *s, const Objective *o);
 static void DrawObjectiveCounts(HUD *hud)
 {
 	int x = 45;
@@ -394,6 +459,32 @@ static void DrawObjectiveCounts(HUD *hud)
 
 	x += 5;
 	char s[32];
+	GetObjectiveCountStr(s, o);
+	FontStr(s, svec2i(x, y));
+
+	x += 40;
+	CA_FOREACH_END()
+}
+// Popups animate, so they are drawn every frame over the objective counts
+static void DrawObjectivePopups(HUD *hud)
+{
+	int x = 45;
+	int y = hud->device->cachedConfig.Res.y - 22;
+	CA_FOREACH(const Objective, o, hud->mission->missionData->Objectives)
+	if (!ObjectiveIsRequired(o))
+	{
+		continue;
+	}
+	x += 5;
+	char s[32];
+	GetObjectiveCountStr(s, o);
+	HUDNumPopupsDrawObjective(
+		&hud->numPopups, _ca_index, svec2i(x + FontStrW(s) - 8, y));
+	x += 40;
+	CA_FOREACH_END()
+}
+static void GetObjectiveCountStr(char *s, const Objective *o)
+{
 	const int itemsLeft = o->Required - o->done;
 	if (itemsLeft > 0)
 	{
@@ -410,11 +501,4 @@ static void DrawObjectiveCounts(HUD *hud)
 	{
 		strcpy(s, "Done");
 	}
-	FontStr(s, svec2i(x, y));
-
-	HUDNumPopupsDrawObjective(
-		&hud->numPopups, _ca_index, svec2i(x + FontStrW(s) - 8, y));
-
-	x += 40;
-	CA_FOREACH_END()
 }
@@ -33,6 +33,7 @@
 #include "gamedata.h"
 #include "health_gauge.h"
 #include "hud_num_popup.h"
+#include "net_stats_hud.h"
 #include "player.h"
 #include "wall_clock.h"
 #include "weapon_class.h"
@@ -60,6 +61,7 @@ typedef struct
 	int messageTicks;
 	GraphicsDevice *device;
 	FPSCounter fpsCounter;
+	NetStatsHUD netStats;
 	WallClock clock;
 	HUDNumPopups numPopups;
 	HUDPlayer hudPlayers[MAX_LOCAL_PLAYERS];
@@ -0,0 +1,156 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "hud_layer.h"
+
+#include <string.h>
+
+#include "draw/sprite_batch.h"
+#include "grafx.h"
+#include "log.h"
+#include "texture.h"
+
+HUDLayer gHUDLayer;
+
+
+void HUDLayerInit(HUDLayer *l)
+{
+	memset(l, 0, sizeof *l);
+}
+void HUDLayerTerminate(HUDLayer *l)
+{
+	HUDLayerClear(l);
+}
+
+void HUDLayerClear(HUDLayer *l)
+{
+	SpriteBatchFlush(&gSpriteBatch);
+	if (l->Tex != NULL)
+	{
+		SDL_DestroyTexture(l->Tex);
+		l->Tex = NULL;
+	}
+	l->Renderer = NULL;
+	l->Size = svec2i_zero();
+	l->Drawn = false;
+}
+
+static bool SetRenderer(HUDLayer *l, SDL_Renderer *r);
+static bool Redraw(
+	HUDLayer *l, SDL_Renderer *r, HUDLayerDrawFunc draw, void *data);
+void HUDLayerDraw(
+	HUDLayer *l, SDL_Renderer *r, const struct vec2i size,
+	const uint64_t key, HUDLayerDrawFunc draw, void *data)
+{
+	if (r == NULL || !SetRenderer(l, r))
+	{
+		draw(data);
+		return;
+	}
+	if (!svec2i_is_equal(size, l->Size))
+	{
+		HUDLayerClear(l);
+		l->Renderer = r;
+		l->Size = size;
+	}
+	if (l->Tex == NULL)
+	{
+		l->Tex = TextureCreate(
+			r, SDL_TEXTUREACCESS_TARGET, size, SDL_BLENDMODE_BLEND, 255);
+		if (l->Tex == NULL)
+		{
+			draw(data);
+			return;
+		}
+	}
+	if (!l->Drawn || key != l->Key)
+	{
+		if (!Redraw(l, r, draw, data))
+		{
+			draw(data);
+			return;
+		}
+		l->Key = key;
+		l->Drawn = true;
+	}
+	const Rect2i rect = Rect2iNew(svec2i_zero(), l->Size);
+	TextureRender(l->Tex, r, rect, rect, colorWhite, 0, SDL_FLIP_NONE);
+}
+static bool SetRenderer(HUDLayer *l, SDL_Renderer *r)
+{
+	if (r == l->Renderer)
+	{
+		return l->Supported;
+	}
+	HUDLayerClear(l);
+	l->Renderer = r;
+	SDL_RendererInfo ri;
+	if (SDL_GetRendererInfo(r, &ri) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot get renderer info: %s", SDL_GetError());
+		l->Supported = false;
+	}
+	else
+	{
+		l->Supported = !!(ri.flags & SDL_RENDERER_TARGETTEXTURE);
+	}
+	if (!l->Supported)
+	{
+		LOG(LM_GFX, LL_WARN,
+			"renderer does not support render to texture; "
+			"HUD panels will be drawn every frame");
+	}
+	return l->Supported;
+}
+static bool Redraw(
+	HUDLayer *l, SDL_Renderer *r, HUDLayerDrawFunc draw, void *data)
+{
+	SpriteBatchFlush(&gSpriteBatch);
+	SDL_Texture *target = SDL_GetRenderTarget(r);
+	const Rect2i clip = GraphicsGetClip(r);
+	if (SDL_SetRenderTarget(r, l->Tex) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
+		return false;
+	}
+	if (SDL_SetRenderDrawColor(r, 0, 0, 0, 0) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to set draw color: %s", SDL_GetError());
+	}
+	if (SDL_RenderClear(r) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to clear HUD layer: %s", SDL_GetError());
+	}
+	draw(data);
+	SpriteBatchFlush(&gSpriteBatch);
+	if (SDL_SetRenderTarget(r, target) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
+	}
+	GraphicsSetClip(r, clip);
+	return true;
+}
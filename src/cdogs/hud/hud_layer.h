@@ -0,0 +1,61 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <SDL.h>
+
+#include "vector.h"
+
+// HUD panels that only change now and then (scores, keys, objective counts,
+// the mission time) are drawn into a retained layer texture. The panels are
+// only redrawn when the hash of their inputs changes, and each frame the
+// layer is drawn as one quad.
+typedef struct
+{
+	SDL_Renderer *Renderer;
+	bool Supported;
+	SDL_Texture *Tex;
+	struct vec2i Size;
+	// Hash of the inputs of the panels in Tex
+	uint64_t Key;
+	bool Drawn;
+} HUDLayer;
+
+extern HUDLayer gHUDLayer;
+
+typedef void (*HUDLayerDrawFunc)(void *data);
+
+void HUDLayerInit(HUDLayer *l);
+void HUDLayerTerminate(HUDLayer *l);
+// Free the texture; done before the renderer is destroyed
+void HUDLayerClear(HUDLayer *l);
+// Draw the layer, first redrawing its panels with draw if the key changed.
+// Without render targets, the panels are drawn directly every time.
+void HUDLayerDraw(
+	HUDLayer *l, SDL_Renderer *r, const struct vec2i size,
+	const uint64_t key, HUDLayerDrawFunc draw, void *data);
@@ -0,0 +1,126 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "net_stats_hud.h"
+
+#include <stdio.h>
+
+#include "font.h"
+#include "grafx.h"
+#include "net_client.h"
+#include "net_server.h"
+
+
+void NetStatsHUDInit(NetStatsHUD *h)
+{
+	memset(h, 0, sizeof *h);
+}
+
+static void GetTotals(uint32_t *in, uint32_t *out);
+void NetStatsHUDUpdate(NetStatsHUD *h, const int ms)
+{
+	h->elapsed += ms;
+	if (h->elapsed < 1000)
+	{
+		return;
+	}
+	uint32_t in, out;
+	GetTotals(&in, &out);
+	// Totals restart on reconnect
+	h->inRate = in >= h->lastIn ? (int)(in - h->lastIn) : 0;
+	h->outRate = out >= h->lastOut ? (int)(out - h->lastOut) : 0;
+	h->lastIn = in;
+	h->lastOut = out;
+	h->elapsed -= 1000;
+}
+static void GetTotals(uint32_t *in, uint32_t *out)
+{
+	*in = *out = 0;
+	if (NetClientIsConnected(&gNetClient))
+	{
+		*in = NetStatsTotal(gNetClient.Stats.In).Bytes;
+		*out = NetStatsTotal(gNetClient.Stats.Out).Bytes;
+		return;
+	}
+	if (gNetServer.server == NULL)
+	{
+		return;
+	}
+	for (int i = 0; i < (int)gNetServer.server->peerCount; i++)
+	{
+		const ENetPeer *peer = gNetServer.server->peers + i;
+		if (peer->data == NULL)
+		{
+			continue;
+		}
+		const NetPeerData *pd = peer->data;
+		*in += NetStatsTotal(pd->Stats.In).Bytes;
+		*out += NetStatsTotal(pd->Stats.Out).Bytes;
+	}
+}
+
+static char *PrintPeer(char *c, const char *name, const ENetPeer *peer);
+void NetStatsHUDDraw(const NetStatsHUD *h)
+{
+	char s[(NET_SERVER_MAX_CLIENTS + 1) * 64];
+	char *c = s;
+	c += sprintf(
+		c, "in: %.1fkB/s out: %.1fkB/s\n", h->inRate / 1024.0f,
+		h->outRate / 1024.0f);
+	if (NetClientIsConnected(&gNetClient))
+	{
+		c = PrintPeer(c, "server", gNetClient.peer);
+	}
+	else if (gNetServer.server != NULL)
+	{
+		for (int i = 0; i < (int)gNetServer.server->peerCount; i++)
+		{
+			const ENetPeer *peer = gNetServer.server->peers + i;
+			if (peer->state != ENET_PEER_STATE_CONNECTED || peer->data == NULL)
+			{
+				continue;
+			}
+			char name[32];
+			sprintf(name, "peer %d", ((const NetPeerData *)peer->data)->Id);
+			c = PrintPeer(c, name, peer);
+		}
+	}
+
+	FontOpts opts = FontOptsNew();
+	opts.HAlign = ALIGN_END;
+	opts.VAlign = ALIGN_END;
+	opts.Area = gGraphicsDevice.cachedConfig.Res;
+	opts.Pad = svec2i(10, 34);
+	FontStrOpt(s, svec2i_zero(), opts);
+}
+static char *PrintPeer(char *c, const char *name, const ENetPeer *peer)
+{
+	const NetPeerStats ps = NetPeerStatsGet(peer);
+	return c + sprintf(
+				   c, "%s: rtt %ums loss %.1f%% resent %u\n", name, ps.RTT,
+				   ps.Loss * 100, ps.Retransmits);
+}
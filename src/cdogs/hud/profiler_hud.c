@@ -0,0 +1,53 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "profiler_hud.h"
+
+#include <stdio.h>
+
+#include "font.h"
+#include "grafx.h"
+
+
+void ProfilerHUDDraw(const Profiler *p)
+{
+	char s[PROFILE_COUNT * 32];
+	char *c = s;
+	for (ProfilePhase phase = 0; phase < PROFILE_COUNT; phase++)
+	{
+		c += sprintf(
+			c, "%s: %.2fms\n", ProfilePhaseStr(phase),
+			ProfilerGetAverage(p, phase));
+	}
+
+	FontOpts opts = FontOptsNew();
+	opts.HAlign = ALIGN_END;
+	opts.VAlign = ALIGN_CENTER;
+	opts.Area = gGraphicsDevice.cachedConfig.Res;
+	opts.Pad = svec2i(10, 0);
+	FontStrOpt(s, svec2i_zero(), opts);
+}
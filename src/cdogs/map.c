@@ -55,9 +55,11 @@
 #include "actors.h"
 #include "algorithms.h"
 #include "ammo.h"
+#include "automap.h"
 #include "collision/collision.h"
 #include "config.h"
 #include "door.h"
+#include "draw/floor_cache.h"
 #include "game_events.h"
 #include "gamedata.h"
 #include "log.h"
@@ -167,9 +169,13 @@ bool MapTryMoveThing(Map *map, Thing *t, const struct vec2 pos)
 	{
 		return false;
 	}
-	t->LastPos = t->Pos;
 	// When first initialised, position is -1
 	const bool doRemove = t->Pos.x >= 0 && t->Pos.y >= 0;
+	if (!doRemove)
+	{
+		// Don't interpolate from the uninitialised position
+		t->LastPos = pos;
+	}
 	const struct vec2i t1 = Vec2ToTile(t->Pos);
 	const struct vec2i t2 = Vec2ToTile(pos);
 	// If we'll be in the same tile, do nothing
@@ -518,6 +524,8 @@ void MapInit(Map *map, const struct vec2i size)
 	CArrayInit(&map->triggers, sizeof(Trigger *));
 	CArrayInit(&map->exits, sizeof(Exit));
 	PathCacheInit(&gPathCache, map);
+	FloorCacheReset(&gFloorCache, map);
+	AutomapCacheReset(&gAutomapCache, map);
 
 	struct vec2i v;
 	for (v.y = 0; v.y < map->Size.y; v.y++)
@@ -658,6 +666,10 @@ void MapMarkAsVisited(Map *map, struct vec2i pos)
 	{
 		map->tilesSeen++;
 	}
+	if (!t->isVisited)
+	{
+		AutomapCacheMarkTileDirty(&gAutomapCache, pos);
+	}
 	t->isVisited = true;
 }
 
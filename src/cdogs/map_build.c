@@ -49,8 +49,10 @@
 #include "map_build.h"
 
 #include "actors.h"
+#include "automap.h"
 #include "collision/collision.h"
 #include "door.h"
+#include "draw/floor_cache.h"
 #include "log.h"
 #include "map_cave.h"
 #include "map_classic.h"
@@ -734,6 +736,8 @@ static void MapSetupTile(MapBuilder *mb, const struct vec2i pos)
 		CASSERT(false, "cannot setup tile");
 		t->Class = &gTileNothing;
 	}
+	FloorCacheMarkTileDirty(&gFloorCache, mb->Map, pos);
+	AutomapCacheMarkTileDirty(&gAutomapCache, pos);
 }
 static bool W(const MapBuilder *mb, const int x, const int y);
 static const char *MapGetWallPic(const MapBuilder *m, const struct vec2i pos)
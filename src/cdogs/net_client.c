@@ -46,7 +46,6 @@ NetClient gNetClient;
 
 
 #define CONNECTION_WAIT_MS 5000
-#define FIND_CONNECTION_WAIT_SECONDS 1
 #define TIMEOUT_MS 5000
 
 
@@ -56,7 +55,7 @@ void NetClientInit(NetClient *n, const uint16_t port)
 	n->ClientId = -1;	// -1 is unset
 	n->scanner = ENET_SOCKET_NULL;
 	n->port = port;
-	n->client = enet_host_create(NULL, 1, 2,
+	n->client = enet_host_create(NULL, 1, NET_CHANNEL_COUNT,
 		57600 / 8 /* 56K modem with 56 Kbps downstream bandwidth */,
 		14400 / 8 /* 56K modem with 14 Kbps upstream bandwidth */);
 	if (n->client == NULL)
@@ -64,7 +63,10 @@ void NetClientInit(NetClient *n, const uint16_t port)
 		LOG(LM_NET, LL_ERROR, "cannot create ENet client host");
 	}
 	CArrayInit(&n->ScannedAddrs, sizeof(ScanInfo));
-	CArrayInit(&n->scannedAddrBuf, sizeof(ScanInfo));
+	NetSnapshotHistoryInit(&n->Snapshots);
+	NetWorldTransferInit(&n->World);
+	CArrayInit(&n->Reliable, sizeof(ENetPacket *));
+	NetShimInit(&n->Shim);
 }
 void NetClientTerminate(NetClient *n)
 {
@@ -83,31 +85,31 @@ void NetClientTerminate(NetClient *n)
 		n->scanner = ENET_SOCKET_NULL;
 	}
 	CArrayTerminate(&n->ScannedAddrs);
-	CArrayTerminate(&n->scannedAddrBuf);
+	NetSnapshotHistoryTerminate(&n->Snapshots);
+	NetWorldTransferTerminate(&n->World);
+	CArrayTerminate(&n->Reliable);
+	NetShimTerminate(&n->Shim);
 }
 
 static bool TryScanHost(NetClient *n, const enet_uint32 host);
 void NetClientFindLANServers(NetClient *n)
 {
 	// If we've already begun scanning, wait for that to finish
-	if (n->ScanTicks > 0)
+	if (n->Scanning)
 	{
 		return;
 	}
-	
-	// Replace the scanned addresses with the buffer
-	CArray temp = n->ScannedAddrs;
-	n->ScannedAddrs = n->scannedAddrBuf;
-	n->scannedAddrBuf = temp;
-	CArrayClear(&n->scannedAddrBuf);
-
 	// Scan for servers on LAN using broadcast host
 	if (!TryScanHost(n, ENET_HOST_BROADCAST))
 	{
 		return;
 	}
-
-	n->ScanTicks = FIND_CONNECTION_WAIT_SECONDS * FPS_FRAMELIMIT;
+	n->ScanTime = enet_time_get();
+	n->Scanning = true;
+}
+bool NetClientIsScanning(const NetClient *n)
+{
+	return n->Scanning;
 }
 static bool TryScanHost(NetClient *n, const enet_uint32 host)
 {
@@ -125,17 +127,26 @@ static bool TryScanHost(NetClient *n, const enet_uint32 host)
 			LOG(LM_NET, LL_ERROR, "Failed to enable broadcast socket");
 			goto bail;
 		}
+		// Replies are collected without blocking the client
+		if (enet_socket_set_option(n->scanner, ENET_SOCKOPT_NONBLOCK, 1) != 0)
+		{
+			LOG(LM_NET, LL_ERROR, "Failed to set non-blocking socket");
+			goto bail;
+		}
 	}
 
 	// Send the scanning message
 	ENetAddress addr;
 	addr.host = host;
 	addr.port = n->port;
-	// Send a dummy payload
-	char data = 42;
+	// Servers echo the time back, so we can tell the ping of each reply
+	NetDiscoverQuery q;
+	q.MsgId = NET_MSG_DISCOVER;
+	q.ProtocolVersion = NET_PROTOCOL_VERSION;
+	q.Time = enet_time_get();
 	ENetBuffer sendbuf;
-	sendbuf.data = &data;
-	sendbuf.dataLength = 1;
+	sendbuf.data = &q;
+	sendbuf.dataLength = sizeof q;
 	if (enet_socket_send(n->scanner, &addr, &sendbuf, 1) !=
 		(int)sendbuf.dataLength)
 	{
@@ -151,6 +162,8 @@ bail:
 	return false;
 }
 
+static int HostService(
+	NetClient *n, ENetEvent *event, const enet_uint32 timeoutMs);
 bool NetClientTryConnect(NetClient *n, const ENetAddress addr)
 {
 	NetClientDisconnect(n);
@@ -159,8 +172,20 @@ bool NetClientTryConnect(NetClient *n, const ENetAddress addr)
 	enet_address_get_host_ip(&addr, buf, sizeof buf);
 	LOG(LM_NET, LL_INFO, "Connecting client to %s:%u...", buf, addr.port);
 
-	/* Initiate the connection, allocating the two channels 0 and 1. */
-	n->peer = enet_host_connect(n->client, &addr, 2, 0);
+	NetStatsInit(&n->Stats);
+	ENetAddress connectAddr = addr;
+	if (gNetShimOptions.Enabled)
+	{
+		// Connect through the shim instead
+		if (!NetShimOpen(&n->Shim, &gNetShimOptions, addr))
+		{
+			goto bail;
+		}
+		connectAddr = n->Shim.Address;
+	}
+
+	/* Initiate the connection, allocating a channel for each NetChannel. */
+	n->peer = enet_host_connect(n->client, &connectAddr, NET_CHANNEL_COUNT, 0);
 	if (n->peer == NULL)
 	{
 		LOG(LM_NET, LL_WARN, "No server connection found");
@@ -169,7 +194,7 @@ bool NetClientTryConnect(NetClient *n, const ENetAddress addr)
 
 	/* Wait milliseconds for the connection attempt to succeed. */
 	ENetEvent event;
-	if (enet_host_service(n->client, &event, CONNECTION_WAIT_MS) > 0 &&
+	if (HostService(n, &event, CONNECTION_WAIT_MS) > 0 &&
 		event.type == ENET_EVENT_TYPE_CONNECT)
 	{
 		fprintf(stderr, "Connected.\n");
@@ -195,6 +220,25 @@ bail:
 	NetClientDisconnect(n);
 	return false;
 }
+// Service the host, while relaying through the shim if it's open
+static int HostService(
+	NetClient *n, ENetEvent *event, const enet_uint32 timeoutMs)
+{
+	if (!NetShimIsOpen(&n->Shim))
+	{
+		return enet_host_service(n->client, event, timeoutMs);
+	}
+	const enet_uint32 start = enet_time_get();
+	for (;;)
+	{
+		NetShimUpdate(&n->Shim);
+		const int result = enet_host_service(n->client, event, 1);
+		if (result != 0 || enet_time_get() - start >= timeoutMs)
+		{
+			return result;
+		}
+	}
+}
 
 static bool TryRecvScanForServerPort(
 	NetClient *n, const int timeoutMs,
@@ -262,21 +306,37 @@ static bool TryRecvScanForServerPort(
 	return true;
 }
 
+static void ResetPrediction(NetClient *n)
+{
+	n->Tick = 0;
+	n->InputSeq = 0;
+	memset(n->InputTicks, 0, sizeof n->InputTicks);
+	memset(n->Predictions, 0, sizeof n->Predictions);
+	n->PredictionIndex = 0;
+	n->ServerTick = 0;
+	n->LatestSnapshotTick = 0;
+}
+
 void NetClientDisconnect(NetClient *n)
 {
 	if (n->peer)
 	{
 		LOG(LM_NET, LL_INFO, "disconnecting peer");
+		NetStatsLog(&n->Stats, n->peer, "client");
 		enet_peer_disconnect_now(n->peer, 0);
 		n->peer = NULL;
 	}
+	NetShimClose(&n->Shim);
 	// Reset IDs so that when we start a server, we use our own IDs
 	n->ClientId = -1;
 	n->FirstPlayerUID = 0;
 	n->Ready = false;
-	// Also reset the scanned address buffer
-	CArrayClear(&n->ScannedAddrs);
-	CArrayClear(&n->scannedAddrBuf);
+	ResetPrediction(n);
+	NetWorldTransferReset(&n->World);
+	CA_FOREACH(ENetPacket *, packet, n->Reliable)
+	enet_packet_destroy(*packet);
+	CA_FOREACH_END()
+	CArrayClear(&n->Reliable);
 }
 
 static void OnReceive(NetClient *n, ENetEvent event);
@@ -292,6 +352,7 @@ void NetClientPoll(NetClient *n)
 	}
 
 	// Service the connection
+	NetShimUpdate(&n->Shim);
 	int check;
 	do
 	{
@@ -324,58 +385,137 @@ void NetClientPoll(NetClient *n)
 }
 static void Scanning(NetClient *n)
 {
-	// If it's been too long, stop scanning
-	if (n->ScanTicks <= 0)
+	if (n->scanner == ENET_SOCKET_NULL)
 	{
 		return;
 	}
-	n->ScanTicks--;
+	const enet_uint32 now = enet_time_get();
 
-	// Check to see if we have received the scan reply
-	ScanInfo sinfo;
-	while (TryRecvScanForServerPort(n, 0, &sinfo.ServerInfo, &sinfo.Addr))
+	// Collect all the replies that have arrived
+	for (int i = 0; i < NET_DISCOVERY_MAX_PER_POLL; i++)
 	{
-		// Check if we've seen this scan before
-		// This can happen occasionally, especially if the network is flaky
+		ENetSocketSet set;
+		ENET_SOCKETSET_EMPTY(set);
+		ENET_SOCKETSET_ADD(set, n->scanner);
+		if (enet_socketset_select(n->scanner, &set, NULL, 0) <= 0)
+		{
+			break;
+		}
+		ScanInfo sinfo;
+		if (!TryRecvScanForServerPort(
+				n, 0, &sinfo.ServerInfo, &sinfo.Addr))
+		{
+			// Skip replies we can't use, e.g. protocol mismatches
+			continue;
+		}
+		sinfo.LatencyMS = sinfo.ServerInfo.QueryTime != 0
+							  ? (int)(now - sinfo.ServerInfo.QueryTime)
+							  : 0;
+		sinfo.LastSeen = now;
+		// Update the server if we've seen it before
 		bool found = false;
-		CA_FOREACH(const ScanInfo, si, n->scannedAddrBuf)
-			if (si->Addr.host == sinfo.Addr.host &&
-				si->Addr.port == sinfo.Addr.port)
-			{
-				found = true;
-				break;
-			}
+		CA_FOREACH(ScanInfo, si, n->ScannedAddrs)
+		if (si->Addr.host == sinfo.Addr.host &&
+			si->Addr.port == sinfo.Addr.port)
+		{
+			*si = sinfo;
+			found = true;
+			break;
+		}
 		CA_FOREACH_END()
-		if (found)
+		if (!found)
 		{
-			continue;
+			CArrayPushBack(&n->ScannedAddrs, &sinfo);
 		}
+	}
 
-		// Save them into our buffer
-		// Calculate latency based on ticks
-		sinfo.LatencyMS =
-			(FIND_CONNECTION_WAIT_SECONDS * FPS_FRAMELIMIT - n->ScanTicks) *
-			1000 / FPS_FRAMELIMIT;
-		CArrayPushBack(&n->scannedAddrBuf, &sinfo);
-		// Also add them to the main collection, so we can find servers quickly
-		found = false;
-		CA_FOREACH(const ScanInfo, si, n->ScannedAddrs)
-			if (si->Addr.host == sinfo.Addr.host &&
-				si->Addr.port == sinfo.Addr.port)
+	if (n->Scanning && now - n->ScanTime >= NET_DISCOVERY_WAIT_MS)
+	{
+		n->Scanning = false;
+		// Forget servers that have gone quiet
+		for (int i = (int)n->ScannedAddrs.size - 1; i >= 0; i--)
+		{
+			const ScanInfo *si = CArrayGet(&n->ScannedAddrs, i);
+			if (now - si->LastSeen > NET_DISCOVERY_EXPIRE_MS)
+			{
+				CArrayDelete(&n->ScannedAddrs, i);
+			}
+		}
+	}
+}
+static void ProcessReliable(NetClient *n);
+static void OnReceivePacket(NetClient *n, ENetPacket *packet);
+static void OnReceive(NetClient *n, ENetEvent event)
+{
+	NetStatsCount(&n->Stats, false, event.packet);
+	switch (event.channelID)
+	{
+	case NET_CHANNEL_RELIABLE:
+		// Queue in case the messages need to wait for the world
+		CArrayPushBack(&n->Reliable, &event.packet);
+		break;
+	case NET_CHANNEL_WORLD:
+		NetWorldTransferAdd(&n->World, event.packet);
+		enet_packet_destroy(event.packet);
+		break;
+	default:
+		// State updates are out of date by the time the world arrives
+		if (!n->World.Active)
+		{
+			OnReceivePacket(n, event.packet);
+		}
+		enet_packet_destroy(event.packet);
+		break;
+	}
+	ProcessReliable(n);
+}
+static void OnReceiveMsg(ENetPacket *packet, void *data);
+static void ProcessReliable(NetClient *n)
+{
+	for (;;)
+	{
+		if (n->World.Started)
+		{
+			if (!NetWorldTransferIsComplete(&n->World))
 			{
-				found = true;
 				break;
 			}
-		CA_FOREACH_END()
-		if (!found)
+			NetWorldTransferUnpack(&n->World, OnReceiveMsg, n);
+		}
+		if (n->Reliable.size == 0)
 		{
-			CArrayPushBack(&n->ScannedAddrs, &sinfo);
+			break;
+		}
+		ENetPacket *packet = *(ENetPacket **)CArrayGet(&n->Reliable, 0);
+		CArrayDelete(&n->Reliable, 0);
+		if (*(uint32_t *)packet->data == NET_MSG_WORLD_START)
+		{
+			NetWorldTransferAdd(&n->World, packet);
 		}
+		else
+		{
+			OnReceivePacket(n, packet);
+		}
+		enet_packet_destroy(packet);
 	}
 }
-static void OnReceive(NetClient *n, ENetEvent event)
+static void OnReceivePacket(NetClient *n, ENetPacket *packet)
+{
+	if (!NetBatchUnpack(packet, OnReceiveMsg, n))
+	{
+		OnReceiveMsg(packet, n);
+	}
+}
+static void OnSnapshot(NetClient *n, const ENetPacket *packet);
+static void OnReceiveMsg(ENetPacket *packet, void *data)
 {
-	const GameEventType msg = (GameEventType)*(uint32_t *)event.packet->data;
+	NetClient *n = data;
+	if (*(uint32_t *)packet->data == NET_MSG_SNAPSHOT)
+	{
+		OnSnapshot(n, packet);
+		return;
+	}
+	const GameEventType msg = (GameEventType)*(uint32_t *)packet->data;
 	LOG(LM_NET, LL_TRACE, "recv msg(%u)", msg);
 	const GameEventEntry gee = GameEventGetEntry(msg);
 	if (gee.Enqueue)
@@ -392,7 +532,7 @@ static void OnReceive(NetClient *n, ENetEvent event)
 			GameEvent e = GameEventNew(gee.Type);
 			if (gee.Fields != NULL)
 			{
-				NetDecode(event.packet, &e.u, gee.Fields);
+				NetDecode(packet, &e.u, gee.Fields);
 			}
 
 			// For actor events, check if UID is not for local player
@@ -450,7 +590,7 @@ static void OnReceive(NetClient *n, ENetEvent event)
 					n->ClientId == -1,
 					"unexpected client ID message, already set");
 				NClientId cid;
-				NetDecode(event.packet, &cid, NClientId_fields);
+				NetDecode(packet, &cid, NClientId_fields);
 				LOG(LM_NET, LL_DEBUG, "recv clientId(%u) uid(%u)",
 					cid.Id, cid.FirstPlayerUID);
 				n->ClientId = (int)cid.Id;
@@ -466,7 +606,7 @@ static void OnReceive(NetClient *n, ENetEvent event)
 			{
 				LOG(LM_NET, LL_DEBUG, "NetClient: received campaign def, loading...");
 				NCampaignDef def;
-				NetDecode(event.packet, &def, NCampaignDef_fields);
+				NetDecode(packet, &def, NCampaignDef_fields);
 				gCampaign.Entry.Mode = (GameMode)def.GameMode;
 				// Normalise the path
 				char buf[CDOGS_PATH_MAX];
@@ -493,6 +633,7 @@ static void OnReceive(NetClient *n, ENetEvent event)
 			if (n->Ready)
 			{
 				gMission.HasStarted = true;
+				ResetPrediction(n);
 			}
 			break;
 		default:
@@ -500,13 +641,171 @@ static void OnReceive(NetClient *n, ENetEvent event)
 			break;
 		}
 	}
-	enet_packet_destroy(event.packet);
+}
+static void Reconcile(NetClient *n, const NetSnapshot *s);
+static void OnSnapshot(NetClient *n, const ENetPacket *packet)
+{
+	if (!gMission.HasStarted)
+	{
+		return;
+	}
+	const NetSnapshot *s = NetSnapshotHistoryRead(
+		&n->Snapshots, packet->data, packet->dataLength);
+	if (s == NULL)
+	{
+		// Wait for a snapshot against a baseline that we have
+		return;
+	}
+	LOG(LM_NET, LL_TRACE, "recv snapshot(%u) entities(%d)", s->Seq,
+		(int)s->Entities.size);
+
+	ENetPacket *ack =
+		NetPacketNew(NET_MSG_SIZE + sizeof s->Seq, NET_CHANNEL_STATE);
+	if (ack != NULL)
+	{
+		const uint32_t msgId = NET_MSG_SNAPSHOT_ACK;
+		memcpy(ack->data, &msgId, NET_MSG_SIZE);
+		memcpy(ack->data + NET_MSG_SIZE, &s->Seq, sizeof s->Seq);
+		NetSendPacket(n->peer, &n->Stats, NET_CHANNEL_STATE, ack);
+	}
+
+	// Catch up if snapshots are arriving sooner than expected
+	if (n->LatestSnapshotTick == 0 ||
+		(int32_t)(s->Tick - n->LatestSnapshotTick) > 0)
+	{
+		n->LatestSnapshotTick = s->Tick;
+	}
+	if ((int32_t)(n->LatestSnapshotTick - n->ServerTick) > 0)
+	{
+		n->ServerTick = n->LatestSnapshotTick;
+	}
+
+	Reconcile(n, s);
+	NetSnapshotApply(s);
+}
+static const NetPrediction *FindPrediction(
+	const NetClient *n, const uint32_t tick);
+static void Reconcile(NetClient *n, const NetSnapshot *s)
+{
+	// Find what we predicted for the moment the snapshot was taken; that is
+	// the tick our last move reached the server, plus the ticks since
+	if (s->InputSeq == 0 || n->InputSeq - s->InputSeq >= NET_PREDICTION_HISTORY)
+	{
+		return;
+	}
+	const uint32_t tick =
+		n->InputTicks[s->InputSeq % NET_PREDICTION_HISTORY] + s->InputTicks;
+	const NetPrediction *p = FindPrediction(n, tick);
+	if (p == NULL)
+	{
+		return;
+	}
+	for (int i = 0; i < p->Count; i++)
+	{
+		const NetSnapshotEntity *e =
+			NetSnapshotFind(s, SNAPSHOT_ACTOR, p->UIDs[i]);
+		TActor *a = ActorGetByUID(p->UIDs[i]);
+		if (e == NULL || a == NULL || !a->isInUse)
+		{
+			continue;
+		}
+		const struct vec2 err =
+			svec2_subtract(NetSnapshotEntityPos(e), p->Pos[i]);
+		if (svec2_length(err) <= NET_RECONCILE_THRESHOLD)
+		{
+			continue;
+		}
+		LOG(LM_NET, LL_DEBUG, "reconcile actor(%d) error(%f, %f)", a->uid,
+			err.x, err.y);
+		// Keep the moves made since, applied on top of the server position
+		NActorMove am = NActorMove_init_default;
+		am.UID = a->uid;
+		am.has_Pos = am.has_MoveVel = true;
+		am.Pos = Vec2ToNet(svec2_add(a->Pos, err));
+		am.MoveVel = Vec2ToNet(a->MoveVel);
+		ActorMove(am);
+		// Later predictions are off by the same amount; correct them so
+		// that snapshots already in flight don't correct us again
+		for (int j = 0; j < NET_PREDICTION_HISTORY; j++)
+		{
+			NetPrediction *later = &n->Predictions[j];
+			if ((int32_t)(later->Tick - p->Tick) < 0)
+			{
+				continue;
+			}
+			for (int k = 0; k < later->Count; k++)
+			{
+				if (later->UIDs[k] == a->uid)
+				{
+					later->Pos[k] = svec2_add(later->Pos[k], err);
+				}
+			}
+		}
+	}
+}
+static const NetPrediction *FindPrediction(
+	const NetClient *n, const uint32_t tick)
+{
+	// Latest prediction at or before the tick
+	const NetPrediction *found = NULL;
+	for (int i = 0; i < NET_PREDICTION_HISTORY; i++)
+	{
+		const NetPrediction *p = &n->Predictions[i];
+		if (p->Tick == 0 || (int32_t)(p->Tick - tick) > 0)
+		{
+			continue;
+		}
+		if (found == NULL || (int32_t)(p->Tick - found->Tick) > 0)
+		{
+			found = p;
+		}
+	}
+	return found;
+}
+
+void NetClientUpdate(NetClient *n, const int ticks)
+{
+	if (!NetClientIsConnected(n) || !gMission.HasStarted)
+	{
+		return;
+	}
+	n->Tick += ticks;
+
+	NetPrediction *p = &n->Predictions[n->PredictionIndex];
+	n->PredictionIndex = (n->PredictionIndex + 1) % NET_PREDICTION_HISTORY;
+	p->Tick = n->Tick;
+	p->Count = 0;
+	CA_FOREACH(const PlayerData, pd, gPlayerDatas)
+	if (!pd->IsLocal || p->Count == MAX_LOCAL_PLAYERS)
+	{
+		continue;
+	}
+	const TActor *a = ActorGetByUID(pd->ActorUID);
+	if (a == NULL || !a->isInUse)
+	{
+		continue;
+	}
+	p->UIDs[p->Count] = a->uid;
+	p->Pos[p->Count] = a->Pos;
+	p->Count++;
+	CA_FOREACH_END()
+
+	// Advance our estimate of the server tick, but don't run too far ahead
+	// of the snapshots we have
+	const uint32_t delay = NET_INTERPOLATION_DELAY_MS * FPS_FRAMELIMIT / 1000;
+	n->ServerTick += ticks;
+	if ((int32_t)(n->ServerTick - n->LatestSnapshotTick) > (int32_t)delay)
+	{
+		n->ServerTick = n->LatestSnapshotTick + delay;
+	}
+	NetSnapshotHistoryInterpolate(&n->Snapshots, n->ServerTick - delay);
 }
 
 void NetClientFlush(NetClient *n)
 {
 	if (n->client == NULL) return;
 	enet_host_flush(n->client);
+	NetShimUpdate(&n->Shim);
 }
 
 void NetClientSendMsg(NetClient *n, const GameEventType e, const void *data)
@@ -517,7 +816,27 @@ void NetClientSendMsg(NetClient *n, const GameEventType e, const void *data)
 	}
 
 	LOG(LM_NET, LL_TRACE, "NetClient: send msg type %d", (int)e);
-	enet_peer_send(n->peer, 0, NetEncode(e, data));
+	NActorMove am;
+	if (e == GAME_EVENT_ACTOR_MOVE)
+	{
+		// Number moves so that the server can tell us which it has applied
+		am = *(const NActorMove *)data;
+		n->InputSeq++;
+		am.Seq = n->InputSeq;
+		n->InputTicks[n->InputSeq % NET_PREDICTION_HISTORY] = n->Tick;
+		data = &am;
+	}
+	NetSendPacket(
+		n->peer, &n->Stats, NET_CHANNEL_RELIABLE, NetEncode(e, data));
+}
+
+float NetClientWorldProgress(const NetClient *n)
+{
+	if (!n->World.Active)
+	{
+		return -1;
+	}
+	return NetWorldTransferProgress(&n->World);
 }
 
 bool NetClientIsConnected(const NetClient *n)
@@ -30,7 +30,23 @@
 
 #include <time.h>
 
+#include "net_shim.h"
+#include "net_snapshot.h"
 #include "net_util.h"
+#include "player.h"
+
+// Remote actors are shown this far behind the latest snapshot, so that
+// there is usually a later snapshot to interpolate towards
+#define NET_INTERPOLATION_DELAY_MS 100
+// Number of recent moves and predicted positions kept for reconciliation
+#define NET_PREDICTION_HISTORY 128
+// Local players are corrected if the server disagrees by more than this
+#define NET_RECONCILE_THRESHOLD 4.0f
+// Replies to a LAN discovery query are collected for this long before
+// another query is sent
+#define NET_DISCOVERY_WAIT_MS 1000
+// Servers that haven't replied for this long are dropped from the list
+#define NET_DISCOVERY_EXPIRE_MS 3500
 
 // Stored information about game servers scanned
 typedef struct
@@ -38,8 +54,18 @@ typedef struct
 	NServerInfo ServerInfo;
 	ENetAddress Addr;
 	int LatencyMS;
+	enet_uint32 LastSeen;
 } ScanInfo;
 
+// Where the local players were predicted to be at a tick
+typedef struct
+{
+	uint32_t Tick;
+	int Count;
+	int UIDs[MAX_LOCAL_PLAYERS];
+	struct vec2 Pos[MAX_LOCAL_PLAYERS];
+} NetPrediction;
+
 typedef struct
 {
 	ENetHost *client;
@@ -50,12 +76,30 @@ typedef struct
 	// Socket used to scan for LAN servers
 	ENetSocket scanner;
 	uint16_t port;
-	// Only scan for a period; if > 0 then we are scanning
-	int ScanTicks;
-	// Addresses of scanned LAN servers
+	// When the last discovery query was sent, and whether we are still
+	// waiting for replies to it
+	enet_uint32 ScanTime;
+	bool Scanning;
+	// LAN servers found, kept between scans until they stop replying
 	CArray ScannedAddrs;		// of ScanInfo
-	// Buffer of scanned addresses - new ones will be scanned here
-	CArray scannedAddrBuf;	// of ScanInfo
+	// Recent snapshots received, which the server may send deltas against
+	NetSnapshotHistory Snapshots;
+	// Local game ticks since the game started
+	uint32_t Tick;
+	// Moves sent are numbered, and the tick they were sent at kept
+	uint32_t InputSeq;
+	uint32_t InputTicks[NET_PREDICTION_HISTORY];
+	NetPrediction Predictions[NET_PREDICTION_HISTORY];
+	int PredictionIndex;
+	// Estimate of the server's current tick, from the latest snapshot
+	uint32_t ServerTick;
+	uint32_t LatestSnapshotTick;
+	// World state being received, and reliable messages waiting for it
+	NetWorldTransfer World;
+	CArray Reliable; // of ENetPacket *
+	NetStats Stats;
+	// Relay for simulating a poor link, if enabled by gNetShimOptions
+	NetShim Shim;
 } NetClient;
 
 extern NetClient gNetClient;
@@ -63,9 +107,10 @@ extern NetClient gNetClient;
 void NetClientInit(NetClient *n, const uint16_t port);
 void NetClientTerminate(NetClient *n);
 
-// Start searching for LAN servers; note that the result will be returned in
-// NetClient's boolean
+// Broadcast a query for LAN servers, unless one is in progress; replies are
+// collected into ScannedAddrs as the client is polled
 void NetClientFindLANServers(NetClient *n);
+bool NetClientIsScanning(const NetClient *n);
 // Attempt to connect to a server
 bool NetClientTryConnect(NetClient *n, const ENetAddress addr);
 // Attempt to scan a host for a game server and connect
@@ -73,7 +118,12 @@ bool NetClientTryScanAndConnect(NetClient *n, const enet_uint32 host);
 void NetClientDisconnect(NetClient *n);
 void NetClientPoll(NetClient *n);
 void NetClientFlush(NetClient *n);
+// Record the local players' predicted positions, and interpolate remote
+// actors; call once per frame after the game updates
+void NetClientUpdate(NetClient *n, const int ticks);
 // Send a command to the server
 void NetClientSendMsg(NetClient *n, const GameEventType e, const void *data);
+// Fraction of the world state received so far, or -1 if not receiving one
+float NetClientWorldProgress(const NetClient *n);
 
 bool NetClientIsConnected(const NetClient *n);
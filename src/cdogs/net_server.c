@@ -51,10 +51,16 @@ NetServer gNetServer;
 void NetServerInit(NetServer *n)
 {
 	memset(n, 0, sizeof *n);
+	NetSnapshotInit(&n->snapshot);
+	CArrayInit(&n->snapshotBuf, sizeof(uint8_t));
+	CArrayInit(&n->Interest, sizeof(struct vec2));
 }
 void NetServerTerminate(NetServer *n)
 {
 	NetServerClose(n);
+	NetSnapshotTerminate(&n->snapshot);
+	CArrayTerminate(&n->snapshotBuf);
+	CArrayTerminate(&n->Interest);
 }
 void NetServerReset(NetServer *n)
 {
@@ -96,8 +102,8 @@ static ENetHost *HostOpen(void)
 	ENetAddress address;
 	address.host = ENET_HOST_ANY;
 	address.port = ENET_PORT_ANY;
-	ENetHost *host =
-		enet_host_create(&address, NET_SERVER_MAX_CLIENTS, 2, 0, 0);
+	ENetHost *host = enet_host_create(
+		&address, NET_SERVER_MAX_CLIENTS, NET_CHANNEL_COUNT, 0, 0);
 	if (host == NULL)
 	{
 		LOG(LM_NET, LL_ERROR, "cannot create server host");
@@ -142,6 +148,7 @@ static bool ListenSocketTryOpen(ENetSocket *listen, const enet_uint16 port)
 	return true;
 }
 
+static void PeerDataFree(ENetPeer *peer);
 void NetServerClose(NetServer *n)
 {
 	if (n->server)
@@ -150,6 +157,7 @@ void NetServerClose(NetServer *n)
 		{
 			ENetPeer *peer = n->server->peers + i;
 			enet_peer_disconnect_now(peer, 0);
+			PeerDataFree(peer);
 		}
 		enet_host_destroy(n->server);
 	}
@@ -159,6 +167,7 @@ void NetServerClose(NetServer *n)
 static void PollListener(NetServer *n);
 static void OnReceive(NetServer *n, ENetEvent event);
 static void OnDisconnect(const ENetEvent event);
+static void LogStats(NetServer *n);
 void NetServerPoll(NetServer *n)
 {
 	if (!n->server)
@@ -208,34 +217,79 @@ void NetServerPoll(NetServer *n)
 		}
 	} while (check > 0);
 
+	LogStats(n);
 	NetServerFlush(n);
 }
-static void PollListener(NetServer *n)
+static void LogPeerStats(const ENetPeer *peer);
+static void LogStats(NetServer *n)
 {
-	// Check for data to recv
-	ENetSocketSet set;
-	ENET_SOCKETSET_EMPTY(set);
-	ENET_SOCKETSET_ADD(set, n->listen);
-	if (enet_socketset_select(n->listen, &set, NULL, 0) <= 0)
+	const uint32_t now = enet_time_get();
+	if (now - n->StatsLogTime < NET_STATS_LOG_MS)
 	{
 		return;
 	}
-
-	ENetAddress addr;
-	char buf;
-	ENetBuffer recvbuf;
-	recvbuf.data = &buf;
-	recvbuf.dataLength = 1;
-	const int recvlen = enet_socket_receive(n->listen, &addr, &recvbuf, 1);
-	if (recvlen <= 0)
+	n->StatsLogTime = now;
+	for (int i = 0; i < (int)n->server->peerCount; i++)
 	{
-		return;
+		const ENetPeer *peer = n->server->peers + i;
+		if (peer->state == ENET_PEER_STATE_CONNECTED && peer->data != NULL)
+		{
+			LogPeerStats(peer);
+		}
+	}
+}
+static void LogPeerStats(const ENetPeer *peer)
+{
+	const NetPeerData *pd = peer->data;
+	char name[32];
+	sprintf(name, "peerId(%d)", pd->Id);
+	NetStatsLog(&pd->Stats, peer, name);
+}
+static void ReplyToScanner(
+	const NetServer *n, const ENetAddress *addr, const uint32_t queryTime);
+static void PollListener(NetServer *n)
+{
+	// Answer every query that has arrived since the last poll
+	for (int i = 0; i < NET_DISCOVERY_MAX_PER_POLL; i++)
+	{
+		// Check for data to recv
+		ENetSocketSet set;
+		ENET_SOCKETSET_EMPTY(set);
+		ENET_SOCKETSET_ADD(set, n->listen);
+		if (enet_socketset_select(n->listen, &set, NULL, 0) <= 0)
+		{
+			return;
+		}
+
+		ENetAddress addr;
+		NetDiscoverQuery q;
+		ENetBuffer recvbuf;
+		recvbuf.data = &q;
+		recvbuf.dataLength = sizeof q;
+		const int recvlen = enet_socket_receive(n->listen, &addr, &recvbuf, 1);
+		if (recvlen <= 0)
+		{
+			continue;
+		}
+		char addrbuf[256];
+		enet_address_get_host_ip(&addr, addrbuf, sizeof addrbuf);
+		LOG(LM_NET, LL_DEBUG, "listener received from %s:%u", addrbuf,
+			addr.port);
+		// Older clients send a single dummy byte; reply without a query time
+		// so that they still see us, and can tell the protocol mismatch
+		uint32_t queryTime = 0;
+		if (recvlen == (int)sizeof q && q.MsgId == NET_MSG_DISCOVER)
+		{
+			queryTime = q.Time;
+		}
+		ReplyToScanner(n, &addr, queryTime);
 	}
-	char addrbuf[256];
-	enet_address_get_host_ip(&addr, addrbuf, sizeof addrbuf);
-	LOG(LM_NET, LL_DEBUG, "listener received from %s:%u", addrbuf, addr.port);
+}
+static void ReplyToScanner(
+	const NetServer *n, const ENetAddress *addr, const uint32_t queryTime)
+{
 	// Reply to scanner client with our server host/address
-	NServerInfo sinfo;
+	NServerInfo sinfo = NServerInfo_init_zero;
 	sinfo.ProtocolVersion = NET_PROTOCOL_VERSION;
 	sinfo.ENetPort = n->server->address.port;
 	strcpy(sinfo.Hostname, n->hostname);
@@ -248,22 +302,38 @@ static void PollListener(NetServer *n)
 	sinfo.NumPlayers = GetNumPlayers(PLAYER_ANY, false, false);
 	sinfo.MaxPlayers = NET_SERVER_MAX_CLIENTS * MAX_LOCAL_PLAYERS +
 					   GetNumPlayers(PLAYER_ANY, false, true);
+	sinfo.QueryTime = queryTime;
+	sinfo.HasStarted = gMission.HasStarted;
 	// Encode our packet
-	uint8_t encbuf[1024];
+	uint8_t encbuf[NServerInfo_size];
 	pb_ostream_t stream = pb_ostream_from_buffer(encbuf, sizeof encbuf);
 	const bool status = pb_encode(&stream, NServerInfo_fields, &sinfo);
 	CASSERT(status, "Failed to encode pb");
-	recvbuf.data = encbuf;
-	recvbuf.dataLength = stream.bytes_written;
-	if (enet_socket_send(n->listen, &addr, &recvbuf, 1) !=
-		(int)recvbuf.dataLength)
+	ENetBuffer sendbuf;
+	sendbuf.data = encbuf;
+	sendbuf.dataLength = stream.bytes_written;
+	if (enet_socket_send(n->listen, addr, &sendbuf, 1) !=
+		(int)sendbuf.dataLength)
 	{
 		LOG(LM_NET, LL_ERROR, "Failed to reply to scanner");
 	}
 }
 static void OnConnect(NetServer *n, ENetEvent event);
+static void OnSnapshotAck(const NetServer *n, const ENetEvent event);
+static void OnInput(NetPeerData *pd, const uint32_t seq);
 static void OnReceive(NetServer *n, ENetEvent event)
 {
+	if (event.peer->data != NULL)
+	{
+		NetStatsCount(
+			&((NetPeerData *)event.peer->data)->Stats, false, event.packet);
+	}
+	if (*(uint32_t *)event.packet->data == NET_MSG_SNAPSHOT_ACK)
+	{
+		OnSnapshotAck(n, event);
+		enet_packet_destroy(event.packet);
+		return;
+	}
 	const GameEventType msg = (GameEventType) * (uint32_t *)event.packet->data;
 	int peerId = -1;
 	if (event.peer->data != NULL)
@@ -280,6 +350,10 @@ static void OnReceive(NetServer *n, ENetEvent event)
 		LOG(LM_NET, LL_TRACE, "recv gameEvent(%d)", (int)gee.Type);
 		GameEvent e = GameEventNew(gee.Type);
 		NetDecode(event.packet, &e.u, gee.Fields);
+		if (gee.Type == GAME_EVENT_ACTOR_MOVE && event.peer->data != NULL)
+		{
+			OnInput(event.peer->data, e.u.ActorMove.Seq);
+		}
 		GameEventsEnqueue(&gGameEvents, e);
 	}
 	else
@@ -290,7 +364,13 @@ static void OnReceive(NetServer *n, ENetEvent event)
 			OnConnect(n, event);
 			break;
 		case GAME_EVENT_CLIENT_READY:
-			CASSERT(peerId >= 0, "peer id unset");
+			if (event.peer->data == NULL || peerId < 0)
+			{
+				// Ready before connecting; drop it
+				LOG(LM_NET, LL_WARN, "client ready from unknown peer");
+				break;
+			}
+			((NetPeerData *)event.peer->data)->Ready = true;
 			// Flush game events to make sure we add the players
 			HandleGameEvents(&gGameEvents, NULL, NULL, NULL, NULL);
 			// Reset player data
@@ -359,6 +439,17 @@ static void OnConnect(NetServer *n, ENetEvent event)
 	CMALLOC(event.peer->data, sizeof(NetPeerData));
 	const int peerId = n->peerId;
 	((NetPeerData *)event.peer->data)->Id = peerId;
+	NetStatsInit(&((NetPeerData *)event.peer->data)->Stats);
+	NetBatchInit(
+		&((NetPeerData *)event.peer->data)->Batch, NET_CHANNEL_RELIABLE);
+	((NetPeerData *)event.peer->data)->Batch.Stats =
+		&((NetPeerData *)event.peer->data)->Stats;
+	NetSnapshotHistoryInit(&((NetPeerData *)event.peer->data)->Snapshots);
+	((NetPeerData *)event.peer->data)->SnapshotAck = 0;
+	((NetPeerData *)event.peer->data)->NumInterest = 0;
+	((NetPeerData *)event.peer->data)->InputSeq = 0;
+	((NetPeerData *)event.peer->data)->InputPending = false;
+	((NetPeerData *)event.peer->data)->Ready = false;
 	n->peerId++;
 
 	// Send the client ID
@@ -378,14 +469,48 @@ static void OnConnect(NetServer *n, ENetEvent event)
 
 	NetServerFlush(n);
 }
+static void PeerDataFree(ENetPeer *peer)
+{
+	if (peer->data == NULL)
+	{
+		return;
+	}
+	NetSnapshotHistoryTerminate(&((NetPeerData *)peer->data)->Snapshots);
+	CFREE(peer->data);
+	peer->data = NULL;
+}
+static void OnInput(NetPeerData *pd, const uint32_t seq)
+{
+	if ((int32_t)(seq - pd->InputSeq) > 0)
+	{
+		pd->InputSeq = seq;
+		pd->InputPending = true;
+	}
+}
+static void OnSnapshotAck(const NetServer *n, const ENetEvent event)
+{
+	if (event.peer->data == NULL ||
+		event.packet->dataLength < NET_MSG_SIZE + sizeof(uint32_t))
+	{
+		return;
+	}
+	uint32_t seq;
+	memcpy(&seq, event.packet->data + NET_MSG_SIZE, sizeof seq);
+	NetPeerData *pd = event.peer->data;
+	// Acks are sequenced, but the peer might ack snapshots we never sent
+	if (seq > pd->SnapshotAck && seq <= n->SnapshotSeq)
+	{
+		pd->SnapshotAck = seq;
+	}
+}
 static void OnDisconnect(const ENetEvent event)
 {
 	int peerId = -1;
 	if (event.peer->data != NULL)
 	{
 		peerId = ((NetPeerData *)event.peer->data)->Id;
-		CFREE(event.peer->data);
-		event.peer->data = NULL;
+		LogPeerStats(event.peer);
+		PeerDataFree(event.peer);
 	}
 	CASSERT(peerId >= 0, "Cannot find disconnected peer id");
 	char buf[256];
@@ -401,36 +526,245 @@ static void OnDisconnect(const ENetEvent event)
 	}
 }
 
+void NetServerWait(NetServer *n, const int timeoutMs)
+{
+	if (n->server == NULL)
+	{
+		return;
+	}
+	ENetSocketSet set;
+	ENET_SOCKETSET_EMPTY(set);
+	ENET_SOCKETSET_ADD(set, n->server->socket);
+	ENetSocket maxSocket = n->server->socket;
+	if (n->listen != ENET_SOCKET_NULL)
+	{
+		ENET_SOCKETSET_ADD(set, n->listen);
+		maxSocket = MAX(maxSocket, n->listen);
+	}
+	enet_socketset_select(maxSocket, &set, NULL, (enet_uint32)timeoutMs);
+}
+
+bool NetServerAllPeersReady(const NetServer *n)
+{
+	if (n->server == NULL)
+	{
+		return true;
+	}
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		const ENetPeer *peer = n->server->peers + i;
+		if (peer->state != ENET_PEER_STATE_CONNECTED)
+		{
+			continue;
+		}
+		// Peers without data haven't finished connecting yet
+		if (peer->data == NULL || !((const NetPeerData *)peer->data)->Ready)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+void NetServerUnreadyPeers(NetServer *n)
+{
+	if (n->server == NULL)
+	{
+		return;
+	}
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		NetPeerData *pd = n->server->peers[i].data;
+		if (pd != NULL)
+		{
+			pd->Ready = false;
+		}
+	}
+}
+
 void NetServerFlush(NetServer *n)
 {
 	if (n->server == NULL)
 		return;
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		ENetPeer *peer = n->server->peers + i;
+		if (peer->data != NULL)
+		{
+			NetBatchFlush(&((NetPeerData *)peer->data)->Batch, peer);
+		}
+	}
 	enet_host_flush(n->server);
 }
 
-static void SendConfig(
-	Config *config, const char *name, NetServer *n, const int peerId);
+static void UpdateInterest(NetServer *n);
+static void UpdatePeerInterest(const NetServer *n, NetPeerData *pd);
+static bool PeerIsInterested(
+	const NetServer *n, const NetPeerData *pd, const struct vec2 pos,
+	const float reach);
+void NetServerSendSnapshots(NetServer *n, const int ticks)
+{
+	if (n->server == NULL)
+		return;
+	n->SnapshotTick += ticks;
+	UpdateInterest(n);
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		NetPeerData *pd = n->server->peers[i].data;
+		if (pd == NULL)
+		{
+			continue;
+		}
+		UpdatePeerInterest(n, pd);
+		// Moves received this frame have now been applied
+		if (pd->InputPending)
+		{
+			pd->InputTick = n->SnapshotTick;
+			pd->InputPending = false;
+		}
+	}
+	if (n->server->connectedPeers == 0 ||
+		n->SnapshotTick - n->SnapshotLastTick < NET_SNAPSHOT_INTERVAL)
+	{
+		return;
+	}
+	n->SnapshotLastTick = n->SnapshotTick;
+	n->SnapshotSeq++;
+	NetSnapshotFromWorld(&n->snapshot, n->SnapshotSeq, n->SnapshotTick);
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		ENetPeer *peer = n->server->peers + i;
+		if (peer->state != ENET_PEER_STATE_CONNECTED || peer->data == NULL)
+		{
+			continue;
+		}
+		NetPeerData *pd = peer->data;
+		// Entities that come into interest aren't in the baseline, so they
+		// are sent in full
+		NetSnapshot *s = NetSnapshotHistoryNext(&pd->Snapshots, n->SnapshotSeq);
+		s->Seq = n->SnapshotSeq;
+		s->Tick = n->SnapshotTick;
+		s->InputSeq = pd->InputSeq;
+		s->InputTicks = pd->InputSeq != 0 ? n->SnapshotTick - pd->InputTick : 0;
+		CA_FOREACH(const NetSnapshotEntity, e, n->snapshot.Entities)
+		if (PeerIsInterested(n, pd, NetSnapshotEntityPos(e), 0))
+		{
+			NetSnapshotAdd(s, e);
+		}
+		CA_FOREACH_END()
+		// If the peer's baseline is too old, send the whole snapshot
+		const NetSnapshot *base =
+			NetSnapshotHistoryGet(&pd->Snapshots, pd->SnapshotAck);
+		NetSnapshotWriteDelta(&n->snapshotBuf, base, s);
+		ENetPacket *packet =
+			NetPacketNew(n->snapshotBuf.size, NET_CHANNEL_STATE);
+		if (packet != NULL)
+		{
+			memcpy(packet->data, n->snapshotBuf.data, n->snapshotBuf.size);
+			NetSendPacket(peer, &pd->Stats, NET_CHANNEL_STATE, packet);
+		}
+	}
+}
+static bool TryGetPlayerPos(const PlayerData *p, struct vec2 *pos);
+static void UpdateInterest(NetServer *n)
+{
+	n->InterestRange = (float)(ConfigGetInt(&gConfig, "Game.SightRange") +
+							   NET_INTEREST_MARGIN) *
+					   TILE_WIDTH;
+	// Clients calculate line of sight from all players in co-op, so peers
+	// need what their teammates on other peers can see too
+	n->InterestShared = !IsPVP(gCampaign.Entry.Mode);
+	CArrayClear(&n->Interest);
+	if (!n->InterestShared)
+	{
+		return;
+	}
+	CA_FOREACH(const PlayerData, p, gPlayerDatas)
+	struct vec2 pos;
+	if (TryGetPlayerPos(p, &pos))
+	{
+		CArrayPushBack(&n->Interest, &pos);
+	}
+	CA_FOREACH_END()
+}
+static void UpdatePeerInterest(const NetServer *n, NetPeerData *pd)
+{
+	pd->NumInterest = 0;
+	if (n->InterestShared)
+	{
+		return;
+	}
+	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++)
+	{
+		const PlayerData *p =
+			PlayerDataGetByUID((pd->Id + 1) * MAX_LOCAL_PLAYERS + i);
+		if (TryGetPlayerPos(p, &pd->Interest[pd->NumInterest]))
+		{
+			pd->NumInterest++;
+		}
+	}
+}
+static bool TryGetPlayerPos(const PlayerData *p, struct vec2 *pos)
+{
+	if (p == NULL || !IsPlayerAlive(p))
+		return false;
+	const TActor *a = ActorGetByUID(p->ActorUID);
+	if (a == NULL || !a->isInUse)
+		return false;
+	*pos = a->Pos;
+	return true;
+}
+static bool PeerIsInterested(
+	const NetServer *n, const NetPeerData *pd, const struct vec2 pos,
+	const float reach)
+{
+	const struct vec2 *interest = pd->Interest;
+	int numInterest = pd->NumInterest;
+	if (n->InterestShared)
+	{
+		interest = n->Interest.data;
+		numInterest = (int)n->Interest.size;
+	}
+	if (numInterest == 0)
+	{
+		return true;
+	}
+	const float range = n->InterestRange + reach;
+	for (int i = 0; i < numInterest; i++)
+	{
+		if (svec2_distance_squared(interest[i], pos) <= range * range)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static void SendConfig(Config *config, const char *name, NetWorldBlob *b);
+static void SendWorld(NetServer *n, const int peerId, const NetWorldBlob *b);
 void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 {
 	if (!n->server)
 		return;
+	// Build the world once, to be compressed and sent in bulk
+	NetWorldBlob blob;
+	NetWorldBlobInit(&blob, n->WorldSeq++);
 	GameEvent e;
 	// Send details of all current players
 	CA_FOREACH(const PlayerData, pOther, gPlayerDatas)
 	NPlayerData pd = NMakePlayerData(pOther);
-	NetServerSendMsg(n, peerId, GAME_EVENT_PLAYER_DATA, &pd);
+	NetWorldBlobAdd(&blob, GAME_EVENT_PLAYER_DATA, &pd);
 	LOG(LM_NET, LL_DEBUG, "send player data uid(%d) maxHealth(%d)  excessHealth(%d) HP(%d)",
 		(int)pd.UID, (int)pd.MaxHealth, (int)pd.ExcessHealth, (int)pd.HP);
 	CA_FOREACH_END()
 
 	// Send all game-specific config values
-	SendConfig(&gConfig, "Game.FriendlyFire", n, peerId);
-	SendConfig(&gConfig, "Game.FPS", n, peerId);
-	SendConfig(&gConfig, "Game.Fog", n, peerId);
-	SendConfig(&gConfig, "Game.SightRange", n, peerId);
-	SendConfig(&gConfig, "Game.AllyCollision", n, peerId);
+	SendConfig(&gConfig, "Game.FriendlyFire", &blob);
+	SendConfig(&gConfig, "Game.FPS", &blob);
+	SendConfig(&gConfig, "Game.Fog", &blob);
+	SendConfig(&gConfig, "Game.SightRange", &blob);
+	SendConfig(&gConfig, "Game.AllyCollision", &blob);
 
-	NetServerSendMsg(n, peerId, GAME_EVENT_NET_GAME_START, NULL);
+	NetWorldBlobAdd(&blob, GAME_EVENT_NET_GAME_START, NULL);
 
 	// Send all actors
 	CA_FOREACH(const TActor, a, gActors)
@@ -450,21 +784,20 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 	e.u.ActorAdd.Pos = Vec2ToNet(a->Pos);
 	LOG(LM_NET, LL_DEBUG, "send add actor UID(%d) playerUID(%d)",
 		(int)e.u.ActorAdd.UID, (int)e.u.ActorAdd.PlayerUID);
-	NetServerSendMsg(n, peerId, GAME_EVENT_ACTOR_ADD, &e.u.ActorAdd);
+	NetWorldBlobAdd(&blob, GAME_EVENT_ACTOR_ADD, &e.u.ActorAdd);
 	CA_FOREACH_END()
 
 	// Send key state
 	e = GameEventNew(GAME_EVENT_ADD_KEYS);
 	e.u.AddKeys.KeyFlags = gMission.KeyFlags;
-	NetServerSendMsg(n, peerId, GAME_EVENT_ADD_KEYS, &e.u.AddKeys);
+	NetWorldBlobAdd(&blob, GAME_EVENT_ADD_KEYS, &e.u.AddKeys);
 
 	// Send objective counts
 	CA_FOREACH(const Objective, o, gMission.missionData->Objectives)
 	e = GameEventNew(GAME_EVENT_OBJECTIVE_UPDATE);
 	e.u.ObjectiveUpdate.ObjectiveId = _ca_index;
 	e.u.ObjectiveUpdate.Count = o->done;
-	NetServerSendMsg(
-		n, peerId, GAME_EVENT_OBJECTIVE_UPDATE, &e.u.ObjectiveUpdate);
+	NetWorldBlobAdd(&blob, GAME_EVENT_OBJECTIVE_UPDATE, &e.u.ObjectiveUpdate);
 	CA_FOREACH_END()
 
 	// Send all tiles, RLE
@@ -486,8 +819,7 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 				// Send the last run
 				if (tLast != NULL)
 				{
-					NetServerSendMsg(
-						n, peerId, GAME_EVENT_TILE_SET, &e.u.TileSet);
+					NetWorldBlobAdd(&blob, GAME_EVENT_TILE_SET, &e.u.TileSet);
 				}
 				// Begin the next run
 				e = GameEventNew(GAME_EVENT_TILE_SET);
@@ -518,7 +850,7 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 			tLast = t;
 		}
 	}
-	NetServerSendMsg(n, peerId, GAME_EVENT_TILE_SET, &e.u.TileSet);
+	NetWorldBlobAdd(&blob, GAME_EVENT_TILE_SET, &e.u.TileSet);
 
 	// Send all the tiles visited so far
 	e = GameEventNew(GAME_EVENT_EXPLORE_TILES);
@@ -530,8 +862,8 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 			const Tile *t = MapGetTile(&gMap, pos);
 			if (LOSAddRun(&e.u.ExploreTiles, &run, pos, t->isVisited))
 			{
-				NetServerSendMsg(
-					n, peerId, GAME_EVENT_EXPLORE_TILES, &e.u.ExploreTiles);
+				NetWorldBlobAdd(
+					&blob, GAME_EVENT_EXPLORE_TILES, &e.u.ExploreTiles);
 				e = GameEventNew(GAME_EVENT_EXPLORE_TILES);
 				run = false;
 			}
@@ -539,8 +871,7 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 	}
 	if (e.u.ExploreTiles.Runs_count > 0)
 	{
-		NetServerSendMsg(
-			n, peerId, GAME_EVENT_EXPLORE_TILES, &e.u.ExploreTiles);
+		NetWorldBlobAdd(&blob, GAME_EVENT_EXPLORE_TILES, &e.u.ExploreTiles);
 	}
 
 	// Send all pickups
@@ -554,7 +885,7 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 	e.u.AddPickup.SpawnerUID = p->SpawnerUID;
 	e.u.AddPickup.ThingFlags = p->thing.flags;
 	e.u.AddPickup.Pos = Vec2ToNet(p->thing.Pos);
-	NetServerSendMsg(n, peerId, GAME_EVENT_ADD_PICKUP, &e.u.AddPickup);
+	NetWorldBlobAdd(&blob, GAME_EVENT_ADD_PICKUP, &e.u.AddPickup);
 	CA_FOREACH_END()
 
 	// Send all map objects
@@ -573,18 +904,41 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 		(int)e.u.MapObjectAdd.UID, e.u.MapObjectAdd.Pos.x,
 		e.u.MapObjectAdd.Pos.y, e.u.MapObjectAdd.ThingFlags,
 		e.u.MapObjectAdd.Health);
-	NetServerSendMsg(n, peerId, GAME_EVENT_MAP_OBJECT_ADD, &e.u.MapObjectAdd);
+	NetWorldBlobAdd(&blob, GAME_EVENT_MAP_OBJECT_ADD, &e.u.MapObjectAdd);
 	CA_FOREACH_END()
 
 	// If mission complete already, send message
 	if (CanCompleteMission(&gMission))
 	{
 		NMissionComplete mc = NMakeMissionComplete(&gMission);
-		NetServerSendMsg(n, peerId, GAME_EVENT_MISSION_COMPLETE, &mc);
+		NetWorldBlobAdd(&blob, GAME_EVENT_MISSION_COMPLETE, &mc);
+	}
+
+	if (NetWorldBlobCompress(&blob))
+	{
+		SendWorld(n, peerId, &blob);
 	}
+	NetWorldBlobTerminate(&blob);
 }
-static void SendConfig(
-	Config *config, const char *name, NetServer *n, const int peerId)
+static void SendWorld(NetServer *n, const int peerId, const NetWorldBlob *b)
+{
+	LOG(LM_NET, LL_DEBUG, "send world(%u) to peer(%d) size(%u)",
+		(unsigned)b->Id, peerId, (unsigned)b->Compressed.size);
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		ENetPeer *peer = n->server->peers + i;
+		NetPeerData *pd = peer->data;
+		if (peer->state != ENET_PEER_STATE_CONNECTED || pd == NULL ||
+			(peerId >= 0 && pd->Id != peerId))
+		{
+			continue;
+		}
+		// Keep the world after messages already batched
+		NetBatchFlush(&pd->Batch, peer);
+		NetWorldBlobSend(b, peer, &pd->Stats);
+	}
+}
+static void SendConfig(Config *config, const char *name, NetWorldBlob *b)
 {
 	GameEvent e = GameEventNew(GAME_EVENT_CONFIG);
 	const Config *c = ConfigGet(config, name);
@@ -613,9 +967,13 @@ static void SendConfig(
 		CASSERT(false, "Unknown config type");
 		break;
 	}
-	NetServerSendMsg(n, peerId, GAME_EVENT_CONFIG, &e.u.Config);
+	NetWorldBlobAdd(b, GAME_EVENT_CONFIG, &e.u.Config);
 }
 
+static NetBatch *PeerBatch(ENetPeer *peer)
+{
+	return &((NetPeerData *)peer->data)->Batch;
+}
 void NetServerSendMsg(
 	NetServer *n, const int peerId, const GameEventType e, const void *data)
 {
@@ -633,7 +991,7 @@ void NetServerSendMsg(
 			if (peer->data != NULL &&
 				((NetPeerData *)peer->data)->Id == peerId)
 			{
-				enet_peer_send(peer, 0, NetEncode(e, data));
+				NetBatchAdd(PeerBatch(peer), peer, e, data);
 				return;
 			}
 		}
@@ -643,6 +1001,48 @@ void NetServerSendMsg(
 	{
 		LOG(LM_NET, LL_TRACE, "bcast msg(%d) to peers(%d)", (int)e,
 			(int)n->server->connectedPeers);
-		enet_host_broadcast(n->server, 0, NetEncode(e, data));
+		for (int i = 0; i < (int)n->server->peerCount; i++)
+		{
+			ENetPeer *peer = n->server->peers + i;
+			if (peer->state != ENET_PEER_STATE_CONNECTED)
+			{
+				continue;
+			}
+			if (peer->data != NULL)
+			{
+				NetBatchAdd(PeerBatch(peer), peer, e, data);
+			}
+			else
+			{
+				// Peer hasn't completed connecting; send immediately
+				NetSend(peer, e, data);
+			}
+		}
+	}
+}
+
+void NetServerBroadcastEvent(NetServer *n, const GameEvent *e)
+{
+	if (!n->server)
+		return;
+	struct vec2 pos;
+	float reach;
+	if (!GameEventGetInterest(e, &pos, &reach))
+	{
+		NetServerSendMsg(n, NET_SERVER_BCAST, e->Type, &e->u);
+		return;
+	}
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		ENetPeer *peer = n->server->peers + i;
+		// Peers that are still connecting don't have anything to see yet
+		if (peer->state != ENET_PEER_STATE_CONNECTED || peer->data == NULL)
+		{
+			continue;
+		}
+		if (PeerIsInterested(n, peer->data, pos, reach))
+		{
+			NetBatchAdd(PeerBatch(peer), peer, e->Type, &e->u);
+		}
 	}
 }
@@ -31,11 +31,17 @@
 #include <stdbool.h>
 
 #include "c_array.h"
+#include "net_snapshot.h"
 #include "net_util.h"
 
 
 #define NET_SERVER_MAX_CLIENTS 32
 #define NET_SERVER_BCAST -1
+// Tiles beyond sight range that peers are still sent events and entities
+// for, so that things moving into view are already there
+#define NET_INTEREST_MARGIN 4
+// Log each peer's network stats this often
+#define NET_STATS_LOG_MS 10000
 
 typedef struct
 {
@@ -47,6 +53,22 @@ typedef struct
 	int PrevCmd;
 	int Cmd;
 	int peerId;	// auto-incrementing id for the next connected peer
+	// Snapshot of the whole world; peers are sent the parts that are
+	// relevant to them
+	NetSnapshot snapshot;
+	uint32_t SnapshotSeq;
+	uint32_t SnapshotTick;
+	uint32_t SnapshotLastTick;
+	CArray snapshotBuf; // of uint8_t
+	// Id of the next world state sent to joining clients
+	uint32_t WorldSeq;
+	// Distance from an interest position within which things are relevant
+	float InterestRange;
+	// In co-op, clients see from every player's line of sight, so all peers
+	// share the positions of all live players as their interest
+	bool InterestShared;
+	CArray Interest; // of struct vec2
+	uint32_t StatsLogTime;
 } NetServer;
 
 extern NetServer gNetServer;
@@ -54,6 +76,24 @@ extern NetServer gNetServer;
 typedef struct
 {
 	int Id;
+	// Messages for this peer are batched and sent on flush
+	NetBatch Batch;
+	// Recent snapshots sent to the peer, which it may acknowledge
+	NetSnapshotHistory Snapshots;
+	// Last snapshot the peer acknowledged, used as the delta baseline
+	uint32_t SnapshotAck;
+	// In PVP, positions of the peer's live players; if none, the peer is
+	// spectating and everything is relevant
+	struct vec2 Interest[MAX_LOCAL_PLAYERS];
+	int NumInterest;
+	// Latest move sequence received from the peer, and the snapshot tick
+	// when it was applied, so the peer can reconcile its predictions
+	uint32_t InputSeq;
+	uint32_t InputTick;
+	bool InputPending;
+	// Whether the peer has loaded and equipped for the next mission
+	bool Ready;
+	NetStats Stats;
 } NetPeerData;
 
 void NetServerInit(NetServer *n);
@@ -65,10 +105,23 @@ void NetServerOpen(NetServer *n, const uint16_t port);
 void NetServerClose(NetServer *n);
 // Service the recv buffer; if data is received then activate this device
 void NetServerPoll(NetServer *n);
+// Block until there is data to poll, or the timeout passes
+void NetServerWait(NetServer *n, const int timeoutMs);
+// Whether every connected client has said it is ready for the mission
+bool NetServerAllPeersReady(const NetServer *n);
+// Require clients to say they are ready again, e.g. for the next mission
+void NetServerUnreadyPeers(NetServer *n);
+// Send all batched messages
 void NetServerFlush(NetServer *n);
+// Send each client a snapshot of the world, as a delta against the last
+// snapshot it acknowledged; call once per game update
+void NetServerSendSnapshots(NetServer *n, const int ticks);
 
 // If peerId is -1, broadcast
 void NetServerSendMsg(
 	NetServer *n, const int peerId, const GameEventType e, const void *data);
+// Broadcast a game event, skipping peers too far away for it to matter
+void NetServerBroadcastEvent(NetServer *n, const GameEvent *e);
 
+// Send the whole world state, compressed, for clients to start the game with
 void NetServerSendGameStartMessages(NetServer *n, const int peerId);
@@ -0,0 +1,233 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "net_shim.h"
+
+#include <stdio.h>
+
+#include "log.h"
+#include "utils.h"
+
+NetShimOptions gNetShimOptions;
+
+typedef struct
+{
+	enet_uint32 DueTime;
+	bool ToServer;
+	uint8_t *Data;
+	size_t Size;
+} NetShimDatagram;
+
+void NetShimInit(NetShim *s)
+{
+	memset(s, 0, sizeof *s);
+	s->listen = ENET_SOCKET_NULL;
+	s->relay = ENET_SOCKET_NULL;
+	CArrayInit(&s->queue, sizeof(NetShimDatagram));
+}
+void NetShimTerminate(NetShim *s)
+{
+	NetShimClose(s);
+	CArrayTerminate(&s->queue);
+}
+
+bool NetShimOptionsParse(NetShimOptions *o, const char *s)
+{
+	memset(o, 0, sizeof *o);
+	unsigned int seed = 1;
+	const int n =
+		sscanf(s, "%d,%d,%f,%u", &o->LatencyMS, &o->JitterMS, &o->Loss, &seed);
+	if (n < 3 || o->LatencyMS < 0 || o->JitterMS < 0 || o->Loss < 0 ||
+		o->Loss > 1)
+	{
+		return false;
+	}
+	o->Seed = seed;
+	o->Enabled = true;
+	return true;
+}
+
+static ENetSocket SocketOpen(void);
+bool NetShimOpen(
+	NetShim *s, const NetShimOptions *o, const ENetAddress serverAddr)
+{
+	NetShimClose(s);
+	s->Options = *o;
+	s->ServerAddr = serverAddr;
+	s->HasClient = false;
+	// xorshift needs a non-zero state
+	s->rand = o->Seed != 0 ? o->Seed : 1;
+	s->Relayed = 0;
+	s->Dropped = 0;
+	s->listen = SocketOpen();
+	s->relay = SocketOpen();
+	if (s->listen == ENET_SOCKET_NULL || s->relay == ENET_SOCKET_NULL ||
+		enet_socket_get_address(s->listen, &s->Address) != 0)
+	{
+		LOG(LM_NET, LL_ERROR, "failed to open net shim");
+		NetShimClose(s);
+		return false;
+	}
+	enet_address_set_host_ip(&s->Address, "127.0.0.1");
+	LOG(LM_NET, LL_INFO,
+		"net shim on port %u latency(%dms) jitter(%dms) loss(%.1f%%) seed(%u)",
+		s->Address.port, o->LatencyMS, o->JitterMS, o->Loss * 100,
+		(unsigned)o->Seed);
+	return true;
+}
+static ENetSocket SocketOpen(void)
+{
+	ENetSocket socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+	if (socket == ENET_SOCKET_NULL)
+	{
+		return ENET_SOCKET_NULL;
+	}
+	ENetAddress addr;
+	addr.host = ENET_HOST_ANY;
+	addr.port = 0;
+	if (enet_socket_bind(socket, &addr) != 0 ||
+		enet_socket_set_option(socket, ENET_SOCKOPT_NONBLOCK, 1) != 0)
+	{
+		enet_socket_destroy(socket);
+		return ENET_SOCKET_NULL;
+	}
+	return socket;
+}
+
+void NetShimClose(NetShim *s)
+{
+	if (s->listen != ENET_SOCKET_NULL)
+	{
+		enet_socket_destroy(s->listen);
+		s->listen = ENET_SOCKET_NULL;
+	}
+	if (s->relay != ENET_SOCKET_NULL)
+	{
+		enet_socket_destroy(s->relay);
+		s->relay = ENET_SOCKET_NULL;
+	}
+	CA_FOREACH(NetShimDatagram, d, s->queue)
+	CFREE(d->Data);
+	CA_FOREACH_END()
+	CArrayClear(&s->queue);
+}
+
+bool NetShimIsOpen(const NetShim *s)
+{
+	return s->listen != ENET_SOCKET_NULL;
+}
+
+static uint32_t Rand(NetShim *s)
+{
+	s->rand ^= s->rand << 13;
+	s->rand ^= s->rand >> 17;
+	s->rand ^= s->rand << 5;
+	return s->rand;
+}
+static void Receive(NetShim *s, const bool toServer, const enet_uint32 now);
+static void Send(NetShim *s, const NetShimDatagram *d);
+void NetShimUpdate(NetShim *s)
+{
+	if (!NetShimIsOpen(s))
+	{
+		return;
+	}
+	const enet_uint32 now = enet_time_get();
+	Receive(s, true, now);
+	Receive(s, false, now);
+	for (int i = 0; i < (int)s->queue.size;)
+	{
+		NetShimDatagram *d = CArrayGet(&s->queue, i);
+		if ((int32_t)(now - d->DueTime) < 0)
+		{
+			i++;
+			continue;
+		}
+		Send(s, d);
+		CFREE(d->Data);
+		CArrayDelete(&s->queue, i);
+	}
+}
+static void Receive(NetShim *s, const bool toServer, const enet_uint32 now)
+{
+	const ENetSocket socket = toServer ? s->listen : s->relay;
+	for (;;)
+	{
+		uint8_t buf[ENET_PROTOCOL_MAXIMUM_MTU];
+		ENetBuffer recvbuf;
+		recvbuf.data = buf;
+		recvbuf.dataLength = sizeof buf;
+		ENetAddress addr;
+		const int len = enet_socket_receive(socket, &addr, &recvbuf, 1);
+		if (len <= 0)
+		{
+			break;
+		}
+		if (toServer)
+		{
+			// Replies go to whoever sent to us last
+			s->ClientAddr = addr;
+			s->HasClient = true;
+		}
+		// Draw both numbers for every datagram, so that the sequence
+		// doesn't depend on which are dropped
+		const float r = (float)(Rand(s) % 10000) / 10000;
+		const int jitter =
+			s->Options.JitterMS > 0
+				? (int)(Rand(s) % (uint32_t)(s->Options.JitterMS * 2 + 1)) -
+					  s->Options.JitterMS
+				: 0;
+		if (r < s->Options.Loss)
+		{
+			s->Dropped++;
+			continue;
+		}
+		NetShimDatagram d;
+		d.DueTime = now + (enet_uint32)MAX(s->Options.LatencyMS + jitter, 0);
+		d.ToServer = toServer;
+		d.Size = (size_t)len;
+		CMALLOC(d.Data, d.Size);
+		memcpy(d.Data, buf, d.Size);
+		CArrayPushBack(&s->queue, &d);
+	}
+}
+static void Send(NetShim *s, const NetShimDatagram *d)
+{
+	if (!d->ToServer && !s->HasClient)
+	{
+		return;
+	}
+	ENetBuffer sendbuf;
+	sendbuf.data = d->Data;
+	sendbuf.dataLength = d->Size;
+	const ENetSocket socket = d->ToServer ? s->relay : s->listen;
+	const ENetAddress *addr = d->ToServer ? &s->ServerAddr : &s->ClientAddr;
+	if (enet_socket_send(socket, addr, &sendbuf, 1) == (int)d->Size)
+	{
+		s->Relayed++;
+	}
+}
@@ -0,0 +1,82 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <enet/enet.h>
+
+#include "c_array.h"
+
+// A UDP relay on the loopback address that sits between a client and its
+// server, delaying and dropping datagrams to simulate a poor link. The drops
+// and jitter come from a seeded generator so that runs can be repeated.
+
+typedef struct
+{
+	bool Enabled;
+	// One-way delay added to each datagram, plus or minus up to the jitter
+	int LatencyMS;
+	int JitterMS;
+	// Fraction of datagrams dropped, from 0 to 1
+	float Loss;
+	uint32_t Seed;
+} NetShimOptions;
+
+// Options used by the client when connecting; disabled by default
+extern NetShimOptions gNetShimOptions;
+
+typedef struct
+{
+	NetShimOptions Options;
+	// Clients connect to this address instead of the server's
+	ENetAddress Address;
+	ENetSocket listen;
+	// Datagrams are relayed to and from the server through this socket
+	ENetSocket relay;
+	ENetAddress ServerAddr;
+	ENetAddress ClientAddr;
+	bool HasClient;
+	uint32_t rand;
+	CArray queue; // of NetShimDatagram
+	uint32_t Relayed;
+	uint32_t Dropped;
+} NetShim;
+
+void NetShimInit(NetShim *s);
+void NetShimTerminate(NetShim *s);
+// Parse options of the form latency,jitter,loss[,seed]
+bool NetShimOptionsParse(NetShimOptions *o, const char *s);
+bool NetShimOpen(
+	NetShim *s, const NetShimOptions *o, const ENetAddress serverAddr);
+void NetShimClose(NetShim *s);
+bool NetShimIsOpen(const NetShim *s);
+// Receive datagrams in both directions, and send those that are due; call
+// often, as the delays are only as accurate as the calls
+void NetShimUpdate(NetShim *s);
@@ -0,0 +1,755 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "net_snapshot.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "actors.h"
+#include "game_events.h"
+#include "log.h"
+#include "objs.h"
+#include "pickup.h"
+
+// Snapshot packets are NET_MSG_SNAPSHOT followed by a bitstream:
+// - sequence (32 bits), tick (32 bits)
+// - sequence gap to the baseline (0 if none)
+// - the client's last input sequence (0 if none), and ticks since it
+// - entity records, each with:
+//   - kind (2 bits), UID gap from the previous record of the same kind
+//   - removed flag (1 bit)
+//   - bitfield of changed fields, then the changed fields
+// - SNAPSHOT_KIND_COUNT (2 bits) to end
+// Entities that haven't changed from the baseline are not written at all.
+// Positions are extrapolated from the baseline position and velocity, so
+// entities moving in a straight line don't take any bandwidth either.
+// Integers are written as exp-Golomb codes so that small values are short.
+
+#define SNAPSHOT_KIND_BITS 2
+#define SNAPSHOT_DIR_BITS 3
+
+typedef struct
+{
+	CArray *Out; // of uint8_t
+	int Bit;	 // bits used in the last byte, 0 if full
+} BitWriter;
+static void BitWrite(BitWriter *w, const uint64_t value, const int bits)
+{
+	for (int i = bits - 1; i >= 0; i--)
+	{
+		if (w->Bit == 0)
+		{
+			const uint8_t zero = 0;
+			CArrayPushBack(w->Out, &zero);
+		}
+		uint8_t *b = CArrayGet(w->Out, w->Out->size - 1);
+		if ((value >> i) & 1)
+		{
+			*b |= (uint8_t)(0x80 >> w->Bit);
+		}
+		w->Bit = (w->Bit + 1) & 7;
+	}
+}
+static void BitWriteUnsigned(BitWriter *w, const uint32_t value)
+{
+	const uint64_t x = (uint64_t)value + 1;
+	int n = 0;
+	while ((x >> (n + 1)) != 0)
+	{
+		n++;
+	}
+	BitWrite(w, 0, n);
+	BitWrite(w, x, n + 1);
+}
+static void BitWriteSigned(BitWriter *w, const int32_t value)
+{
+	// Zigzag encode so that small negative values are also short
+	const uint32_t u = value < 0 ? ((uint32_t)(-(value + 1)) << 1) | 1
+								 : (uint32_t)value << 1;
+	BitWriteUnsigned(w, u);
+}
+
+typedef struct
+{
+	const uint8_t *Data;
+	size_t Len;
+	size_t Pos; // in bits
+	bool Err;
+} BitReader;
+static uint64_t BitRead(BitReader *r, const int bits)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < bits; i++)
+	{
+		if (r->Pos >= r->Len * 8)
+		{
+			r->Err = true;
+			return 0;
+		}
+		const int bit = (r->Data[r->Pos / 8] >> (7 - r->Pos % 8)) & 1;
+		value = (value << 1) | (uint64_t)bit;
+		r->Pos++;
+	}
+	return value;
+}
+static uint32_t BitReadUnsigned(BitReader *r)
+{
+	int n = 0;
+	while (BitRead(r, 1) == 0)
+	{
+		n++;
+		if (r->Err || n > 32)
+		{
+			r->Err = true;
+			return 0;
+		}
+	}
+	const uint64_t x = ((uint64_t)1 << n) | BitRead(r, n);
+	return (uint32_t)(x - 1);
+}
+static int32_t BitReadSigned(BitReader *r)
+{
+	const uint32_t u = BitReadUnsigned(r);
+	return (u & 1) ? -(int32_t)(u >> 1) - 1 : (int32_t)(u >> 1);
+}
+
+void NetSnapshotInit(NetSnapshot *s)
+{
+	memset(s, 0, sizeof *s);
+	CArrayInit(&s->Entities, sizeof(NetSnapshotEntity));
+}
+void NetSnapshotTerminate(NetSnapshot *s)
+{
+	CArrayTerminate(&s->Entities);
+}
+
+static int32_t Quantise(const float x, const int scale)
+{
+	return (int32_t)roundf(x * scale);
+}
+static struct vec2 Dequantise(const int32_t q[2], const int scale)
+{
+	return svec2((float)q[0] / scale, (float)q[1] / scale);
+}
+
+NetSnapshotEntity NetSnapshotEntityNew(
+	const NetSnapshotKind kind, const int uid, const struct vec2 pos,
+	const struct vec2 vel)
+{
+	NetSnapshotEntity e;
+	memset(&e, 0, sizeof e);
+	e.Kind = kind;
+	e.UID = uid;
+	e.Pos[0] = Quantise(pos.x, NET_SNAPSHOT_POS_SCALE);
+	e.Pos[1] = Quantise(pos.y, NET_SNAPSHOT_POS_SCALE);
+	e.Vel[0] = Quantise(vel.x, NET_SNAPSHOT_VEL_SCALE);
+	e.Vel[1] = Quantise(vel.y, NET_SNAPSHOT_VEL_SCALE);
+	return e;
+}
+
+struct vec2 NetSnapshotEntityPos(const NetSnapshotEntity *e)
+{
+	return Dequantise(e->Pos, NET_SNAPSHOT_POS_SCALE);
+}
+
+static int CompareEntities(const void *v1, const void *v2)
+{
+	const NetSnapshotEntity *e1 = v1;
+	const NetSnapshotEntity *e2 = v2;
+	if (e1->Kind != e2->Kind)
+	{
+		return e1->Kind < e2->Kind ? -1 : 1;
+	}
+	if (e1->UID != e2->UID)
+	{
+		return e1->UID < e2->UID ? -1 : 1;
+	}
+	return 0;
+}
+
+void NetSnapshotAdd(NetSnapshot *s, const NetSnapshotEntity *e)
+{
+	CASSERT(
+		s->Entities.size == 0 ||
+			CompareEntities(
+				CArrayGet(&s->Entities, s->Entities.size - 1), e) < 0,
+		"snapshot entities out of order");
+	CArrayPushBack(&s->Entities, e);
+}
+
+void NetSnapshotFromWorld(
+	NetSnapshot *s, const uint32_t seq, const uint32_t tick)
+{
+	CArrayClear(&s->Entities);
+	s->Seq = seq;
+	s->Tick = tick;
+	CA_FOREACH(const TActor, a, gActors)
+	if (!a->isInUse)
+	{
+		continue;
+	}
+	NetSnapshotEntity e =
+		NetSnapshotEntityNew(SNAPSHOT_ACTOR, a->uid, a->Pos, a->MoveVel);
+	e.Dir = (int)a->direction;
+	e.State = (int)a->anim.Type;
+	e.Health = a->health;
+	CArrayPushBack(&s->Entities, &e);
+	CA_FOREACH_END()
+	CA_FOREACH(const TMobileObject, obj, gMobObjs)
+	if (!obj->isInUse)
+	{
+		continue;
+	}
+	const NetSnapshotEntity e = NetSnapshotEntityNew(
+		SNAPSHOT_MOBOBJ, obj->UID, obj->thing.Pos, obj->thing.Vel);
+	CArrayPushBack(&s->Entities, &e);
+	CA_FOREACH_END()
+	CA_FOREACH(const Pickup, p, gPickups)
+	if (!p->isInUse)
+	{
+		continue;
+	}
+	const NetSnapshotEntity e = NetSnapshotEntityNew(
+		SNAPSHOT_PICKUP, p->UID, p->thing.Pos, svec2_zero());
+	CArrayPushBack(&s->Entities, &e);
+	CA_FOREACH_END()
+	// UIDs are allocated in order but things are reused out of order
+	qsort(
+		s->Entities.data, s->Entities.size, s->Entities.elemSize,
+		CompareEntities);
+}
+
+static int KindFieldBits(const NetSnapshotKind kind)
+{
+	// Dir, state and health are only for actors
+	return kind == SNAPSHOT_ACTOR ? 5 : 2;
+}
+
+// Where the baseline entity would be after this many ticks
+static void Predict(
+	int32_t out[2], const NetSnapshotEntity *base, const uint32_t ticks)
+{
+	const int64_t scale = NET_SNAPSHOT_VEL_SCALE / NET_SNAPSHOT_POS_SCALE;
+	for (int i = 0; i < 2; i++)
+	{
+		// Round to nearest so that straight-line movement predicts exactly
+		const int64_t d = (int64_t)base->Vel[i] * ticks;
+		out[i] = base->Pos[i] +
+				 (int32_t)((d + (d >= 0 ? scale / 2 : -scale / 2)) / scale);
+	}
+}
+
+typedef struct
+{
+	int Kind;
+	int UID;
+} RecordKey;
+static void WriteKey(BitWriter *w, RecordKey *prev, const NetSnapshotEntity *e)
+{
+	BitWrite(w, (uint64_t)e->Kind, SNAPSHOT_KIND_BITS);
+	if ((int)e->Kind != prev->Kind)
+	{
+		prev->Kind = (int)e->Kind;
+		prev->UID = -1;
+	}
+	BitWriteUnsigned(w, (uint32_t)(e->UID - prev->UID - 1));
+	prev->UID = e->UID;
+}
+static void WriteEntity(
+	BitWriter *w, RecordKey *prev, const NetSnapshotEntity *base,
+	const NetSnapshotEntity *cur, const uint32_t ticks, const bool isNew)
+{
+	int32_t pred[2];
+	Predict(pred, base, ticks);
+	uint8_t mask = 0;
+	if (cur->Pos[0] != pred[0] || cur->Pos[1] != pred[1])
+		mask |= SNAPSHOT_FIELD_POS;
+	if (cur->Vel[0] != base->Vel[0] || cur->Vel[1] != base->Vel[1])
+		mask |= SNAPSHOT_FIELD_VEL;
+	if (cur->Kind == SNAPSHOT_ACTOR)
+	{
+		if (cur->Dir != base->Dir)
+			mask |= SNAPSHOT_FIELD_DIR;
+		if (cur->State != base->State)
+			mask |= SNAPSHOT_FIELD_STATE;
+		if (cur->Health != base->Health)
+			mask |= SNAPSHOT_FIELD_HEALTH;
+	}
+	if (mask == 0 && !isNew)
+	{
+		return;
+	}
+
+	WriteKey(w, prev, cur);
+	BitWrite(w, 0, 1); // not removed
+	BitWrite(w, mask, KindFieldBits(cur->Kind));
+	if (mask & SNAPSHOT_FIELD_POS)
+	{
+		BitWriteSigned(w, cur->Pos[0] - pred[0]);
+		BitWriteSigned(w, cur->Pos[1] - pred[1]);
+	}
+	if (mask & SNAPSHOT_FIELD_VEL)
+	{
+		BitWriteSigned(w, cur->Vel[0] - base->Vel[0]);
+		BitWriteSigned(w, cur->Vel[1] - base->Vel[1]);
+	}
+	if (mask & SNAPSHOT_FIELD_DIR)
+	{
+		BitWrite(w, (uint64_t)cur->Dir, SNAPSHOT_DIR_BITS);
+	}
+	if (mask & SNAPSHOT_FIELD_STATE)
+	{
+		BitWriteUnsigned(w, (uint32_t)cur->State);
+	}
+	if (mask & SNAPSHOT_FIELD_HEALTH)
+	{
+		BitWriteSigned(w, cur->Health - base->Health);
+	}
+}
+
+void NetSnapshotWriteDelta(
+	CArray *out, const NetSnapshot *base, const NetSnapshot *cur)
+{
+	CArrayClear(out);
+	const uint32_t msgId = NET_MSG_SNAPSHOT;
+	for (int i = 0; i < (int)NET_MSG_SIZE; i++)
+	{
+		CArrayPushBack(out, (const uint8_t *)&msgId + i);
+	}
+	BitWriter w = {out, 0};
+	BitWrite(&w, cur->Seq, 32);
+	BitWrite(&w, cur->Tick, 32);
+	BitWriteUnsigned(&w, base != NULL ? cur->Seq - base->Seq : 0);
+	BitWriteUnsigned(&w, cur->InputSeq);
+	BitWriteUnsigned(&w, cur->InputTicks);
+	const uint32_t ticks = base != NULL ? cur->Tick - base->Tick : 0;
+
+	RecordKey prev = {-1, -1};
+	size_t i = 0, j = 0;
+	const size_t baseSize = base != NULL ? base->Entities.size : 0;
+	while (i < baseSize || j < cur->Entities.size)
+	{
+		const NetSnapshotEntity *b =
+			i < baseSize ? CArrayGet(&base->Entities, i) : NULL;
+		const NetSnapshotEntity *c =
+			j < cur->Entities.size ? CArrayGet(&cur->Entities, j) : NULL;
+		const int cmp =
+			b == NULL ? 1 : (c == NULL ? -1 : CompareEntities(b, c));
+		if (cmp < 0)
+		{
+			WriteKey(&w, &prev, b);
+			BitWrite(&w, 1, 1); // removed
+			i++;
+		}
+		else if (cmp > 0)
+		{
+			NetSnapshotEntity zero;
+			memset(&zero, 0, sizeof zero);
+			WriteEntity(&w, &prev, &zero, c, 0, true);
+			j++;
+		}
+		else
+		{
+			WriteEntity(&w, &prev, b, c, ticks, false);
+			i++;
+			j++;
+		}
+	}
+	BitWrite(&w, SNAPSHOT_KIND_COUNT, SNAPSHOT_KIND_BITS);
+}
+
+// Unchanged entity; it has moved as predicted
+static void CarryForward(
+	NetSnapshot *out, const NetSnapshotEntity *base, const uint32_t ticks)
+{
+	NetSnapshotEntity e = *base;
+	Predict(e.Pos, base, ticks);
+	e.Changed = 0;
+	CArrayPushBack(&out->Entities, &e);
+}
+static void ReadEntity(
+	BitReader *r, NetSnapshot *out, const NetSnapshotEntity *base,
+	const uint32_t ticks)
+{
+	NetSnapshotEntity e = *base;
+	Predict(e.Pos, base, ticks);
+	e.Changed = (uint8_t)BitRead(r, KindFieldBits(e.Kind));
+	if (e.Changed & SNAPSHOT_FIELD_POS)
+	{
+		e.Pos[0] += BitReadSigned(r);
+		e.Pos[1] += BitReadSigned(r);
+	}
+	if (e.Changed & SNAPSHOT_FIELD_VEL)
+	{
+		e.Vel[0] += BitReadSigned(r);
+		e.Vel[1] += BitReadSigned(r);
+	}
+	if (e.Changed & SNAPSHOT_FIELD_DIR)
+	{
+		e.Dir = (int)BitRead(r, SNAPSHOT_DIR_BITS);
+	}
+	if (e.Changed & SNAPSHOT_FIELD_STATE)
+	{
+		e.State = (int)BitReadUnsigned(r);
+	}
+	if (e.Changed & SNAPSHOT_FIELD_HEALTH)
+	{
+		e.Health += BitReadSigned(r);
+	}
+	CArrayPushBack(&out->Entities, &e);
+}
+
+static bool ReadDelta(
+	NetSnapshot *out, const NetSnapshotHistory *history, const uint8_t *data,
+	const size_t len)
+{
+	BitReader r = {data + NET_MSG_SIZE, len - NET_MSG_SIZE, 0, false};
+	const uint32_t seq = (uint32_t)BitRead(&r, 32);
+	const uint32_t tick = (uint32_t)BitRead(&r, 32);
+	const uint32_t baseGap = BitReadUnsigned(&r);
+	const uint32_t inputSeq = BitReadUnsigned(&r);
+	const uint32_t inputTicks = BitReadUnsigned(&r);
+	if (r.Err)
+	{
+		return false;
+	}
+	const NetSnapshot *base = NULL;
+	if (baseGap != 0)
+	{
+		base = NetSnapshotHistoryGet(history, seq - baseGap);
+		if (base == NULL || base == out)
+		{
+			LOG(LM_NET, LL_DEBUG, "snapshot(%u) baseline(%u) not available",
+				seq, seq - baseGap);
+			return false;
+		}
+	}
+	const uint32_t ticks = base != NULL ? tick - base->Tick : 0;
+
+	CArrayClear(&out->Entities);
+	out->Seq = 0;
+	size_t i = 0;
+	const size_t baseSize = base != NULL ? base->Entities.size : 0;
+	RecordKey prev = {-1, -1};
+	for (;;)
+	{
+		NetSnapshotEntity key;
+		memset(&key, 0, sizeof key);
+		key.Kind = (NetSnapshotKind)BitRead(&r, SNAPSHOT_KIND_BITS);
+		if (r.Err || key.Kind == SNAPSHOT_KIND_COUNT)
+		{
+			break;
+		}
+		if ((int)key.Kind < prev.Kind)
+		{
+			r.Err = true;
+			break;
+		}
+		if ((int)key.Kind != prev.Kind)
+		{
+			prev.Kind = (int)key.Kind;
+			prev.UID = -1;
+		}
+		key.UID = prev.UID + 1 + (int)BitReadUnsigned(&r);
+		prev.UID = key.UID;
+		const bool removed = BitRead(&r, 1) != 0;
+		if (r.Err)
+		{
+			break;
+		}
+
+		// Entities before this record are unchanged
+		const NetSnapshotEntity *b = NULL;
+		while (i < baseSize)
+		{
+			b = CArrayGet(&base->Entities, i);
+			const int cmp = CompareEntities(b, &key);
+			if (cmp >= 0)
+			{
+				break;
+			}
+			CarryForward(out, b, ticks);
+			b = NULL;
+			i++;
+		}
+		const bool inBase = b != NULL && CompareEntities(b, &key) == 0;
+		if (inBase)
+		{
+			i++;
+		}
+		if (removed)
+		{
+			if (!inBase)
+			{
+				r.Err = true;
+				break;
+			}
+			continue;
+		}
+		ReadEntity(&r, out, inBase ? b : &key, inBase ? ticks : 0);
+	}
+	if (r.Err)
+	{
+		LOG(LM_NET, LL_ERROR, "malformed snapshot(%u)", seq);
+		CArrayClear(&out->Entities);
+		return false;
+	}
+	for (; i < baseSize; i++)
+	{
+		CarryForward(out, CArrayGet(&base->Entities, i), ticks);
+	}
+	out->Seq = seq;
+	out->Tick = tick;
+	out->InputSeq = inputSeq;
+	out->InputTicks = inputTicks;
+	return true;
+}
+
+const NetSnapshotEntity *NetSnapshotFind(
+	const NetSnapshot *s, const NetSnapshotKind kind, const int uid)
+{
+	NetSnapshotEntity key;
+	memset(&key, 0, sizeof key);
+	key.Kind = kind;
+	key.UID = uid;
+	return bsearch(
+		&key, s->Entities.data, s->Entities.size, s->Entities.elemSize,
+		CompareEntities);
+}
+
+static void ApplyActor(const NetSnapshotEntity *e);
+static void ApplyThing(Thing *t, const NetSnapshotEntity *e);
+void NetSnapshotApply(const NetSnapshot *s)
+{
+	CA_FOREACH(const NetSnapshotEntity, e, s->Entities)
+	if (e->Changed == 0)
+	{
+		continue;
+	}
+	switch (e->Kind)
+	{
+	case SNAPSHOT_ACTOR:
+		ApplyActor(e);
+		break;
+	case SNAPSHOT_MOBOBJ: {
+		TMobileObject *obj = MobObjGetByUID(e->UID);
+		if (obj != NULL && obj->isInUse)
+		{
+			ApplyThing(&obj->thing, e);
+		}
+	}
+	break;
+	case SNAPSHOT_PICKUP: {
+		Pickup *p = PickupGetByUID(e->UID);
+		if (p != NULL && p->isInUse)
+		{
+			ApplyThing(&p->thing, e);
+		}
+	}
+	break;
+	default:
+		CASSERT(false, "unknown snapshot entity kind");
+		break;
+	}
+	CA_FOREACH_END()
+}
+static void ApplyActor(const NetSnapshotEntity *e)
+{
+	TActor *a = ActorGetByUID(e->UID);
+	// Local players are simulated here and sent to the server instead
+	if (a == NULL || !a->isInUse || ActorIsLocalPlayer(e->UID))
+	{
+		return;
+	}
+	// Reuse the events that used to carry this state so that their
+	// side effects still happen
+	if (e->Changed & SNAPSHOT_FIELD_DIR)
+	{
+		GameEvent ge = GameEventNew(GAME_EVENT_ACTOR_DIR);
+		ge.u.ActorDir.UID = e->UID;
+		ge.u.ActorDir.Dir = (int32_t)e->Dir;
+		GameEventsEnqueue(&gGameEvents, ge);
+	}
+	if (e->Changed & SNAPSHOT_FIELD_STATE)
+	{
+		GameEvent ge = GameEventNew(GAME_EVENT_ACTOR_STATE);
+		ge.u.ActorState.UID = e->UID;
+		ge.u.ActorState.State = (int32_t)e->State;
+		GameEventsEnqueue(&gGameEvents, ge);
+	}
+	if (e->Changed & SNAPSHOT_FIELD_HEALTH)
+	{
+		// Damage is also sent as events; this only corrects drift
+		a->health = e->Health;
+	}
+}
+static void ApplyThing(Thing *t, const NetSnapshotEntity *e)
+{
+	if (e->Changed & SNAPSHOT_FIELD_POS)
+	{
+		MapTryMoveThing(
+			&gMap, t, Dequantise(e->Pos, NET_SNAPSHOT_POS_SCALE));
+	}
+	if (e->Changed & SNAPSHOT_FIELD_VEL)
+	{
+		t->Vel = Dequantise(e->Vel, NET_SNAPSHOT_VEL_SCALE);
+	}
+}
+
+bool NetSnapshotReplacesEvent(const GameEventType e)
+{
+	switch (e)
+	{
+	case GAME_EVENT_ACTOR_MOVE:
+	case GAME_EVENT_ACTOR_STATE:
+	case GAME_EVENT_ACTOR_DIR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void NetSnapshotHistoryInit(NetSnapshotHistory *h)
+{
+	for (int i = 0; i < NET_SNAPSHOT_HISTORY; i++)
+	{
+		NetSnapshotInit(&h->Snapshots[i]);
+	}
+}
+void NetSnapshotHistoryTerminate(NetSnapshotHistory *h)
+{
+	for (int i = 0; i < NET_SNAPSHOT_HISTORY; i++)
+	{
+		NetSnapshotTerminate(&h->Snapshots[i]);
+	}
+}
+const NetSnapshot *NetSnapshotHistoryGet(
+	const NetSnapshotHistory *h, const uint32_t seq)
+{
+	if (seq == 0)
+	{
+		return NULL;
+	}
+	const NetSnapshot *s = &h->Snapshots[seq % NET_SNAPSHOT_HISTORY];
+	return s->Seq == seq ? s : NULL;
+}
+NetSnapshot *NetSnapshotHistoryNext(NetSnapshotHistory *h, const uint32_t seq)
+{
+	NetSnapshot *s = &h->Snapshots[seq % NET_SNAPSHOT_HISTORY];
+	s->Seq = 0;
+	CArrayClear(&s->Entities);
+	return s;
+}
+const NetSnapshot *NetSnapshotHistoryRead(
+	NetSnapshotHistory *h, const uint8_t *data, const size_t len)
+{
+	if (len < NET_MSG_SIZE || *(const uint32_t *)data != NET_MSG_SNAPSHOT)
+	{
+		return NULL;
+	}
+	// Peek the sequence to find where to store it
+	BitReader r = {data + NET_MSG_SIZE, len - NET_MSG_SIZE, 0, false};
+	const uint32_t seq = (uint32_t)BitRead(&r, 32);
+	if (r.Err || seq == 0)
+	{
+		return NULL;
+	}
+	NetSnapshot *s = NetSnapshotHistoryNext(h, seq);
+	return ReadDelta(s, h, data, len) ? s : NULL;
+}
+bool NetSnapshotHistoryInterpolate(
+	const NetSnapshotHistory *h, const uint32_t tick)
+{
+	// Find the latest snapshot at or before the tick, and the earliest after
+	const NetSnapshot *from = NULL;
+	const NetSnapshot *to = NULL;
+	for (int i = 0; i < NET_SNAPSHOT_HISTORY; i++)
+	{
+		const NetSnapshot *s = &h->Snapshots[i];
+		if (s->Seq == 0)
+		{
+			continue;
+		}
+		if ((int32_t)(s->Tick - tick) <= 0)
+		{
+			if (from == NULL || (int32_t)(s->Tick - from->Tick) > 0)
+			{
+				from = s;
+			}
+		}
+		else if (to == NULL || (int32_t)(s->Tick - to->Tick) < 0)
+		{
+			to = s;
+		}
+	}
+	if (from == NULL)
+	{
+		return false;
+	}
+	// If the next snapshot is late, hold at the last one rather than guess
+	float t = 0;
+	if (to == NULL)
+	{
+		to = from;
+	}
+	else
+	{
+		t = (float)(tick - from->Tick) / (float)(to->Tick - from->Tick);
+	}
+
+	CA_FOREACH(const NetSnapshotEntity, e, to->Entities)
+	if (e->Kind != SNAPSHOT_ACTOR)
+	{
+		break;
+	}
+	TActor *a = ActorGetByUID(e->UID);
+	if (a == NULL || !a->isInUse || ActorIsLocalPlayer(e->UID))
+	{
+		continue;
+	}
+	// Actors that have just come into view have nothing to blend from
+	const NetSnapshotEntity *f = NetSnapshotFind(from, SNAPSHOT_ACTOR, e->UID);
+	const struct vec2 toPos = Dequantise(e->Pos, NET_SNAPSHOT_POS_SCALE);
+	const struct vec2 pos =
+		f != NULL ? svec2_lerp(
+						Dequantise(f->Pos, NET_SNAPSHOT_POS_SCALE), toPos, t)
+				  : toPos;
+	if (svec2_is_nearly_equal(a->Pos, pos, EPSILON_POS))
+	{
+		continue;
+	}
+	NActorMove am = NActorMove_init_default;
+	am.UID = e->UID;
+	am.has_Pos = am.has_MoveVel = true;
+	am.Pos = Vec2ToNet(pos);
+	am.MoveVel = Vec2ToNet(Dequantise(e->Vel, NET_SNAPSHOT_VEL_SCALE));
+	ActorMove(am);
+	CA_FOREACH_END()
+	return true;
+}
@@ -0,0 +1,134 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdint.h>
+
+#include "c_array.h"
+#include "net_util.h"
+
+// Snapshots of the world state that clients need to stay in sync.
+// Each snapshot is sent to a client as a delta against the last snapshot
+// that client acknowledged, so only what has changed takes bandwidth.
+
+// Send a snapshot every this many game ticks
+#define NET_SNAPSHOT_INTERVAL 2
+// Number of recent snapshots kept as potential baselines
+#define NET_SNAPSHOT_HISTORY 32
+// Positions are quantised to 1/16th of a pixel
+#define NET_SNAPSHOT_POS_SCALE 16
+// Velocities are quantised to 1/256th of a pixel per tick
+#define NET_SNAPSHOT_VEL_SCALE 256
+
+typedef enum
+{
+	SNAPSHOT_ACTOR,
+	SNAPSHOT_MOBOBJ,
+	SNAPSHOT_PICKUP,
+	SNAPSHOT_KIND_COUNT
+} NetSnapshotKind;
+
+// Bitfield of entity fields
+#define SNAPSHOT_FIELD_POS 0x01
+#define SNAPSHOT_FIELD_VEL 0x02
+#define SNAPSHOT_FIELD_DIR 0x04
+#define SNAPSHOT_FIELD_STATE 0x08
+#define SNAPSHOT_FIELD_HEALTH 0x10
+
+typedef struct
+{
+	NetSnapshotKind Kind;
+	int UID;
+	// Quantised
+	int32_t Pos[2];
+	int32_t Vel[2];
+	// Actors only
+	int Dir;
+	int State;
+	int Health;
+	// Fields that were sent in the delta this entity was decoded from
+	uint8_t Changed;
+} NetSnapshotEntity;
+
+typedef struct
+{
+	// Sequence number, starting from 1; 0 means unset
+	uint32_t Seq;
+	// Game ticks, used to extrapolate positions between snapshots
+	uint32_t Tick;
+	// Last input sequence received from the client, and ticks since, so
+	// that the client can find which of its predictions this matches
+	uint32_t InputSeq;
+	uint32_t InputTicks;
+	CArray Entities; // of NetSnapshotEntity, sorted by kind then UID
+} NetSnapshot;
+
+typedef struct
+{
+	NetSnapshot Snapshots[NET_SNAPSHOT_HISTORY];
+} NetSnapshotHistory;
+
+void NetSnapshotInit(NetSnapshot *s);
+void NetSnapshotTerminate(NetSnapshot *s);
+NetSnapshotEntity NetSnapshotEntityNew(
+	const NetSnapshotKind kind, const int uid, const struct vec2 pos,
+	const struct vec2 vel);
+struct vec2 NetSnapshotEntityPos(const NetSnapshotEntity *e);
+// Entities must be added in kind then UID order
+void NetSnapshotAdd(NetSnapshot *s, const NetSnapshotEntity *e);
+// Capture the current actors, mobile objects and pickups
+void NetSnapshotFromWorld(
+	NetSnapshot *s, const uint32_t seq, const uint32_t tick);
+
+// Write a snapshot packet for cur, as a delta against base if not NULL
+void NetSnapshotWriteDelta(
+	CArray *out, const NetSnapshot *base, const NetSnapshot *cur);
+const NetSnapshotEntity *NetSnapshotFind(
+	const NetSnapshot *s, const NetSnapshotKind kind, const int uid);
+// Update the world with entities that changed in this snapshot.
+// Actor positions are not applied; see NetSnapshotHistoryInterpolate.
+void NetSnapshotApply(const NetSnapshot *s);
+// Whether this event no longer needs to be broadcast, as its state is
+// already carried in snapshots
+bool NetSnapshotReplacesEvent(const GameEventType e);
+
+void NetSnapshotHistoryInit(NetSnapshotHistory *h);
+void NetSnapshotHistoryTerminate(NetSnapshotHistory *h);
+// Get the snapshot with this sequence number, or NULL if no longer kept
+const NetSnapshot *NetSnapshotHistoryGet(
+	const NetSnapshotHistory *h, const uint32_t seq);
+// Get the slot to store the snapshot with this sequence number
+NetSnapshot *NetSnapshotHistoryNext(NetSnapshotHistory *h, const uint32_t seq);
+// Read a snapshot packet into history, using the baseline it refers to.
+// Returns NULL if the baseline is not available or the packet is malformed.
+const NetSnapshot *NetSnapshotHistoryRead(
+	NetSnapshotHistory *h, const uint8_t *data, const size_t len);
+// Move remote actors to where they were at this tick, between the two
+// snapshots either side of it. Returns false if there aren't any.
+bool NetSnapshotHistoryInterpolate(
+	const NetSnapshotHistory *h, const uint32_t tick);
@@ -0,0 +1,150 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "net_stats.h"
+
+#include "log.h"
+#include "net_util.h"
+
+void NetStatsInit(NetStats *s)
+{
+	memset(s, 0, sizeof *s);
+}
+
+static int StatsIndex(const uint32_t msgId)
+{
+	switch (msgId)
+	{
+	case NET_MSG_SNAPSHOT:
+		return NET_STATS_SNAPSHOT;
+	case NET_MSG_SNAPSHOT_ACK:
+		return NET_STATS_SNAPSHOT_ACK;
+	case NET_MSG_WORLD_START:
+	case NET_MSG_WORLD:
+		return NET_STATS_WORLD;
+	default:
+		// -1 if unknown
+		return msgId <= GAME_EVENT_MISSION_END ? (int)msgId : -1;
+	}
+}
+typedef struct
+{
+	NetStats *s;
+	bool out;
+} CountData;
+static void Count(const CountData *cData, const ENetPacket *packet)
+{
+	const int idx = StatsIndex(*(const uint32_t *)packet->data);
+	if (idx < 0)
+	{
+		return;
+	}
+	NetStatsCounter *c = cData->out ? &cData->s->Out[idx] : &cData->s->In[idx];
+	c->Count++;
+	c->Bytes += (uint32_t)packet->dataLength;
+}
+static void CountMsg(ENetPacket *packet, void *data)
+{
+	Count(data, packet);
+}
+void NetStatsCount(NetStats *s, const bool out, const ENetPacket *packet)
+{
+	if (s == NULL || packet == NULL || packet->dataLength < NET_MSG_SIZE)
+	{
+		return;
+	}
+	CountData cData;
+	cData.s = s;
+	cData.out = out;
+	if (!NetBatchUnpack(packet, CountMsg, &cData))
+	{
+		Count(&cData, packet);
+	}
+}
+
+NetStatsCounter NetStatsTotal(const NetStatsCounter *counters)
+{
+	NetStatsCounter total;
+	memset(&total, 0, sizeof total);
+	for (int i = 0; i < NET_STATS_TYPES; i++)
+	{
+		total.Count += counters[i].Count;
+		total.Bytes += counters[i].Bytes;
+	}
+	return total;
+}
+
+NetPeerStats NetPeerStatsGet(const ENetPeer *peer)
+{
+	NetPeerStats ps;
+	ps.RTT = peer->roundTripTime;
+	ps.RTTVariance = peer->roundTripTimeVariance;
+	ps.Loss = (float)peer->packetLoss / ENET_PEER_PACKET_LOSS_SCALE;
+	ps.PacketsSent = peer->packetsSent;
+	// ENet counts a reliable packet as lost each time it times out and is
+	// sent again
+	ps.Retransmits = peer->packetsLost;
+	return ps;
+}
+
+static const char *StatsTypeName(const int idx, char *buf)
+{
+	switch (idx)
+	{
+	case NET_STATS_SNAPSHOT:
+		return "snapshot";
+	case NET_STATS_SNAPSHOT_ACK:
+		return "snapshot ack";
+	case NET_STATS_WORLD:
+		return "world";
+	default:
+		sprintf(buf, "msg(%d)", idx);
+		return buf;
+	}
+}
+void NetStatsLog(const NetStats *s, const ENetPeer *peer, const char *name)
+{
+	const NetStatsCounter in = NetStatsTotal(s->In);
+	const NetStatsCounter out = NetStatsTotal(s->Out);
+	const NetPeerStats ps = NetPeerStatsGet(peer);
+	LOG(LM_NET, LL_INFO,
+		"%s: rtt(%ums +/-%u) loss(%.1f%%) retransmits(%u/%u) "
+		"in(%u msgs %u bytes) out(%u msgs %u bytes)",
+		name, ps.RTT, ps.RTTVariance, ps.Loss * 100, ps.Retransmits,
+		ps.PacketsSent, in.Count, in.Bytes, out.Count, out.Bytes);
+	for (int i = 0; i < NET_STATS_TYPES; i++)
+	{
+		if (s->In[i].Count == 0 && s->Out[i].Count == 0)
+		{
+			continue;
+		}
+		char buf[32];
+		LOG(LM_NET, LL_DEBUG, "%s: %s in(%u msgs %u bytes) out(%u msgs %u bytes)",
+			name, StatsTypeName(i, buf), s->In[i].Count, s->In[i].Bytes,
+			s->Out[i].Count, s->Out[i].Bytes);
+	}
+}
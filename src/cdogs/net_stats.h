@@ -0,0 +1,73 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdint.h>
+
+#include <enet/enet.h>
+
+#include "game_events.h"
+
+// Counts of messages sent and received, per message type. Message types that
+// aren't game events are counted after them.
+#define NET_STATS_SNAPSHOT (GAME_EVENT_MISSION_END + 1)
+#define NET_STATS_SNAPSHOT_ACK (GAME_EVENT_MISSION_END + 2)
+#define NET_STATS_WORLD (GAME_EVENT_MISSION_END + 3)
+#define NET_STATS_TYPES (GAME_EVENT_MISSION_END + 4)
+
+typedef struct
+{
+	uint32_t Count;
+	uint32_t Bytes;
+} NetStatsCounter;
+
+typedef struct
+{
+	NetStatsCounter In[NET_STATS_TYPES];
+	NetStatsCounter Out[NET_STATS_TYPES];
+} NetStats;
+
+// Link quality, as measured by ENet
+typedef struct
+{
+	uint32_t RTT;
+	uint32_t RTTVariance;
+	// Fraction of reliable packets lost, from 0 to 1
+	float Loss;
+	// Packets sent and resent since ENet last measured loss
+	uint32_t PacketsSent;
+	uint32_t Retransmits;
+} NetPeerStats;
+
+void NetStatsInit(NetStats *s);
+// Count each message in a packet, which may be a batch; s may be NULL
+void NetStatsCount(NetStats *s, const bool out, const ENetPacket *packet);
+NetStatsCounter NetStatsTotal(const NetStatsCounter *counters);
+NetPeerStats NetPeerStatsGet(const ENetPeer *peer);
+// Log totals and link quality, and the per-type counts at debug level
+void NetStatsLog(const NetStats *s, const ENetPeer *peer, const char *name);
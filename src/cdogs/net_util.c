@@ -28,22 +28,134 @@
 */
 #include "net_util.h"
 
+#include "cwolfmap/zip/zip.h"
+#include "log.h"
 #include "proto/nanopb/pb_decode.h"
 #include "proto/nanopb/pb_encode.h"
 
+uint32_t NetChannelFlags(const NetChannel c)
+{
+	switch (c)
+	{
+	case NET_CHANNEL_STATE:
+		// No flags means unreliable-sequenced in ENet
+		return 0;
+	default:
+		return ENET_PACKET_FLAG_RELIABLE;
+	}
+}
+
+// Packet data comes from pools of power-of-two sized blocks, which are
+// returned when ENet is done with the packet
+#define NET_POOL_MIN_SIZE 64
+#define NET_POOL_BUCKETS 10
+// Most free blocks kept per size
+#define NET_POOL_MAX_FREE 64
+static CArray sPacketPool[NET_POOL_BUCKETS]; // of uint8_t *
+static bool sPacketPoolInit = false;
+
+static int PoolBucket(const size_t size)
+{
+	int bucket = 0;
+	while (bucket < NET_POOL_BUCKETS &&
+		   ((size_t)NET_POOL_MIN_SIZE << bucket) < size)
+	{
+		bucket++;
+	}
+	// NET_POOL_BUCKETS if too big to pool
+	return bucket;
+}
+static void PacketFree(ENetPacket *packet);
+ENetPacket *NetPacketNew(const size_t size, const NetChannel channel)
+{
+	if (!sPacketPoolInit)
+	{
+		for (int i = 0; i < NET_POOL_BUCKETS; i++)
+		{
+			CArrayInit(&sPacketPool[i], sizeof(uint8_t *));
+		}
+		sPacketPoolInit = true;
+	}
+	const int bucket = PoolBucket(size);
+	uint8_t *data;
+	if (bucket < NET_POOL_BUCKETS && sPacketPool[bucket].size > 0)
+	{
+		CArray *pool = &sPacketPool[bucket];
+		data = *(uint8_t **)CArrayGet(pool, pool->size - 1);
+		CArrayPopBack(pool);
+	}
+	else
+	{
+		CMALLOC(
+			data, bucket < NET_POOL_BUCKETS
+					  ? (size_t)NET_POOL_MIN_SIZE << bucket
+					  : size);
+	}
+	ENetPacket *packet = enet_packet_create(
+		data, size, NetChannelFlags(channel) | ENET_PACKET_FLAG_NO_ALLOCATE);
+	if (packet == NULL)
+	{
+		CFREE(data);
+		return NULL;
+	}
+	packet->freeCallback = PacketFree;
+	packet->userData = (void *)(intptr_t)bucket;
+	return packet;
+}
+static void PacketFree(ENetPacket *packet)
+{
+	const int bucket = (int)(intptr_t)packet->userData;
+	if (sPacketPoolInit && bucket < NET_POOL_BUCKETS &&
+		sPacketPool[bucket].size < NET_POOL_MAX_FREE)
+	{
+		CArrayPushBack(&sPacketPool[bucket], &packet->data);
+	}
+	else
+	{
+		CFREE(packet->data);
+	}
+}
+void NetPacketPoolTerminate(void)
+{
+	if (!sPacketPoolInit)
+	{
+		return;
+	}
+	for (int i = 0; i < NET_POOL_BUCKETS; i++)
+	{
+		CA_FOREACH(uint8_t *, data, sPacketPool[i])
+		CFREE(*data);
+		CA_FOREACH_END()
+		CArrayTerminate(&sPacketPool[i]);
+	}
+	sPacketPoolInit = false;
+}
+
 ENetPacket *NetEncode(const GameEventType e, const void *data)
 {
-	uint8_t buffer[1024];
-	pb_ostream_t stream = pb_ostream_from_buffer(buffer, sizeof buffer);
 	const pb_msgdesc_t *fields = GameEventGetEntry(e).Fields;
-	const bool status =
-		(data && fields) ? pb_encode(&stream, fields, data) : true;
-	CASSERT(status, "Failed to encode pb");
-	int msgId = (int)e;
-	ENetPacket *packet = enet_packet_create(
-		&msgId, NET_MSG_SIZE + stream.bytes_written,
-		ENET_PACKET_FLAG_RELIABLE);
-	memcpy(packet->data + NET_MSG_SIZE, buffer, stream.bytes_written);
+	size_t pbSize = 0;
+	if (data && fields && !pb_get_encoded_size(&pbSize, fields, data))
+	{
+		CASSERT(false, "Failed to size pb");
+		return NULL;
+	}
+	ENetPacket *packet =
+		NetPacketNew(NET_MSG_SIZE + pbSize, NET_CHANNEL_RELIABLE);
+	if (packet == NULL)
+	{
+		return NULL;
+	}
+	const uint32_t msgId = (uint32_t)e;
+	memcpy(packet->data, &msgId, NET_MSG_SIZE);
+	if (data && fields)
+	{
+		// Encode in place; the packet is exactly the encoded size
+		pb_ostream_t stream =
+			pb_ostream_from_buffer(packet->data + NET_MSG_SIZE, pbSize);
+		const bool status = pb_encode(&stream, fields, data);
+		CASSERT(status, "Failed to encode pb");
+	}
 	return packet;
 }
 
@@ -56,6 +168,395 @@ bool NetDecode(ENetPacket *packet, void *dest, const pb_msgdesc_t *fields)
 	return status;
 }
 
+void NetSend(ENetPeer *peer, const GameEventType e, const void *data)
+{
+	NetSendPacket(peer, NULL, NET_CHANNEL_RELIABLE, NetEncode(e, data));
+}
+
+void NetSendPacket(
+	ENetPeer *peer, NetStats *stats, const NetChannel channel,
+	ENetPacket *packet)
+{
+	if (packet == NULL)
+	{
+		return;
+	}
+	NetStatsCount(stats, true, packet);
+	enet_peer_send(peer, (enet_uint8)channel, packet);
+}
+
+void NetBatchInit(NetBatch *b, const NetChannel channel)
+{
+	const uint32_t msgId = NET_MSG_BATCH;
+	memcpy(b->Data, &msgId, NET_MSG_SIZE);
+	b->Size = NET_MSG_SIZE;
+	b->Channel = channel;
+	b->Stats = NULL;
+}
+void NetBatchAdd(
+	NetBatch *b, ENetPeer *peer, const GameEventType e, const void *data)
+{
+	const pb_msgdesc_t *fields = GameEventGetEntry(e).Fields;
+	size_t pbSize = 0;
+	if (data && fields && !pb_get_encoded_size(&pbSize, fields, data))
+	{
+		CASSERT(false, "Failed to size pb");
+		return;
+	}
+	const size_t msgSize = NET_MSG_SIZE + pbSize;
+	if (NET_MSG_SIZE + NET_BATCH_LEN_SIZE + msgSize > NET_BATCH_MAX)
+	{
+		// Too big to batch; send on its own, keeping message order
+		NetBatchFlush(b, peer);
+		NetSendPacket(
+			peer, b->Stats, NET_CHANNEL_RELIABLE, NetEncode(e, data));
+		return;
+	}
+	if (b->Size + NET_BATCH_LEN_SIZE + msgSize > NET_BATCH_MAX)
+	{
+		NetBatchFlush(b, peer);
+	}
+
+	uint8_t *dst = b->Data + b->Size;
+	dst[0] = (uint8_t)(msgSize & 0xff);
+	dst[1] = (uint8_t)(msgSize >> 8);
+	dst += NET_BATCH_LEN_SIZE;
+	const uint32_t msgId = (uint32_t)e;
+	memcpy(dst, &msgId, NET_MSG_SIZE);
+	dst += NET_MSG_SIZE;
+	if (data && fields)
+	{
+		pb_ostream_t stream = pb_ostream_from_buffer(dst, pbSize);
+		const bool status = pb_encode(&stream, fields, data);
+		CASSERT(status, "Failed to encode pb");
+	}
+	b->Size += NET_BATCH_LEN_SIZE + msgSize;
+}
+void NetBatchFlush(NetBatch *b, ENetPeer *peer)
+{
+	if (b->Size <= NET_MSG_SIZE)
+	{
+		return;
+	}
+	ENetPacket *packet = NetPacketNew(b->Size, b->Channel);
+	if (packet != NULL)
+	{
+		memcpy(packet->data, b->Data, b->Size);
+		NetSendPacket(peer, b->Stats, b->Channel, packet);
+	}
+	b->Size = NET_MSG_SIZE;
+}
+static bool UnpackMessages(
+	uint8_t *buf, const size_t size, const size_t lenSize,
+	void (*func)(ENetPacket *, void *), void *data);
+bool NetBatchUnpack(
+	const ENetPacket *packet, void (*func)(ENetPacket *, void *), void *data)
+{
+	if (packet->dataLength < NET_MSG_SIZE ||
+		*(const uint32_t *)packet->data != NET_MSG_BATCH)
+	{
+		return false;
+	}
+	if (!UnpackMessages(
+			packet->data + NET_MSG_SIZE, packet->dataLength - NET_MSG_SIZE,
+			NET_BATCH_LEN_SIZE, func, data))
+	{
+		LOG(LM_NET, LL_ERROR, "malformed batch packet");
+	}
+	return true;
+}
+// Call func with each message, each prefixed by a little-endian length of
+// lenSize bytes. Returns false if the messages are malformed.
+static bool UnpackMessages(
+	uint8_t *buf, const size_t size, const size_t lenSize,
+	void (*func)(ENetPacket *, void *), void *data)
+{
+	size_t offset = 0;
+	while (offset + lenSize <= size)
+	{
+		size_t msgSize = 0;
+		for (size_t i = 0; i < lenSize; i++)
+		{
+			msgSize |= (size_t)buf[offset + i] << (8 * i);
+		}
+		offset += lenSize;
+		if (msgSize < NET_MSG_SIZE || msgSize > size - offset)
+		{
+			return false;
+		}
+		// Present each message as if it were its own packet
+		ENetPacket msg;
+		memset(&msg, 0, sizeof msg);
+		msg.data = buf + offset;
+		msg.dataLength = msgSize;
+		func(&msg, data);
+		offset += msgSize;
+	}
+	return offset == size;
+}
+
+// Name of the single zip entry the world is compressed into
+#define NET_WORLD_ENTRY "world"
+
+void NetWorldBlobInit(NetWorldBlob *b, const uint32_t id)
+{
+	b->Id = id;
+	CArrayInit(&b->Data, sizeof(uint8_t));
+	CArrayInit(&b->Compressed, sizeof(uint8_t));
+}
+void NetWorldBlobTerminate(NetWorldBlob *b)
+{
+	CArrayTerminate(&b->Data);
+	CArrayTerminate(&b->Compressed);
+}
+void NetWorldBlobAdd(NetWorldBlob *b, const GameEventType e, const void *data)
+{
+	const pb_msgdesc_t *fields = GameEventGetEntry(e).Fields;
+	size_t pbSize = 0;
+	if (data && fields && !pb_get_encoded_size(&pbSize, fields, data))
+	{
+		CASSERT(false, "Failed to size pb");
+		return;
+	}
+	const size_t msgSize = NET_MSG_SIZE + pbSize;
+	const size_t offset = b->Data.size;
+	CArrayResize(&b->Data, offset + NET_WORLD_LEN_SIZE + msgSize, NULL);
+
+	uint8_t *dst = (uint8_t *)b->Data.data + offset;
+	for (size_t i = 0; i < NET_WORLD_LEN_SIZE; i++)
+	{
+		dst[i] = (uint8_t)(msgSize >> (8 * i));
+	}
+	dst += NET_WORLD_LEN_SIZE;
+	const uint32_t msgId = (uint32_t)e;
+	memcpy(dst, &msgId, NET_MSG_SIZE);
+	dst += NET_MSG_SIZE;
+	if (data && fields)
+	{
+		pb_ostream_t stream = pb_ostream_from_buffer(dst, pbSize);
+		const bool status = pb_encode(&stream, fields, data);
+		CASSERT(status, "Failed to encode pb");
+	}
+}
+bool NetWorldBlobCompress(NetWorldBlob *b)
+{
+	bool ok = false;
+	void *buf = NULL;
+	size_t bufSize = 0;
+	struct zip_t *zip =
+		zip_stream_open(NULL, 0, ZIP_DEFAULT_COMPRESSION_LEVEL, 'w');
+	if (zip == NULL)
+	{
+		goto bail;
+	}
+	if (zip_entry_open(zip, NET_WORLD_ENTRY) < 0 ||
+		zip_entry_write(zip, b->Data.data, b->Data.size) < 0 ||
+		zip_entry_close(zip) < 0 || zip_stream_copy(zip, &buf, &bufSize) < 0)
+	{
+		goto bail;
+	}
+	CArrayResize(&b->Compressed, bufSize, NULL);
+	memcpy(b->Compressed.data, buf, bufSize);
+	LOG(LM_NET, LL_DEBUG, "world(%u) compressed %u to %u bytes",
+		(unsigned)b->Id, (unsigned)b->Data.size, (unsigned)bufSize);
+	ok = true;
+
+bail:
+	if (!ok)
+	{
+		LOG(LM_NET, LL_ERROR, "failed to compress world(%u)", (unsigned)b->Id);
+	}
+	free(buf);
+	zip_stream_close(zip);
+	return ok;
+}
+static ENetPacket *WorldPacketNew(
+	const NetWorldBlob *b, const uint32_t msgId, const size_t offset,
+	const size_t size, const NetChannel channel)
+{
+	ENetPacket *packet =
+		NetPacketNew(NET_MSG_SIZE + sizeof(NetWorldHeader) + size, channel);
+	if (packet == NULL)
+	{
+		return NULL;
+	}
+	NetWorldHeader h;
+	h.Id = b->Id;
+	h.CompressedSize = (uint32_t)b->Compressed.size;
+	h.Size = (uint32_t)b->Data.size;
+	h.Offset = (uint32_t)offset;
+	memcpy(packet->data, &msgId, NET_MSG_SIZE);
+	memcpy(packet->data + NET_MSG_SIZE, &h, sizeof h);
+	if (size > 0)
+	{
+		memcpy(
+			packet->data + NET_MSG_SIZE + sizeof h,
+			(const uint8_t *)b->Compressed.data + offset, size);
+	}
+	return packet;
+}
+ENetPacket *NetWorldBlobStart(const NetWorldBlob *b)
+{
+	return WorldPacketNew(b, NET_MSG_WORLD_START, 0, 0, NET_CHANNEL_RELIABLE);
+}
+ENetPacket *NetWorldBlobFragment(const NetWorldBlob *b, const size_t offset)
+{
+	const size_t size =
+		MIN(b->Compressed.size - offset, (size_t)NET_WORLD_FRAGMENT_MAX);
+	return WorldPacketNew(b, NET_MSG_WORLD, offset, size, NET_CHANNEL_WORLD);
+}
+void NetWorldBlobSend(const NetWorldBlob *b, ENetPeer *peer, NetStats *stats)
+{
+	NetSendPacket(peer, stats, NET_CHANNEL_RELIABLE, NetWorldBlobStart(b));
+	for (size_t offset = 0; offset < b->Compressed.size;
+		 offset += NET_WORLD_FRAGMENT_MAX)
+	{
+		NetSendPacket(
+			peer, stats, NET_CHANNEL_WORLD, NetWorldBlobFragment(b, offset));
+	}
+}
+
+void NetWorldTransferInit(NetWorldTransfer *t)
+{
+	memset(t, 0, sizeof *t);
+	CArrayInit(&t->Data, sizeof(uint8_t));
+	CArrayInit(&t->Fragments, sizeof(uint8_t));
+}
+void NetWorldTransferTerminate(NetWorldTransfer *t)
+{
+	CArrayTerminate(&t->Data);
+	CArrayTerminate(&t->Fragments);
+}
+void NetWorldTransferReset(NetWorldTransfer *t)
+{
+	t->Active = false;
+	t->Started = false;
+	t->Received = 0;
+	CArrayClear(&t->Data);
+	CArrayClear(&t->Fragments);
+}
+void NetWorldTransferAdd(NetWorldTransfer *t, const ENetPacket *packet)
+{
+	if (packet->dataLength < NET_MSG_SIZE + sizeof(NetWorldHeader))
+	{
+		LOG(LM_NET, LL_ERROR, "malformed world packet");
+		return;
+	}
+	uint32_t msgId;
+	memcpy(&msgId, packet->data, NET_MSG_SIZE);
+	NetWorldHeader h;
+	memcpy(&h, packet->data + NET_MSG_SIZE, sizeof h);
+	if (h.CompressedSize > NET_WORLD_SIZE_MAX || h.Size > NET_WORLD_SIZE_MAX)
+	{
+		LOG(LM_NET, LL_ERROR,
+			"world(%u) too large compressed(%u) size(%u)", (unsigned)h.Id,
+			(unsigned)h.CompressedSize, (unsigned)h.Size);
+		return;
+	}
+	if (!t->Active || t->Id != h.Id)
+	{
+		// A new world
+		NetWorldTransferReset(t);
+		t->Id = h.Id;
+		t->Active = true;
+		t->Size = h.Size;
+		CArrayResize(&t->Data, h.CompressedSize, NULL);
+		const size_t fragments =
+			(h.CompressedSize + NET_WORLD_FRAGMENT_MAX - 1) /
+			NET_WORLD_FRAGMENT_MAX;
+		CArrayResize(&t->Fragments, (fragments + 7) / 8, NULL);
+		if (t->Fragments.size > 0)
+		{
+			CArrayFillZero(&t->Fragments);
+		}
+	}
+	else if (h.CompressedSize != t->Data.size || h.Size != t->Size)
+	{
+		LOG(LM_NET, LL_ERROR, "mismatched world(%u) header", (unsigned)h.Id);
+		return;
+	}
+	if (msgId == NET_MSG_WORLD_START)
+	{
+		LOG(LM_NET, LL_DEBUG, "recv world(%u) start size(%u)", (unsigned)h.Id,
+			(unsigned)h.CompressedSize);
+		t->Started = true;
+		return;
+	}
+	// Fragments are whole multiples of the max size, bar the last
+	const size_t size =
+		packet->dataLength - NET_MSG_SIZE - sizeof(NetWorldHeader);
+	if (h.Offset % NET_WORLD_FRAGMENT_MAX != 0 ||
+		h.Offset >= h.CompressedSize ||
+		size != MIN(h.CompressedSize - h.Offset,
+					(uint32_t)NET_WORLD_FRAGMENT_MAX))
+	{
+		LOG(LM_NET, LL_ERROR, "malformed world fragment");
+		return;
+	}
+	// Count each fragment once, in case it arrives again
+	const size_t fragment = h.Offset / NET_WORLD_FRAGMENT_MAX;
+	uint8_t *bits = CArrayGet(&t->Fragments, fragment / 8);
+	const uint8_t bit = (uint8_t)(1 << (fragment % 8));
+	if (*bits & bit)
+	{
+		return;
+	}
+	*bits |= bit;
+	memcpy(
+		(uint8_t *)t->Data.data + h.Offset,
+		packet->data + NET_MSG_SIZE + sizeof(NetWorldHeader), size);
+	t->Received += size;
+}
+bool NetWorldTransferIsComplete(const NetWorldTransfer *t)
+{
+	return t->Active && t->Started && t->Received >= t->Data.size;
+}
+float NetWorldTransferProgress(const NetWorldTransfer *t)
+{
+	if (!t->Active || t->Data.size == 0)
+	{
+		return 0;
+	}
+	return (float)t->Received / t->Data.size;
+}
+bool NetWorldTransferUnpack(
+	NetWorldTransfer *t, void (*func)(ENetPacket *, void *), void *data)
+{
+	bool ok = false;
+	uint8_t *buf = NULL;
+	struct zip_t *zip = zip_stream_open(t->Data.data, t->Data.size, 0, 'r');
+	if (zip == NULL || zip_entry_open(zip, NET_WORLD_ENTRY) < 0)
+	{
+		goto bail;
+	}
+	// Check the entry is the size the header claimed before allocating for it
+	if (zip_entry_size(zip) != (unsigned long long)t->Size)
+	{
+		LOG(LM_NET, LL_ERROR, "world(%u) size(%u) mismatch",
+			(unsigned)t->Id, (unsigned)t->Size);
+		goto bail;
+	}
+	CMALLOC(buf, t->Size);
+	if (zip_entry_noallocread(zip, buf, t->Size) != (ssize_t)t->Size)
+	{
+		goto bail;
+	}
+	zip_entry_close(zip);
+	LOG(LM_NET, LL_DEBUG, "unpack world(%u) size(%u)", (unsigned)t->Id,
+		(unsigned)t->Size);
+	ok = UnpackMessages(buf, t->Size, NET_WORLD_LEN_SIZE, func, data);
+
+bail:
+	if (!ok)
+	{
+		LOG(LM_NET, LL_ERROR, "failed to unpack world(%u)", (unsigned)t->Id);
+	}
+	CFREE(buf);
+	zip_stream_close(zip);
+	NetWorldTransferReset(t);
+	return ok;
+}
+
 typedef struct
 {
 	map_t src;
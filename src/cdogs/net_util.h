@@ -36,17 +36,141 @@
 #include "campaigns.h"
 #include "game_events.h"
 #include "map.h"
+#include "net_stats.h"
 #include "player.h"
 
-#define NET_PROTOCOL_VERSION 16
+#define NET_PROTOCOL_VERSION 22
 
 // Messages
 
 // All messages start with 4 bytes message type followed by the message struct
 #define NET_MSG_SIZE sizeof(uint32_t)
 
+// Batched packets start with this message type, followed by any number of
+// messages, each prefixed by a 2-byte little-endian length
+#define NET_MSG_BATCH 0xFFFFFFFFu
+#define NET_BATCH_LEN_SIZE sizeof(uint16_t)
+// Keep batches within a typical MTU to avoid fragmentation
+#define NET_BATCH_MAX 1200
+
+// World snapshots are bit-packed rather than pb; see net_snapshot.h
+#define NET_MSG_SNAPSHOT 0xFFFFFFFEu
+// Client acknowledgement of a snapshot, followed by its 4-byte sequence
+#define NET_MSG_SNAPSHOT_ACK 0xFFFFFFFDu
+// The whole world state is sent as one compressed blob of batched messages.
+// The start is marked on the reliable channel, and messages after it are held
+// back until the fragments, sent on the world channel, have all arrived.
+// Both are followed by a NetWorldHeader; fragments then have their data.
+#define NET_MSG_WORLD_START 0xFFFFFFFCu
+#define NET_MSG_WORLD 0xFFFFFFFBu
+#define NET_WORLD_FRAGMENT_MAX 1024
+// Messages in the world are prefixed by a 4-byte little-endian length, as
+// they aren't bounded by a batch's size
+#define NET_WORLD_LEN_SIZE sizeof(uint32_t)
+// Largest world accepted from the server, compressed or not; headers claiming
+// more than this are rejected rather than allocated
+#define NET_WORLD_SIZE_MAX (64 * 1024 * 1024)
+// LAN discovery query, sent over UDP to the listen port; the server echoes
+// Time back in its NServerInfo reply so the client can measure ping
+#define NET_MSG_DISCOVER 0xFFFFFFFAu
+typedef struct
+{
+	uint32_t MsgId;
+	uint32_t ProtocolVersion;
+	uint32_t Time;
+} NetDiscoverQuery;
+// Most discovery packets handled per poll, so a flood can't stall the game
+#define NET_DISCOVERY_MAX_PER_POLL 64
+
+// ENet packet flags for messages sent on a channel
+uint32_t NetChannelFlags(const NetChannel c);
+
+// Create a packet of this size, with data from a pool; the data is freed
+// back to the pool when ENet destroys the packet
+ENetPacket *NetPacketNew(const size_t size, const NetChannel channel);
+void NetPacketPoolTerminate(void);
+// Encode a message straight into a new packet; messages of any size can be
+// encoded
 ENetPacket *NetEncode(const GameEventType e, const void *data);
 bool NetDecode(ENetPacket *packet, void *dest, const pb_msgdesc_t *fields);
+// Send a single message immediately, on the channel for its type
+void NetSend(ENetPeer *peer, const GameEventType e, const void *data);
+// Send a packet, counting it in stats if not NULL
+void NetSendPacket(
+	ENetPeer *peer, NetStats *stats, const NetChannel channel,
+	ENetPacket *packet);
+
+// Outgoing messages for a single peer and channel, sent together when flushed
+typedef struct
+{
+	uint8_t Data[NET_BATCH_MAX];
+	size_t Size;
+	NetChannel Channel;
+	// Messages sent are counted here, if set
+	NetStats *Stats;
+} NetBatch;
+void NetBatchInit(NetBatch *b, const NetChannel channel);
+// Add message to batch, flushing first if it doesn't fit
+void NetBatchAdd(
+	NetBatch *b, ENetPeer *peer, const GameEventType e, const void *data);
+void NetBatchFlush(NetBatch *b, ENetPeer *peer);
+// If packet is a batch, call func with each of its messages and return true
+bool NetBatchUnpack(
+	const ENetPacket *packet, void (*func)(ENetPacket *, void *), void *data);
+
+typedef struct
+{
+	uint32_t Id;
+	uint32_t CompressedSize;
+	uint32_t Size;
+	uint32_t Offset;
+} NetWorldHeader;
+
+// World state built up by the server, as length-prefixed messages that are
+// then compressed
+typedef struct
+{
+	uint32_t Id;
+	CArray Data;	   // of uint8_t
+	CArray Compressed; // of uint8_t
+} NetWorldBlob;
+void NetWorldBlobInit(NetWorldBlob *b, const uint32_t id);
+void NetWorldBlobTerminate(NetWorldBlob *b);
+void NetWorldBlobAdd(NetWorldBlob *b, const GameEventType e, const void *data);
+// Call once all the messages have been added
+bool NetWorldBlobCompress(NetWorldBlob *b);
+ENetPacket *NetWorldBlobStart(const NetWorldBlob *b);
+ENetPacket *NetWorldBlobFragment(const NetWorldBlob *b, const size_t offset);
+// Send the start marker and all the fragments; any batched reliable messages
+// must be flushed first
+void NetWorldBlobSend(const NetWorldBlob *b, ENetPeer *peer, NetStats *stats);
+
+// World state being received by the client
+typedef struct
+{
+	uint32_t Id;
+	// Whether any part of the world has arrived and it is yet to be unpacked
+	bool Active;
+	// Whether the start marker has arrived; fragments may arrive before it
+	bool Started;
+	uint32_t Size;
+	CArray Data; // of uint8_t; compressed
+	// Bitmap of the fragments received, by offset / NET_WORLD_FRAGMENT_MAX
+	CArray Fragments; // of uint8_t
+	size_t Received;
+} NetWorldTransfer;
+void NetWorldTransferInit(NetWorldTransfer *t);
+void NetWorldTransferTerminate(NetWorldTransfer *t);
+void NetWorldTransferReset(NetWorldTransfer *t);
+// Add a start marker or fragment packet
+void NetWorldTransferAdd(NetWorldTransfer *t, const ENetPacket *packet);
+bool NetWorldTransferIsComplete(const NetWorldTransfer *t);
+// Fraction of the world received, from 0 to 1
+float NetWorldTransferProgress(const NetWorldTransfer *t);
+// Decompress the complete world and call func with each of its messages,
+// then reset the transfer
+bool NetWorldTransferUnpack(
+	NetWorldTransfer *t, void (*func)(ENetPacket *, void *), void *data);
 
 NPlayerData NMakePlayerData(const PlayerData *p);
 NCampaignDef NMakeCampaignDef(const Campaign *co);
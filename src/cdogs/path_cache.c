@@ -28,10 +28,11 @@
 #include "path_cache.h"
 
 #include <math.h>
-#include <time.h>
+#include <SDL_timer.h>
 
 #include "ai_utils.h"
 #include "log.h"
+#include "profiler.h"
 
 #define PATH_CACHE_MAX 128
 
@@ -116,7 +117,7 @@ CachedPath PathCacheCreate(
 
 	LOG(LM_PATH, LL_TRACE, "find path (%d, %d) to (%d, %d)...",
 		from.x, from.y, to.x, to.y);
-	const clock_t start = clock();
+	const Uint64 start = SDL_GetPerformanceCounter();
 
 	// Cached path not found; find the path now
 	CachedPath cp;
@@ -152,9 +153,10 @@ CachedPath PathCacheCreate(
 		}
 		LOG(LM_PATH, LL_TRACE, "Cached %d paths", (int)pc->paths.size);
 	}
-	const clock_t diff = clock() - start;
-	const int ms = (int)(diff * 1000 / CLOCKS_PER_SEC);
-	LOG(LM_PATH, LL_DEBUG, "Pathfind time %dms", ms);
+	ProfilerEnd(PROFILE_PATHFIND, start);
+	const double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 /
+					  (double)SDL_GetPerformanceFrequency();
+	LOG(LM_PATH, LL_DEBUG, "Pathfind time %.3fms", ms);
 	return cp;
 }
 
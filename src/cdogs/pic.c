@@ -30,6 +30,7 @@
 
 #include "c_hashmap/hashmap.h"
 #include "defs.h"
+#include "draw/sprite_batch.h"
 #include "grafx.h"
 #include "log.h"
 #include "texture.h"
@@ -56,8 +57,7 @@ Uint32 ColorToPixel(
 		((Uint32)color.a << aShift);
 }
 
-// Get the true pixel size of the pic
-static struct vec2i PicPixelSize(const Pic *p)
+struct vec2i PicPixelSize(const Pic *p)
 {
 	if (p->isHD)
 	{
@@ -116,39 +116,20 @@ void PicLoad(
 bail:
 	PicFree(p);
 }
+static void PicDestroyTex(Pic *p);
 bool PicTryMakeTex(Pic *p)
 {
 	CASSERT(!PicIsNone(p), "cannot make tex of none pic");
-	if (textureDebugger == NULL)
+	if (gGraphicsDevice.IsHeadless)
 	{
-		textureDebugger = hashmap_new();
+		// No renderer; keep the pixel data only
+		return true;
 	}
-	if (p->Tex != NULL)
+	if (textureDebugger == NULL)
 	{
-		LOG(LM_GFX, LL_TRACE, "destroying texture %p data(%p)", p->Tex, p->Data);
-		SDL_DestroyTexture(p->Tex);
-		if (LL_TRACE >= LogModuleGetLevel(LM_GFX))
-		{
-			char key[32];
-			sprintf(key, "%p", p->Tex);
-			if (hashmap_get(textureDebugger, key, NULL) == MAP_OK)
-			{
-				if (hashmap_remove(textureDebugger, key) != MAP_OK)
-				{
-					LOG(LM_GFX, LL_TRACE, "Error: cannot remove tex from debugger");
-				}
-				else
-				{
-					LOG(LM_GFX, LL_TRACE, "Texture count: %d",
-						hashmap_length(textureDebugger));
-				}
-			}
-			else
-			{
-				LOG(LM_GFX, LL_TRACE, "Error: destroying unknown texture");
-			}
-		}
+		textureDebugger = hashmap_new();
 	}
+	PicDestroyTex(p);
 	const struct vec2i size = PicPixelSize(p);
 	p->Tex = TextureCreate(
 		gGraphicsDevice.gameWindow.renderer, SDL_TEXTUREACCESS_STATIC,
@@ -197,20 +178,32 @@ Pic PicCopy(const Pic *src)
 	CMALLOC(p.Data, size);
 	memcpy(p.Data, src->Data, size);
 	p.Tex = NULL;
+	p.TexPos = svec2i_zero();
+	p.TexShared = false;
 	p.isHD = src->isHD;
 	return p;
 }
 
-void PicFree(Pic *pic)
+void PicSetAtlasTex(Pic *p, SDL_Texture *tex, const struct vec2i pos)
+{
+	PicDestroyTex(p);
+	p->Tex = tex;
+	p->TexPos = pos;
+	p->TexShared = true;
+}
+static void PicDestroyTex(Pic *p)
 {
-	if (pic->Tex != NULL)
+	// Shared textures are owned by the atlas
+	if (p->Tex != NULL && !p->TexShared)
 	{
-		LOG(LM_GFX, LL_TRACE, "freeing texture %p data(%p)", pic->Tex, pic->Data);
-		SDL_DestroyTexture(pic->Tex);
+		LOG(LM_GFX, LL_TRACE, "destroying texture %p data(%p)", p->Tex,
+			p->Data);
+		SpriteBatchFlush(&gSpriteBatch);
+		SDL_DestroyTexture(p->Tex);
 		if (LL_TRACE >= LogModuleGetLevel(LM_GFX))
 		{
 			char key[32];
-			sprintf(key, "%p", pic->Tex);
+			sprintf(key, "%p", p->Tex);
 			if (hashmap_get(textureDebugger, key, NULL) == MAP_OK)
 			{
 				if (hashmap_remove(textureDebugger, key) != MAP_OK)
@@ -229,6 +222,14 @@ void PicFree(Pic *pic)
 			}
 		}
 	}
+	p->Tex = NULL;
+	p->TexPos = svec2i_zero();
+	p->TexShared = false;
+}
+
+void PicFree(Pic *pic)
+{
+	PicDestroyTex(pic);
 	pic->size = svec2i_zero();
 	CFREE(pic->Data);
 	pic->Data = NULL;
@@ -239,6 +240,14 @@ bool PicIsNone(const Pic *pic)
 	return pic->size.x == 0 || pic->size.y == 0 || pic->Data == NULL;
 }
 
+Rect2i PicTexSrc(const Pic *p, const Rect2i src)
+{
+	Rect2i r = Rect2iIsZero(src) ? Rect2iNew(svec2i_zero(), PicPixelSize(p))
+								 : src;
+	r.Pos = svec2i_add(r.Pos, p->TexPos);
+	return r;
+}
+
 void PicTrim(Pic *pic, const bool xTrim, const bool yTrim)
 {
 	// Scan all pixels looking for the min/max of x and y
@@ -351,5 +360,5 @@ void PicRender(
 		dest.Size.y = (mint_t)MROUND(src.Size.y * destScale.y);
 	}
 	const double angle = ToDegrees(radians);
-	TextureRender(p->Tex, r, src, dest, mask, angle, flip);
+	TextureRender(p->Tex, r, PicTexSrc(p, src), dest, mask, angle, flip);
 }
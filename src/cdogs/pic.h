@@ -36,6 +36,9 @@ typedef struct
 	bool isHD;
 	Uint32 *Data;
 	SDL_Texture *Tex;
+	// Where the pic is in Tex, which may be a page shared with other pics
+	struct vec2i TexPos;
+	bool TexShared;
 } Pic;
 
 color_t PixelToColor(
@@ -51,9 +54,16 @@ void PicLoad(
 	Pic *p, const struct vec2i size, const struct vec2i offset,
 	const SDL_Surface *image, const bool isHD);
 bool PicTryMakeTex(Pic *p);
+// Render the pic from a shared texture instead of its own
+void PicSetAtlasTex(Pic *p, SDL_Texture *tex, const struct vec2i pos);
 Pic PicCopy(const Pic *src);
 void PicFree(Pic *pic);
 bool PicIsNone(const Pic *pic);
+// Get the true pixel size of the pic
+struct vec2i PicPixelSize(const Pic *p);
+// Convert a rect within the pic to one within its texture; a zero rect is
+// the whole pic
+Rect2i PicTexSrc(const Pic *p, const Rect2i src);
 
 // Detect unused edges and update size and offset to fit
 void PicTrim(Pic *pic, const bool xTrim, const bool yTrim);
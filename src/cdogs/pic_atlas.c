@@ -0,0 +1,259 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "pic_atlas.h"
+
+#include "draw/sprite_batch.h"
+#include "grafx.h"
+#include "log.h"
+#include "texture.h"
+#include "utils.h"
+
+
+static void PageInit(PicAtlasPage *p, const struct vec2i pageSize);
+static void PageTerminate(PicAtlasPage *p);
+
+void PicAtlasInit(PicAtlas *a, const struct vec2i pageSize)
+{
+	a->PageSize = pageSize;
+	CArrayInit(&a->Pages, sizeof(PicAtlasPage));
+}
+void PicAtlasTerminate(PicAtlas *a)
+{
+	PicAtlasClear(a);
+	CArrayTerminate(&a->Pages);
+}
+void PicAtlasClear(PicAtlas *a)
+{
+	CA_FOREACH(PicAtlasPage, p, a->Pages)
+	PageTerminate(p);
+	CA_FOREACH_END()
+	CArrayClear(&a->Pages);
+}
+
+static bool PagePack(
+	PicAtlasPage *p, const struct vec2i size, const struct vec2i pageSize,
+	struct vec2i *outPos);
+int PicAtlasPack(PicAtlas *a, const struct vec2i size, struct vec2i *outPos)
+{
+	if (size.x > a->PageSize.x || size.y > a->PageSize.y)
+	{
+		return -1;
+	}
+	CA_FOREACH(PicAtlasPage, p, a->Pages)
+	if (PagePack(p, size, a->PageSize, outPos))
+	{
+		return _ca_index;
+	}
+	CA_FOREACH_END()
+	// No room; start a new page
+	PicAtlasPage p;
+	PageInit(&p, a->PageSize);
+	CArrayPushBack(&a->Pages, &p);
+	PicAtlasPage *page = CArrayGet(&a->Pages, a->Pages.size - 1);
+	const bool packed = PagePack(page, size, a->PageSize, outPos);
+	CASSERT(packed, "cannot pack into empty atlas page");
+	return (int)a->Pages.size - 1;
+}
+
+static bool PageTryMakeTex(PicAtlasPage *p, const struct vec2i pageSize);
+bool PicAtlasAdd(PicAtlas *a, Pic *p)
+{
+	CASSERT(!PicIsNone(p), "cannot pack none pic");
+	if (gGraphicsDevice.IsHeadless)
+	{
+		// No renderer; keep the pixel data only
+		return true;
+	}
+	const struct vec2i size = PicPixelSize(p);
+	struct vec2i pos;
+	const int pageIndex = PicAtlasPack(
+		a, svec2i_add(size, svec2i(PIC_ATLAS_PADDING, PIC_ATLAS_PADDING)),
+		&pos);
+	if (pageIndex < 0)
+	{
+		return PicTryMakeTex(p);
+	}
+	PicAtlasPage *page = CArrayGet(&a->Pages, pageIndex);
+	if (page->Tex == NULL && !PageTryMakeTex(page, a->PageSize))
+	{
+		return false;
+	}
+	const SDL_Rect rect = {pos.x, pos.y, size.x, size.y};
+	if (SDL_UpdateTexture(page->Tex, &rect, p->Data, size.x * sizeof(Uint32)) !=
+		0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot update atlas texture: %s",
+			SDL_GetError());
+		return false;
+	}
+	PicSetAtlasTex(p, page->Tex, pos);
+	return true;
+}
+
+static void PageInit(PicAtlasPage *p, const struct vec2i pageSize)
+{
+	CArrayInit(&p->Skyline, sizeof(PicAtlasSkyline));
+	const PicAtlasSkyline s = {0, 0, pageSize.x};
+	CArrayPushBack(&p->Skyline, &s);
+	p->Tex = NULL;
+}
+static void PageTerminate(PicAtlasPage *p)
+{
+	CArrayTerminate(&p->Skyline);
+	if (p->Tex != NULL)
+	{
+		SpriteBatchFlush(&gSpriteBatch);
+		SDL_DestroyTexture(p->Tex);
+	}
+}
+static bool PageTryMakeTex(PicAtlasPage *p, const struct vec2i pageSize)
+{
+	p->Tex = TextureCreate(
+		gGraphicsDevice.gameWindow.renderer, SDL_TEXTUREACCESS_STATIC,
+		pageSize, SDL_BLENDMODE_BLEND, 255);
+	if (p->Tex == NULL)
+	{
+		return false;
+	}
+	// Clear the page so that the padding is transparent
+	Uint32 *clear;
+	CCALLOC(clear, pageSize.x * pageSize.y * sizeof *clear);
+	const int res =
+		SDL_UpdateTexture(p->Tex, NULL, clear, pageSize.x * sizeof *clear);
+	CFREE(clear);
+	if (res != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot clear atlas texture: %s",
+			SDL_GetError());
+		SDL_DestroyTexture(p->Tex);
+		p->Tex = NULL;
+		return false;
+	}
+	LOG(LM_GFX, LL_DEBUG, "made atlas page %p (%dx%d)", p->Tex, pageSize.x,
+		pageSize.y);
+	return true;
+}
+
+static int SkylineFit(
+	const CArray *skyline, const int index, const struct vec2i size,
+	const struct vec2i pageSize);
+static void SkylineAdd(
+	CArray *skyline, const int index, const struct vec2i pos,
+	const struct vec2i size);
+static bool PagePack(
+	PicAtlasPage *p, const struct vec2i size, const struct vec2i pageSize,
+	struct vec2i *outPos)
+{
+	// Place the rect as low as possible, preferring narrower gaps
+	int bestIndex = -1;
+	int bestBottom = pageSize.y + 1;
+	int bestWidth = pageSize.x + 1;
+	CA_FOREACH(const PicAtlasSkyline, s, p->Skyline)
+	const int y = SkylineFit(&p->Skyline, _ca_index, size, pageSize);
+	if (y < 0)
+	{
+		continue;
+	}
+	const int bottom = y + size.y;
+	if (bottom < bestBottom || (bottom == bestBottom && s->W < bestWidth))
+	{
+		bestIndex = _ca_index;
+		bestBottom = bottom;
+		bestWidth = s->W;
+		*outPos = svec2i(s->X, y);
+	}
+	CA_FOREACH_END()
+	if (bestIndex < 0)
+	{
+		return false;
+	}
+	SkylineAdd(&p->Skyline, bestIndex, *outPos, size);
+	return true;
+}
+// Returns the lowest y that the rect fits at, with its left edge at the
+// skyline segment, or -1 if it doesn't fit
+static int SkylineFit(
+	const CArray *skyline, const int index, const struct vec2i size,
+	const struct vec2i pageSize)
+{
+	const PicAtlasSkyline *s = CArrayGet(skyline, index);
+	if (s->X + size.x > pageSize.x)
+	{
+		return -1;
+	}
+	int y = 0;
+	int widthLeft = size.x;
+	for (int i = index; widthLeft > 0; i++)
+	{
+		s = CArrayGet(skyline, i);
+		y = MAX(y, s->Y);
+		if (y + size.y > pageSize.y)
+		{
+			return -1;
+		}
+		widthLeft -= s->W;
+	}
+	return y;
+}
+static void SkylineAdd(
+	CArray *skyline, const int index, const struct vec2i pos,
+	const struct vec2i size)
+{
+	const PicAtlasSkyline s = {pos.x, pos.y + size.y, size.x};
+	CArrayInsert(skyline, index, &s);
+	// Shrink or remove the segments now underneath the new one
+	for (int i = index + 1; i < (int)skyline->size; i++)
+	{
+		PicAtlasSkyline *cur = CArrayGet(skyline, i);
+		const int shrink = s.X + s.W - cur->X;
+		if (shrink <= 0)
+		{
+			break;
+		}
+		cur->X += shrink;
+		cur->W -= shrink;
+		if (cur->W > 0)
+		{
+			break;
+		}
+		CArrayDelete(skyline, i);
+		i--;
+	}
+	// Merge neighbouring segments of the same height
+	for (int i = 0; i < (int)skyline->size - 1; i++)
+	{
+		PicAtlasSkyline *cur = CArrayGet(skyline, i);
+		const PicAtlasSkyline *next = CArrayGet(skyline, i + 1);
+		if (cur->Y == next->Y)
+		{
+			cur->W += next->W;
+			CArrayDelete(skyline, i + 1);
+			i--;
+		}
+	}
+}
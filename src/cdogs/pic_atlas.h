@@ -0,0 +1,68 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "c_array.h"
+#include "pic.h"
+
+// Pics are packed into a few large texture pages, so that consecutive draws
+// share a texture and the renderer can batch them
+#define PIC_ATLAS_PAGE_SIZE 2048
+// Transparent gap kept around each pic, so filtering doesn't bleed
+// neighbouring pics into each other
+#define PIC_ATLAS_PADDING 1
+
+// Top edge of the packed area; pages are packed bottom-left first
+typedef struct
+{
+	int X;
+	int Y;
+	int W;
+} PicAtlasSkyline;
+typedef struct
+{
+	CArray Skyline; // of PicAtlasSkyline
+	SDL_Texture *Tex;
+} PicAtlasPage;
+typedef struct
+{
+	struct vec2i PageSize;
+	CArray Pages; // of PicAtlasPage
+} PicAtlas;
+
+void PicAtlasInit(PicAtlas *a, const struct vec2i pageSize);
+void PicAtlasTerminate(PicAtlas *a);
+// Destroy all pages; pics packed into them must be freed or repacked
+void PicAtlasClear(PicAtlas *a);
+
+// Find space for a rect of this size, adding a page if needed
+// Returns the page index, or -1 if the rect is bigger than a page
+int PicAtlasPack(PicAtlas *a, const struct vec2i size, struct vec2i *outPos);
+// Pack the pic and upload its pixels; the pic then renders from the page
+// Pics too big for a page get their own texture
+bool PicAtlasAdd(PicAtlas *a, Pic *p);
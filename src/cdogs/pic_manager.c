@@ -44,6 +44,10 @@ void PicManagerInit(PicManager *pm)
 	pm->sprites = hashmap_new();
 	pm->customPics = hashmap_new();
 	pm->customSprites = hashmap_new();
+	const struct vec2i pageSize =
+		svec2i(PIC_ATLAS_PAGE_SIZE, PIC_ATLAS_PAGE_SIZE);
+	PicAtlasInit(&pm->atlas, pageSize);
+	PicAtlasInit(&pm->customAtlas, pageSize);
 	for (HeadPart hp = HEAD_PART_HAIR; hp < HEAD_PART_COUNT; hp++)
 	{
 		CArrayInit(&pm->headPartNames[hp], sizeof(char *));
@@ -53,14 +57,16 @@ void PicManagerInit(PicManager *pm)
 	CArrayInit(&pm->exitStyleNames, sizeof(char *));
 	CArrayInit(&pm->doorStyleNames, sizeof(char *));
 	CArrayInit(&pm->keyStyleNames, sizeof(char *));
+	CArrayInit(&pm->charSprites, sizeof(CharSpritesEntry));
 }
 
 static NamedPic *AddNamedPic(map_t pics, const char *name, const Pic *p);
 static NamedSprites *AddNamedSprites(map_t sprites, const char *name);
 static void AfterAdd(PicManager *pm);
+static PicAtlas *GetAtlas(PicManager *pm, const map_t pics);
 static void PicManagerAdd(
-	map_t pics, map_t sprites, const char *name, SDL_Surface *imageIn,
-	const bool isHD)
+	PicManager *pm, map_t pics, map_t sprites, const char *name,
+	SDL_Surface *imageIn, const bool isHD)
 {
 	char buf[CDOGS_FILENAME_MAX];
 	const char *dot = strrchr(name, '.');
@@ -171,12 +177,20 @@ static void PicManagerAdd(
 					pic->Data[i] = COLOR2PIXEL(converted);
 				}
 			}
+			if (!PicIsNone(pic) && !PicAtlasAdd(GetAtlas(pm, pics), pic))
+			{
+				LOG(LM_MAIN, LL_ERROR, "failed to pack pic %s", buf);
+			}
 		}
 	}
 	SDL_UnlockSurface(image);
 	SDL_FreeSurface(image);
 
-	AfterAdd(&gPicManager);
+	AfterAdd(pm);
+}
+static PicAtlas *GetAtlas(PicManager *pm, const map_t pics)
+{
+	return pics == pm->customPics ? &pm->customAtlas : &pm->atlas;
 }
 
 void PicManagerLoadDir(
@@ -223,7 +237,7 @@ void PicManagerLoadDir(
 				{
 					PathGetBasenameWithoutExtension(buf, file.name);
 				}
-				PicManagerAdd(pics, sprites, buf, data, isHD);
+				PicManagerAdd(pm, pics, sprites, buf, data, isHD);
 			}
 		}
 		else if (file.is_dir && file.name[0] != '.')
@@ -450,10 +464,13 @@ static int MaybeAddTilePicName(any_t data, any_t item)
 // Need to free the pics and the memory since hashmap stores on heap
 static void NamedPicDestroy(any_t data);
 static void NamedSpritesDestroy(any_t data);
+static void ClearCharSprites(PicManager *pm);
 void PicManagerClearCustom(PicManager *pm)
 {
 	hashmap_clear(pm->customPics, NamedPicDestroy);
 	hashmap_clear(pm->customSprites, NamedSpritesDestroy);
+	ClearCharSprites(pm);
+	PicAtlasClear(&pm->customAtlas);
 	AfterAdd(pm);
 }
 static void PicManagerUnload(PicManager *pm)
@@ -462,8 +479,19 @@ static void PicManagerUnload(PicManager *pm)
 	hashmap_clear(pm->sprites, NamedSpritesDestroy);
 	hashmap_clear(pm->customPics, NamedPicDestroy);
 	hashmap_clear(pm->customSprites, NamedSpritesDestroy);
+	ClearCharSprites(pm);
+	PicAtlasClear(&pm->atlas);
+	PicAtlasClear(&pm->customAtlas);
 	AfterAdd(pm);
 }
+static void ClearCharSprites(PicManager *pm)
+{
+	CA_FOREACH(CharSpritesEntry, e, pm->charSprites)
+	CFREE(e->Name);
+	CA_FOREACH_END()
+	CArrayFillZero(&pm->charSprites);
+	pm->charSpritesCount = 0;
+}
 static void StyleNamesDestroy(CArray *a)
 {
 	CA_FOREACH(char, n, *a)
@@ -474,6 +502,9 @@ static void StyleNamesDestroy(CArray *a)
 void PicManagerTerminate(PicManager *pm)
 {
 	PicManagerUnload(pm);
+	PicAtlasTerminate(&pm->atlas);
+	PicAtlasTerminate(&pm->customAtlas);
+	CArrayTerminate(&pm->charSprites);
 	for (HeadPart hp = HEAD_PART_HAIR; hp < HEAD_PART_COUNT; hp++)
 	{
 		StyleNamesDestroy(&pm->headPartNames[hp]);
@@ -500,16 +531,21 @@ static int ReloadTexture(any_t data, any_t item);
 static int ReloadSpriteTexture(any_t data, any_t item);
 void PicManagerReloadTextures(PicManager *pm)
 {
-	hashmap_iterate(pm->pics, ReloadTexture, NULL);
-	hashmap_iterate(pm->customPics, ReloadTexture, NULL);
-	hashmap_iterate(pm->sprites, ReloadSpriteTexture, NULL);
-	hashmap_iterate(pm->customSprites, ReloadSpriteTexture, NULL);
+	PicAtlasClear(&pm->atlas);
+	PicAtlasClear(&pm->customAtlas);
+	hashmap_iterate(pm->pics, ReloadTexture, &pm->atlas);
+	hashmap_iterate(pm->customPics, ReloadTexture, &pm->customAtlas);
+	hashmap_iterate(pm->sprites, ReloadSpriteTexture, &pm->atlas);
+	hashmap_iterate(pm->customSprites, ReloadSpriteTexture, &pm->customAtlas);
 }
 static int ReloadTexture(any_t data, any_t item)
 {
-	UNUSED(data);
 	NamedPic *n = item;
-	if (!PicTryMakeTex(&n->pic))
+	if (PicIsNone(&n->pic))
+	{
+		return MAP_OK;
+	}
+	if (!PicAtlasAdd(data, &n->pic))
 	{
 		LOG(LM_MAIN, LL_ERROR, "failed to reload pic texture");
 		n->pic.Tex = NULL;
@@ -518,10 +554,13 @@ static int ReloadTexture(any_t data, any_t item)
 }
 static int ReloadSpriteTexture(any_t data, any_t item)
 {
-	UNUSED(data);
 	NamedSprites *n = item;
 	CA_FOREACH(Pic, op, n->pics)
-	if (!PicTryMakeTex(op))
+	if (PicIsNone(op))
+	{
+		continue;
+	}
+	if (!PicAtlasAdd(data, op))
 	{
 		LOG(LM_MAIN, LL_ERROR, "failed to reload pic texture");
 		op->Tex = NULL;
@@ -608,8 +647,15 @@ static void PicManagerGenerateMaskedPic(
 	CASSERT(original != NULL, "Cannot find original pic for masking");
 
 	// Create the new pic by masking the original pic
+	// Pick each pixel's mask first, then multiply them all in one batch
 	Pic p = PicCopy(original);
-	for (int i = 0; i < p.size.x * p.size.y; i++)
+	const int size = p.size.x * p.size.y;
+	Uint32 *masks;
+	CMALLOC(masks, size * sizeof *masks);
+	const Uint32 maskPixel = COLOR2PIXEL(mask);
+	const Uint32 maskAltPixel = COLOR2PIXEL(maskAlt);
+	const Uint32 whitePixel = COLOR2PIXEL(colorWhite);
+	for (int i = 0; i < size; i++)
 	{
 		color_t c = PIXEL2COLOR(original->Data[i]);
 		// Apply mask based on which channel each pixel is
@@ -618,16 +664,22 @@ static void PicManagerGenerateMaskedPic(
 			// Restore to white before masking
 			c.g = c.r;
 			c.b = c.r;
-			c = ColorMult(c, maskAlt);
+			p.Data[i] = COLOR2PIXEL(c);
+			masks[i] = maskAltPixel;
 		}
 		else if (c.r == c.g && c.g == c.b)
 		{
-			c = ColorMult(c, mask);
+			masks[i] = maskPixel;
+		}
+		else
+		{
+			masks[i] = whitePixel;
 		}
-		p.Data[i] = COLOR2PIXEL(c);
 		// TODO: more channels
 	}
-	if (!PicTryMakeTex(&p))
+	ColorMultPixels(p.Data, p.Data, masks, size);
+	CFREE(masks);
+	if (!PicAtlasAdd(&pm->customAtlas, &p))
 	{
 		p.Tex = NULL;
 	}
@@ -661,29 +713,130 @@ const NamedSprites *PicManagerGetCharSprites(
 		return NULL;
 	}
 	NamedSprites *nsp = AddNamedSprites(pm->customSprites, buf);
+	// Each pixel's channel mask is picked by its alpha
+	const SDL_PixelFormat *f = gGraphicsDevice.Format;
+	const Uint32 aMask = ~(f->Rmask | f->Gmask | f->Bmask);
+	Uint32 channelMasks[256];
+	for (int a = 0; a < 256; a++)
+	{
+		channelMasks[a] =
+			COLOR2PIXEL(CharColorsGetChannelMask(colors, (uint8_t)a));
+	}
+	CArray masks;
+	CArrayInit(&masks, sizeof(Uint32));
 	CA_FOREACH(Pic, op, ons->pics)
 	Pic p = PicCopy(op);
 	p.Tex = NULL;
-	for (int i = 0; i < p.size.x * p.size.y; i++)
+	const int size = p.size.x * p.size.y;
+	CArrayResize(&masks, size, NULL);
+	Uint32 *m = masks.data;
+	for (int i = 0; i < size; i++)
 	{
-		if (op->Data[i] == 0)
-		{
-			continue;
-		}
-		const color_t c = PIXEL2COLOR(op->Data[i]);
-		p.Data[i] =
-			COLOR2PIXEL(ColorMult(c, CharColorsGetChannelMask(colors, c.a)));
+		m[i] = channelMasks[(Uint8)((op->Data[i] & aMask) >> f->Ashift)];
 	}
-	if (!PicTryMakeTex(&p))
+	ColorMultPixels(p.Data, op->Data, m, size);
+	if (!PicAtlasAdd(&pm->customAtlas, &p))
 	{
 		p.Tex = NULL;
 	}
 	CArrayPushBack(&nsp->pics, &p);
 	CA_FOREACH_END()
+	CArrayTerminate(&masks);
 	AfterAdd(pm);
 	return nsp;
 }
 
+static CharSpritesEntry *FindCharSpritesEntry(
+	const CArray *table, const CharSpritesKey *key);
+bool PicManagerFindCharSprites(
+	const PicManager *pm, const CharSpritesKey *key, const NamedSprites **ns)
+{
+	if (pm->charSprites.size == 0)
+	{
+		return false;
+	}
+	const CharSpritesEntry *e = FindCharSpritesEntry(&pm->charSprites, key);
+	if (e->Name == NULL)
+	{
+		return false;
+	}
+	*ns = e->Sprites;
+	return true;
+}
+static void GrowCharSprites(PicManager *pm);
+const NamedSprites *PicManagerAddCharSprites(
+	PicManager *pm, const CharSpritesKey *key, const char *path)
+{
+	const NamedSprites *ns = PicManagerGetCharSprites(pm, path, key->Colors);
+	// Keep the table at most half full
+	if ((pm->charSpritesCount + 1) * 2 > pm->charSprites.size)
+	{
+		GrowCharSprites(pm);
+	}
+	CharSpritesEntry *e = FindCharSpritesEntry(&pm->charSprites, key);
+	if (e->Name == NULL)
+	{
+		e->Hash = key->Hash;
+		e->Sheet = key->Sheet;
+		CSTRDUP(e->Name, key->Name);
+		e->Colors = *key->Colors;
+		pm->charSpritesCount++;
+	}
+	e->Sprites = ns;
+	return ns;
+}
+static bool CharSpritesEntryIsKey(
+	const CharSpritesEntry *e, const CharSpritesKey *key);
+static CharSpritesEntry *FindCharSpritesEntry(
+	const CArray *table, const CharSpritesKey *key)
+{
+	// Linear probe; the table size is a power of 2
+	const size_t mask = table->size - 1;
+	for (size_t i = (size_t)key->Hash & mask;; i = (i + 1) & mask)
+	{
+		CharSpritesEntry *e = CArrayGet(table, i);
+		if (e->Name == NULL || CharSpritesEntryIsKey(e, key))
+		{
+			return e;
+		}
+	}
+}
+static bool CharSpritesEntryIsKey(
+	const CharSpritesEntry *e, const CharSpritesKey *key)
+{
+	// Compare the whole key, not just the hash, so that colliding keys
+	// don't share sprites
+	return e->Hash == key->Hash && e->Sheet == key->Sheet &&
+		   strcmp(e->Name, key->Name) == 0 &&
+		   CharColorsEqual(&e->Colors, key->Colors);
+}
+#define CHAR_SPRITES_MIN_SIZE 256
+static void GrowCharSprites(PicManager *pm)
+{
+	CArray old = pm->charSprites;
+	CArrayInitFillZero(
+		&pm->charSprites, sizeof(CharSpritesEntry),
+		MAX(old.size * 2, CHAR_SPRITES_MIN_SIZE));
+	const size_t mask = pm->charSprites.size - 1;
+	CA_FOREACH(const CharSpritesEntry, oe, old)
+	if (oe->Name == NULL)
+	{
+		continue;
+	}
+	// Keys are unique, so just find the first empty slot
+	for (size_t i = (size_t)oe->Hash & mask;; i = (i + 1) & mask)
+	{
+		CharSpritesEntry *e = CArrayGet(&pm->charSprites, i);
+		if (e->Name == NULL)
+		{
+			*e = *oe;
+			break;
+		}
+	}
+	CA_FOREACH_END()
+	CArrayTerminate(&old);
+}
+
 static void GetMaskedName(
 	char *buf, const char *name, const color_t mask, const color_t maskAlt)
 {
@@ -30,6 +30,27 @@
 #include "blit.h"
 #include "c_hashmap/hashmap.h"
 #include "cpic.h"
+#include "pic_atlas.h"
+
+// Masked character sprites are identified by a sheet number, the name of
+// the unmasked sprites and the colours; Hash is of all three, e.g. from
+// CharColorsHash, and is only used to find the slot
+typedef struct
+{
+	uint64_t Hash;
+	int Sheet;
+	const char *Name;
+	const CharColors *Colors;
+} CharSpritesKey;
+
+typedef struct
+{
+	uint64_t Hash;
+	int Sheet;
+	char *Name; // NULL for empty slots
+	CharColors Colors;
+	const NamedSprites *Sprites;
+} CharSpritesEntry;
 
 typedef struct
 {
@@ -37,6 +58,13 @@ typedef struct
 	map_t sprites;	// of NamedSprites
 	map_t customPics;	// of NamedPic
 	map_t customSprites;	// of NamedSprites
+	// Textures for pics and custom pics, which are cleared separately
+	PicAtlas atlas;
+	PicAtlas customAtlas;
+	// Masked character sprites by numeric key, open addressed; cleared
+	// with the custom sprites they point to
+	CArray charSprites;	// of CharSpritesEntry
+	size_t charSpritesCount;
 
 	CArray headPartNames[HEAD_PART_COUNT];	// of char *
 	CArray wallStyleNames;	// of char *
@@ -55,6 +83,7 @@ void PicManagerLoadDir(
 	map_t pics, map_t sprites, const bool isHD);
 void PicManagerClearCustom(PicManager *pm);
 void PicManagerTerminate(PicManager *pm);
+// Repack all pics into new atlas pages, e.g. when the renderer is recreated
 void PicManagerReloadTextures(PicManager *pm);
 
 // Note: return ptr to NamedPic so we can store that instead of the name
@@ -77,6 +106,16 @@ void PicManagerGenerateMaskedStylePic(
 // Get masked character pics
 const NamedSprites *PicManagerGetCharSprites(
 	PicManager *pm, const char *name, const CharColors *colors);
+// Masked character pics can also be looked up by key, so that the masked
+// name is only formatted the first time.
+// Returns false if nothing has been added for the key; ns can be NULL if
+// the sprites don't exist.
+bool PicManagerFindCharSprites(
+	const PicManager *pm, const CharSpritesKey *key, const NamedSprites **ns);
+// Get masked character pics by path, with the key's colours, and add them
+// for the key
+const NamedSprites *PicManagerAddCharSprites(
+	PicManager *pm, const CharSpritesKey *key, const char *path);
 
 int PicManagerGetWallStyleIndex(PicManager *pm, const char *style);
 int PicManagerGetTileStyleIndex(PicManager *pm, const char *style);
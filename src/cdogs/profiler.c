@@ -0,0 +1,187 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "profiler.h"
+
+#include <string.h>
+
+#include <SDL_timer.h>
+
+#include "config.h"
+#include "log.h"
+#include "utils.h"
+
+Profiler gProfiler;
+
+const char *ProfilePhaseStr(const ProfilePhase p)
+{
+	switch (p)
+	{
+		T2S(PROFILE_UPDATE, "Update");
+		T2S(PROFILE_AI, "AI");
+		T2S(PROFILE_ACTORS, "Actors");
+		T2S(PROFILE_OBJECTS, "Objects");
+		T2S(PROFILE_MOBOBJS, "Mobile objects");
+		T2S(PROFILE_PICKUPS, "Pickups");
+		T2S(PROFILE_PARTICLES, "Particles");
+		T2S(PROFILE_MAP, "Map");
+		T2S(PROFILE_WATCHES, "Watches");
+		T2S(PROFILE_EVENTS, "Events");
+		T2S(PROFILE_LOS, "LOS");
+		T2S(PROFILE_PATHFIND, "Pathfind");
+		T2S(PROFILE_DRAW, "Draw");
+		T2S(PROFILE_DRAW_FLOOR, "Draw floor");
+		T2S(PROFILE_DRAW_BELOW, "Draw below");
+		T2S(PROFILE_DRAW_WALLS, "Draw walls");
+		T2S(PROFILE_DRAW_ABOVE, "Draw above");
+		T2S(PROFILE_DRAW_HUD, "Draw HUD");
+		T2S(PROFILE_DRAW_EXTRA, "Draw extra");
+		T2S(PROFILE_NET_POLL, "Net poll");
+		T2S(PROFILE_NET_FLUSH, "Net flush");
+	default:
+		return "";
+	}
+}
+
+void ProfilerInit(Profiler *p)
+{
+	memset(p, 0, sizeof *p);
+	p->freq = (double)SDL_GetPerformanceFrequency();
+}
+void ProfilerTerminate(Profiler *p)
+{
+	if (p->traceFile != NULL)
+	{
+		fputs("\n]}\n", p->traceFile);
+		fclose(p->traceFile);
+		p->traceFile = NULL;
+	}
+}
+
+bool ProfilerStartTrace(Profiler *p, const char *filename)
+{
+	ProfilerTerminate(p);
+	p->traceFile = fopen(filename, "w");
+	if (p->traceFile == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Cannot open trace file '%s'", filename);
+		return false;
+	}
+	fputs("{\"traceEvents\":[", p->traceFile);
+	p->traceHasEvents = false;
+	p->traceStart = SDL_GetPerformanceCounter();
+	p->Enabled = true;
+	LOG(LM_MAIN, LL_INFO, "Writing profiler trace to '%s'", filename);
+	return true;
+}
+
+void ProfilerNewFrame(Profiler *p)
+{
+	if (p->Enabled)
+	{
+		memcpy(p->history[p->historyIndex], p->current, sizeof p->current);
+		p->historyIndex = (p->historyIndex + 1) % PROFILER_HISTORY;
+		p->historyCount = MIN(p->historyCount + 1, PROFILER_HISTORY);
+		memset(p->current, 0, sizeof p->current);
+	}
+	const bool enabled = p->traceFile != NULL ||
+						 ConfigGetBool(&gConfig, "Interface.ShowProfiler");
+	if (enabled != p->Enabled)
+	{
+		// Start afresh so stale timings don't pollute the averages
+		p->historyIndex = 0;
+		p->historyCount = 0;
+		memset(p->current, 0, sizeof p->current);
+	}
+	p->Enabled = enabled;
+}
+
+Uint64 ProfilerBegin(void)
+{
+	if (!gProfiler.Enabled)
+	{
+		return 0;
+	}
+	return SDL_GetPerformanceCounter();
+}
+static void TraceWrite(
+	Profiler *p, const ProfilePhase phase, const Uint64 start,
+	const Uint64 end);
+void ProfilerEnd(const ProfilePhase phase, const Uint64 start)
+{
+	if (!gProfiler.Enabled || start == 0)
+	{
+		return;
+	}
+	const Uint64 end = SDL_GetPerformanceCounter();
+	gProfiler.current[phase] += (double)(end - start) * 1000.0 / gProfiler.freq;
+	if (gProfiler.traceFile != NULL)
+	{
+		TraceWrite(&gProfiler, phase, start, end);
+	}
+}
+static const char *PhaseCategory(const ProfilePhase phase)
+{
+	if (phase >= PROFILE_NET_POLL)
+	{
+		return "net";
+	}
+	if (phase >= PROFILE_DRAW)
+	{
+		return "draw";
+	}
+	return "update";
+}
+static void TraceWrite(
+	Profiler *p, const ProfilePhase phase, const Uint64 start,
+	const Uint64 end)
+{
+	// Complete ("X") events with microsecond timestamps
+	const double ts = (double)(start - p->traceStart) * 1000000.0 / p->freq;
+	const double dur = (double)(end - start) * 1000000.0 / p->freq;
+	fprintf(
+		p->traceFile,
+		"%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+		"\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+		p->traceHasEvents ? "," : "", ProfilePhaseStr(phase),
+		PhaseCategory(phase), ts, dur);
+	p->traceHasEvents = true;
+}
+
+double ProfilerGetAverage(const Profiler *p, const ProfilePhase phase)
+{
+	if (p->historyCount == 0)
+	{
+		return 0;
+	}
+	double total = 0;
+	for (int i = 0; i < p->historyCount; i++)
+	{
+		total += p->history[i][phase];
+	}
+	return total / p->historyCount;
+}
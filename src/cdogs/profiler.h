@@ -0,0 +1,100 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <SDL_stdinc.h>
+
+// Lightweight per-subsystem timers
+// Wrap a phase with ProfilerBegin/ProfilerEnd; when the profiler is
+// disabled these cost a single branch.
+// Timings are kept as a rolling per-frame history for the HUD overlay, and
+// can be streamed to a Chrome trace_event JSON file (chrome://tracing).
+
+typedef enum
+{
+	PROFILE_UPDATE,
+	PROFILE_AI,
+	PROFILE_ACTORS,
+	PROFILE_OBJECTS,
+	PROFILE_MOBOBJS,
+	PROFILE_PICKUPS,
+	PROFILE_PARTICLES,
+	PROFILE_MAP,
+	PROFILE_WATCHES,
+	PROFILE_EVENTS,
+	PROFILE_LOS,
+	PROFILE_PATHFIND,
+	PROFILE_DRAW,
+	PROFILE_DRAW_FLOOR,
+	PROFILE_DRAW_BELOW,
+	PROFILE_DRAW_WALLS,
+	PROFILE_DRAW_ABOVE,
+	PROFILE_DRAW_HUD,
+	PROFILE_DRAW_EXTRA,
+	PROFILE_NET_POLL,
+	PROFILE_NET_FLUSH,
+	PROFILE_COUNT
+} ProfilePhase;
+const char *ProfilePhaseStr(const ProfilePhase p);
+
+#define PROFILER_HISTORY 60
+
+typedef struct
+{
+	bool Enabled;
+	double freq;
+	// Time spent per phase, in ms, for the current frame
+	double current[PROFILE_COUNT];
+	double history[PROFILER_HISTORY][PROFILE_COUNT];
+	int historyIndex;
+	int historyCount;
+
+	FILE *traceFile;
+	bool traceHasEvents;
+	Uint64 traceStart;
+} Profiler;
+
+extern Profiler gProfiler;
+
+void ProfilerInit(Profiler *p);
+void ProfilerTerminate(Profiler *p);
+// Stream all timed phases to a Chrome trace_event JSON file
+bool ProfilerStartTrace(Profiler *p, const char *filename);
+
+// Start a new frame; rolls the current timings into the history
+void ProfilerNewFrame(Profiler *p);
+
+// Returns the start time, or 0 if the profiler is disabled
+Uint64 ProfilerBegin(void);
+void ProfilerEnd(const ProfilePhase phase, const Uint64 start);
+
+// Average time spent per frame in a phase over the history, in ms
+double ProfilerGetAverage(const Profiler *p, const ProfilePhase phase);
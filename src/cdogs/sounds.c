@@ -196,6 +196,18 @@ void SoundInitialize(SoundDevice *device, const char *path)
 	SoundLoadDir(device->sounds, buf, NULL);
 	MusicPlayerInit(&device->music);
 }
+// Null sound device: no audio device is opened and nothing is loaded,
+// but campaigns can still register custom sounds
+void SoundInitializeNull(SoundDevice *device)
+{
+	memset(device, 0, sizeof *device);
+	device->sounds = hashmap_new();
+	device->customSounds = hashmap_new();
+	for (MusicType type = MUSIC_MENU; type < MUSIC_COUNT; type++)
+	{
+		CArrayInit(&device->music.generalTracks[type], sizeof(Mix_Music *));
+	}
+}
 void SoundLoadDir(map_t sounds, const char *path, const char *prefix)
 {
 	if (sounds == NULL)
@@ -582,6 +594,17 @@ void SoundPlayAtPlusDistance(
 		isMuffled);
 }
 
+// Random sound variants use their own generator so that playing sounds
+// doesn't consume the simulation's rand() sequence; otherwise games would
+// play out differently with and without sound (e.g. replays)
+static uint32_t sSoundRand = 1;
+static uint32_t SoundRand(void)
+{
+	sSoundRand ^= sSoundRand << 13;
+	sSoundRand ^= sSoundRand >> 17;
+	sSoundRand ^= sSoundRand << 5;
+	return sSoundRand;
+}
 static Mix_Chunk *SoundDataGet(SoundData *s);
 Mix_Chunk *StrSound(const char *s)
 {
@@ -620,7 +643,7 @@ static Mix_Chunk *SoundDataGet(SoundData *s)
 			while ((int)s->u.random.sounds.size > 1 &&
 				   idx == s->u.random.lastPlayed)
 			{
-				idx = rand() % s->u.random.sounds.size;
+				idx = (int)(SoundRand() % s->u.random.sounds.size);
 			}
 			Mix_Chunk **sound = CArrayGet(&s->u.random.sounds, idx);
 			s->u.random.lastPlayed = idx;
@@ -108,6 +108,7 @@ typedef struct
 extern SoundDevice gSoundDevice;
 
 void SoundInitialize(SoundDevice *device, const char *path);
+void SoundInitializeNull(SoundDevice *device);
 void SoundLoadDir(map_t sounds, const char *path, const char *prefix);
 void SoundAdd(map_t sounds, const char *name, SoundData *sound);
 void SoundReconfigure(SoundDevice *s);
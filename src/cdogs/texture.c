@@ -25,6 +25,7 @@
  */
 #include "texture.h"
 
+#include "draw/sprite_batch.h"
 #include "log.h"
 
 
@@ -62,34 +63,5 @@ void TextureRender(
 	SDL_Texture *t, SDL_Renderer *r, const Rect2i src, const Rect2i dest,
 	const color_t mask, const double angle, const SDL_RendererFlip flip)
 {
-	if (SDL_SetTextureColorMod(t, mask.r, mask.g, mask.b) != 0)
-	{
-		LOG(LM_MAIN, LL_ERROR, "Failed to set texture mask: %s",
-			SDL_GetError());
-	}
-	if (mask.a < 255 && SDL_SetTextureAlphaMod(t, mask.a) != 0)
-	{
-		LOG(LM_MAIN, LL_ERROR, "Failed to set texture alpha: %s",
-			SDL_GetError());
-	}
-	const SDL_Rect srcRect = {
-		src.Pos.x, src.Pos.y, src.Size.x, src.Size.y
-	};
-	const SDL_Rect *srcP = Rect2iIsZero(src) ? NULL : &srcRect;
-	const SDL_Rect destRect = {
-		dest.Pos.x, dest.Pos.y, dest.Size.x, dest.Size.y
-	};
-	const SDL_Rect *dstP = Rect2iIsZero(dest) ? NULL : &destRect;
-
-	if (SDL_RenderCopyEx(r, t, srcP, dstP, angle, NULL, flip) != 0)
-	{
-		LOG(LM_MAIN, LL_ERROR, "Failed to render texture: %s", SDL_GetError());
-	}
-	// Reset
-	// TODO: not sure why this reset is necessary and we can't always set alpha
-	if (mask.a < 255 && SDL_SetTextureAlphaMod(t, 255) != 0)
-	{
-		LOG(LM_MAIN, LL_ERROR, "Failed to reset texture alpha: %s",
-			SDL_GetError());
-	}
+	SpriteBatchAdd(&gSpriteBatch, t, r, src, dest, mask, angle, flip);
 }
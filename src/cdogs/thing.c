@@ -38,6 +38,7 @@
 #include "actors.h"
 #include "net_util.h"
 #include "objs.h"
+#include "particle.h"
 #include "pickup.h"
 #include "tile.h"
 
@@ -47,6 +48,10 @@
 #define ZERO_DRAW_SHAKE svec2(\
 	RAND_FLOAT(-DRAW_SHAKE_MAX, DRAW_SHAKE_MAX) * 0.7f,\
 	RAND_FLOAT(-DRAW_SHAKE_MAX, DRAW_SHAKE_MAX) * 0.7f)
+// Don't interpolate moves further than this; they are teleports
+#define INTERPOLATE_MAX_DIST (TILE_WIDTH * 2)
+
+float gThingDrawAlpha = 1.0f;
 
 
 bool IsThingInsideTile(const Thing *i, const struct vec2i tilePos)
@@ -87,6 +92,40 @@ void ThingUpdate(Thing *t, const int ticks)
 	CPicUpdate(&t->CPic, ticks);
 }
 
+void ThingsStoreLastPos(void)
+{
+	CA_FOREACH(TActor, a, gActors)
+	a->thing.LastPos = a->thing.Pos;
+	CA_FOREACH_END()
+	CA_FOREACH(TObject, o, gObjs)
+	o->thing.LastPos = o->thing.Pos;
+	CA_FOREACH_END()
+	CA_FOREACH(TMobileObject, m, gMobObjs)
+	m->thing.LastPos = m->thing.Pos;
+	CA_FOREACH_END()
+	CA_FOREACH(Pickup, p, gPickups)
+	p->thing.LastPos = p->thing.Pos;
+	CA_FOREACH_END()
+	CA_FOREACH(Particle, p, gParticles)
+	p->thing.LastPos = p->thing.Pos;
+	CA_FOREACH_END()
+}
+
+struct vec2 ThingDrawPos(const Thing *t)
+{
+	return DrawPosInterpolate(t->LastPos, t->Pos);
+}
+struct vec2 DrawPosInterpolate(const struct vec2 last, const struct vec2 pos)
+{
+	if (gThingDrawAlpha >= 1.0f ||
+		svec2_distance_squared(last, pos) >
+			INTERPOLATE_MAX_DIST * INTERPOLATE_MAX_DIST)
+	{
+		return pos;
+	}
+	return svec2_lerp(last, pos, gThingDrawAlpha);
+}
+
 void ThingAddDrawShake(Thing *t, const struct vec2 shake)
 {
 	if (svec2_is_zero(shake))
@@ -88,6 +88,10 @@ typedef struct
 } Thing;
 #define SOUND_LOCK_THING 12
 
+// Fraction of the way from the last to the current simulation tick that is
+// being drawn; 1 unless frame interpolation is enabled
+extern float gThingDrawAlpha;
+
 
 typedef struct
 {
@@ -103,6 +107,11 @@ void ThingInit(
 	Thing *t, const int id, const ThingKind kind, const struct vec2i size,
 	const int flags);
 void ThingUpdate(Thing *t, const int ticks);
+// Record current positions as the start of the next simulation tick
+void ThingsStoreLastPos(void);
+// Position to draw at, between the last and current simulation tick
+struct vec2 ThingDrawPos(const Thing *t);
+struct vec2 DrawPosInterpolate(const struct vec2 last, const struct vec2 pos);
 void ThingAddDrawShake(Thing *t, const struct vec2 shake);
 void ThingDamage(const NThingDamage d);
 
@@ -466,6 +466,8 @@ const char *InputDeviceName(const int d, const int deviceIndex)
 		return JoyName(deviceIndex);
 	case INPUT_DEVICE_AI:
 		return "AI";
+	case INPUT_DEVICE_REPLAY:
+		return "Replay";
 	default:
 		return "";
 	}
@@ -610,6 +612,31 @@ bool IntsEqual(const void *v1, const void *v2)
 	return *(const int *)v1 == *(const int *)v2;
 }
 
+#define HASH64_PRIME 0x100000001b3ull
+uint64_t Hash64(uint64_t h, const void *data, const size_t len)
+{
+	const uint8_t *p = data;
+	for (size_t i = 0; i < len; i++)
+	{
+		h = (h ^ p[i]) * HASH64_PRIME;
+	}
+	return h;
+}
+uint64_t Hash64Str(uint64_t h, const char *s)
+{
+	if (s == NULL)
+	{
+		return h;
+	}
+	for (; *s; s++)
+	{
+		h = (h ^ (uint8_t)*s) * HASH64_PRIME;
+	}
+	// Terminate so that consecutive strings hash differently to their
+	// concatenation
+	return h * HASH64_PRIME;
+}
+
 const char *HeadPartStr(const HeadPart hp)
 {
 	switch (hp)
@@ -173,6 +173,8 @@ typedef enum
 
 	// Fake device used for co-op AI
 	INPUT_DEVICE_AI,
+	// Fake device for players driven by recorded replay commands
+	INPUT_DEVICE_REPLAY,
 
 	INPUT_DEVICE_COUNT
 } input_device_e;
@@ -199,6 +201,12 @@ int CompareIntsAsc(const void *v1, const void *v2);
 int CompareIntsDesc(const void *v1, const void *v2);
 bool IntsEqual(const void *v1, const void *v2);
 
+// 64-bit FNV-1a hash; chain calls to hash several values, starting from
+// HASH64_INIT
+#define HASH64_INIT 0xcbf29ce484222325ull
+uint64_t Hash64(uint64_t h, const void *data, const size_t len);
+uint64_t Hash64Str(uint64_t h, const char *s);
+
 // Helper macros for defining type/str conversion funcs
 #define T2S(_type, _str)                                                      \
 	case _type:                                                               \
@@ -25,6 +25,7 @@
  */
 #include "window_context.h"
 
+#include "draw/sprite_batch.h"
 #include "log.h"
 #include "texture.h"
 
@@ -89,6 +90,7 @@ void WindowContextDestroy(WindowContext *wc)
 }
 void WindowContextDestroyTextures(WindowContext *wc)
 {
+	SpriteBatchFlush(&gSpriteBatch);
 	CA_FOREACH(SDL_Texture *, t, wc->texturesBkg)
 	SDL_DestroyTexture(*t);
 	CA_FOREACH_END()
@@ -123,6 +125,7 @@ SDL_Texture *WindowContextCreateTexture(
 
 void WindowContextPreRender(WindowContext *wc)
 {
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderDrawColor(wc->renderer, 0, 0, 0, 255) != 0)
 	{
 		LOG(LM_GFX, LL_ERROR, "Failed to set draw color: %s", SDL_GetError());
@@ -147,5 +150,6 @@ void WindowContextPostRender(WindowContext *wc)
 		SDL_FLIP_NONE);
 	CA_FOREACH_END()
 
+	SpriteBatchFlush(&gSpriteBatch);
 	SDL_RenderPresent(wc->renderer);
 }
@@ -29,6 +29,7 @@
 
 #include <SDL_opengl.h>
 
+#include <cdogs/draw/sprite_batch.h>
 #include <cdogs/events.h>
 #include <cdogs/font.h>
 #include <cdogs/gamedata.h>
@@ -144,6 +145,7 @@ void ClearScreen(GraphicsDevice *g)
 	{
 		g->buf[i] = pixel;
 	}
+	SpriteBatchFlush(&gSpriteBatch);
 	if (SDL_SetRenderTarget(g->gameWindow.renderer, g->bkgTgt) != 0)
 	{
 		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
@@ -34,10 +34,16 @@
 
 #include <cdogs/XGetopt.h>
 #include <cdogs/config.h>
+#include <cdogs/config_io.h>
 #include <cdogs/log.h>
+#include <cdogs/net_shim.h>
+#include <cdogs/player.h>
+#include <cdogs/profiler.h>
 #include <cdogs/sys_config.h>
 #include <cdogs/utils.h>
 
+#include "replay.h"
+
 void PrintTitle(void)
 {
 	printf("C-Dogs SDL %s\n", CDOGS_SDL_VERSION);
@@ -94,7 +100,37 @@ void PrintHelp(void)
 		"%s\n",
 		"Other:\n"
 		"    --connect=host   (Experimental) connect to a game server\n"
-		"    --demo           (Experimental) run game for 30 seconds\n");
+		"    --net-shim=L,J,P[,S]\n"
+		"                     Connect through a local relay that delays\n"
+		"                     datagrams by L ms, +/- J ms, and drops a\n"
+		"                     fraction P of them, using random seed S\n"
+		"    --demo           (Experimental) run game for 30 seconds\n"
+		"    --trace=F        Write a Chrome trace_event profile to file F\n");
+
+	printf(
+		"%s\n",
+		"Headless (no window, renderer or audio):\n"
+		"    --headless       Run a mission with AI players and quit,\n"
+		"                     printing ticks/sec. The campaign is loaded\n"
+		"                     from the path argument, or quick play if none\n"
+		"    --mission=N      Mission index to run (default 0)\n"
+		"    --seed=N         Random seed for the mission\n"
+		"    --ticks=N        Stop after N ticks (default: mission end)\n"
+		"    --players=N      Number of AI players (default 1)\n"
+		"    --realtime       Run at game speed instead of max speed\n"
+		"    --replay=F       Play back replay file F and check its state hash\n"
+		"    --record=F       Record the next mission played to replay file F\n");
+
+	printf(
+		"%s\n",
+		"Dedicated server (also the default for cdogs-sdl-server):\n"
+		"    --server         Host the campaign for network clients without\n"
+		"                     a window, logging to the console; starts from\n"
+		"                     --mission and loops the campaign until killed\n"
+		"    --server-config=F\n"
+		"                     Load config from file F instead of the user\n"
+		"                     config; use a different ListenPort in each\n"
+		"                     file to run several servers on one host\n");
 }
 
 void ProcessCommandLine(char *buf, const int argc, char *argv[])
@@ -118,7 +154,7 @@ void ProcessCommandLine(char *buf, const int argc, char *argv[])
 static void PrintConfig(const Config *c, const int indent);
 bool ParseArgs(
 	const int argc, char *argv[], ENetAddress *connectAddr,
-	const char **loadCampaign, int *demoQuitTimer)
+	const char **loadCampaign, int *demoQuitTimer, HeadlessOptions *headless)
 {
 	struct option longopts[] = {
 		{"fullscreen", no_argument, NULL, 'f'},
@@ -130,6 +166,18 @@ bool ParseArgs(
 		{"log", required_argument, NULL, 1000},
 		{"logfile", required_argument, NULL, 1001},
 		{"demo", no_argument, NULL, 1002},
+		{"headless", no_argument, NULL, 1003},
+		{"mission", required_argument, NULL, 1004},
+		{"seed", required_argument, NULL, 1005},
+		{"ticks", required_argument, NULL, 1006},
+		{"players", required_argument, NULL, 1007},
+		{"realtime", no_argument, NULL, 1008},
+		{"record", required_argument, NULL, 1009},
+		{"replay", required_argument, NULL, 1010},
+		{"trace", required_argument, NULL, 1011},
+		{"server", no_argument, NULL, 1012},
+		{"server-config", required_argument, NULL, 1013},
+		{"net-shim", required_argument, NULL, 1014},
 		{"help", no_argument, NULL, 'h'},
 		{0, 0, NULL, 0}};
 	int opt = 0;
@@ -200,6 +248,54 @@ bool ParseArgs(
 			*demoQuitTimer = 30 * 1000;
 			printf("Entering demo mode; will auto-quit in 30 seconds\n");
 			break;
+		case 1003:
+			headless->Enabled = true;
+			break;
+		case 1004:
+			headless->MissionIndex = MAX(atoi(optarg), 0);
+			break;
+		case 1005:
+			headless->HasSeed = true;
+			headless->Seed = atoi(optarg);
+			break;
+		case 1006:
+			headless->MaxTicks = MAX(atoi(optarg), 0);
+			break;
+		case 1007:
+			headless->NumPlayers = CLAMP(atoi(optarg), 0, MAX_LOCAL_PLAYERS);
+			break;
+		case 1008:
+			headless->Realtime = true;
+			break;
+		case 1009:
+			gReplay.Mode = REPLAY_MODE_RECORD;
+			CFREE(gReplay.Filename);
+			CSTRDUP(gReplay.Filename, optarg);
+			break;
+		case 1010:
+			headless->Enabled = true;
+			gReplay.Mode = REPLAY_MODE_PLAY;
+			CFREE(gReplay.Filename);
+			CSTRDUP(gReplay.Filename, optarg);
+			break;
+		case 1011:
+			ProfilerStartTrace(&gProfiler, optarg);
+			break;
+		case 1012:
+			HeadlessOptionsSetServer(headless);
+			break;
+		case 1013:
+			// Replaces any config set by earlier options
+			LOG(LM_MAIN, LL_INFO, "Loading config %s", optarg);
+			ConfigDestroy(&gConfig);
+			gConfig = ConfigLoad(optarg);
+			break;
+		case 1014:
+			if (!NetShimOptionsParse(&gNetShimOptions, optarg))
+			{
+				printf("Error: invalid net shim options %s\n", optarg);
+			}
+			break;
 		case 'x':
 			if (enet_address_set_host(connectAddr, optarg) != 0)
 			{
@@ -31,6 +31,8 @@
 
 #include <enet/enet.h>
 
+#include "headless.h"
+
 
 void PrintTitle(void);
 
@@ -41,4 +43,5 @@ void ProcessCommandLine(char *buf, const int argc, char *argv[]);
 // Parse command-line arguments and set config. Returns whether to run the game
 bool ParseArgs(
 	const int argc, char *argv[],
-	ENetAddress *connectAddr, const char **loadCampaign, int *demoQuitTimer);
+	ENetAddress *connectAddr, const char **loadCampaign, int *demoQuitTimer,
+	HeadlessOptions *headless);
@@ -55,6 +55,7 @@
 #include <cdogs/ai.h>
 #include <cdogs/ai_coop.h>
 #include <cdogs/automap.h>
+#include <cdogs/draw/draw_actor.h>
 #include <cdogs/draw/drawtools.h>
 #include <cdogs/events.h>
 #include <cdogs/grafx_bg.h>
@@ -67,10 +68,12 @@
 #include <cdogs/net_server.h>
 #include <cdogs/objs.h>
 #include <cdogs/pickup.h>
+#include <cdogs/profiler.h>
 
 #include "briefing_screens.h"
 #include "loading_screens.h"
 #include "prep.h"
+#include "replay.h"
 #include "screens_end.h"
 
 static void PlayerSpecialCommands(TActor *actor, const int cmd)
@@ -156,17 +159,38 @@ static void RunGameOnEnter(GameLoopData *data)
 
 	RunGameReset(rData);
 
+	if (gReplay.Mode == REPLAY_MODE_RECORD)
+	{
+		ReplayRecordStart(&gReplay);
+	}
+
 	CampaignSeedRandom(rData->co);
 	MapBuild(
 		rData->map, rData->m->missionData, !rData->co->IsClient,
 		rData->m->index, rData->co->Entry.Mode,
 		&rData->co->Setting.characters);
 
+	// Generate the mission's character sprites now, instead of the first
+	// time each character is drawn
+	if (!gGraphicsDevice.IsHeadless)
+	{
+		CA_FOREACH(
+			const Character, c, rData->co->Setting.characters.OtherChars)
+		PreloadCharacterPics(c, c->Gun);
+		CA_FOREACH_END()
+		CA_FOREACH(const PlayerData, p, gPlayerDatas)
+		for (int i = 0; i < MAX_WEAPONS; i++)
+		{
+			PreloadCharacterPics(&p->Char, p->guns[i]);
+		}
+		CA_FOREACH_END()
+	}
+
 	// Seed random if PVP mode (otherwise players will always spawn in same
 	// position)
 	if (IsPVP(rData->co->Entry.Mode))
 	{
-		srand((unsigned int)time(NULL));
+		srand(ReplaySpawnSeed(&gReplay, (unsigned int)time(NULL)));
 	}
 
 	if (!rData->co->IsClient)
@@ -269,6 +293,8 @@ static void RunGameOnExit(GameLoopData *data)
 
 	LOG(LM_MAIN, LL_INFO, "Game finished");
 
+	ReplayEnd(&gReplay);
+
 	// Flush events
 	HandleGameEvents(&gGameEvents, NULL, NULL, NULL, NULL);
 
@@ -402,6 +428,10 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
 {
 	RunGameData *rData = data->Data;
 
+	// Things are drawn between where they were at the start of this update
+	// and where they end up
+	ThingsStoreLastPos();
+
 	// Detect exit
 	if (rData->m->isDone)
 	{
@@ -495,6 +525,15 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
 
 	const int ticksPerFrame = 1;
 
+	if (!ReplayTick(&gReplay, rData->cmds))
+	{
+		// Playback finished; end the mission as if the player quit
+		NMissionEnd end = NMissionEnd_init_default;
+		end.IsQuit = true;
+		MissionDone(rData->m, end);
+		return UPDATE_RESULT_OK;
+	}
+
 	if (gPlayerDatas.size > 0)
 	{
 		LOSReset(&gMap.LOS);
@@ -506,8 +545,10 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
 			TActor *player = ActorGetByUID(p->ActorUID);
 
 			// Calculate LOS for all players alive or dying
+			const Uint64 t = ProfilerBegin();
 			LOSCalcFrom(
 				&gMap, Vec2ToTile(player->thing.Pos), !gCampaign.IsClient);
+			ProfilerEnd(PROFILE_LOS, t);
 
 			if (player->dead)
 				continue;
@@ -530,6 +571,8 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
 
 	// Disable sounds on the first frame
 	GameUpdate(rData, ticksPerFrame, data->Frames == 0 ? NULL : &gSoundDevice);
+	NetServerSendSnapshots(&gNetServer, ticksPerFrame);
+	NetClientUpdate(&gNetClient, ticksPerFrame);
 
 	CameraUpdate(&rData->Camera, ticksPerFrame, 1000 / data->FPS);
 
@@ -699,7 +742,9 @@ void GameInit(
 void GameUpdate(RunGameData *data, const int ticksPerFrame, SoundDevice *sd)
 {
 	// Update all the things in the game
+	const Uint64 updateStart = ProfilerBegin();
 
+	Uint64 t = ProfilerBegin();
 	if (!gCampaign.IsClient)
 	{
 		data->aiUpdateCounter -= ticksPerFrame;
@@ -714,15 +759,30 @@ void GameUpdate(RunGameData *data, const int ticksPerFrame, SoundDevice *sd)
 			AICommandLast(ticksPerFrame);
 		}
 	}
+	ProfilerEnd(PROFILE_AI, t);
 
+	t = ProfilerBegin();
 	UpdateAllActors(ticksPerFrame);
+	ProfilerEnd(PROFILE_ACTORS, t);
+	t = ProfilerBegin();
 	UpdateObjects(ticksPerFrame);
+	ProfilerEnd(PROFILE_OBJECTS, t);
+	t = ProfilerBegin();
 	UpdateMobileObjects(ticksPerFrame);
+	ProfilerEnd(PROFILE_MOBOBJS, t);
+	t = ProfilerBegin();
 	PickupsUpdate(&gPickups, ticksPerFrame);
+	ProfilerEnd(PROFILE_PICKUPS, t);
+	t = ProfilerBegin();
 	ParticlesUpdate(&gParticles, ticksPerFrame);
+	ProfilerEnd(PROFILE_PARTICLES, t);
+	t = ProfilerBegin();
 	MapUpdate(data->map);
+	ProfilerEnd(PROFILE_MAP, t);
 
+	t = ProfilerBegin();
 	UpdateWatches(&data->map->triggers, ticksPerFrame);
+	ProfilerEnd(PROFILE_WATCHES, t);
 
 	PowerupSpawnerUpdate(&data->healthSpawner, ticksPerFrame);
 	CA_FOREACH(PowerupSpawner, a, data->ammoSpawners)
@@ -740,9 +800,11 @@ void GameUpdate(RunGameData *data, const int ticksPerFrame, SoundDevice *sd)
 		MissionDone(&gMission, me);
 	}
 
+	t = ProfilerBegin();
 	HandleGameEvents(
 		&gGameEvents, &data->Camera, &data->healthSpawner, &data->ammoSpawners,
 		sd);
+	ProfilerEnd(PROFILE_EVENTS, t);
 
 	data->m->time += ticksPerFrame;
 
@@ -750,4 +812,5 @@ void GameUpdate(RunGameData *data, const int ticksPerFrame, SoundDevice *sd)
 	{
 		RunGameReset(data);
 	}
+	ProfilerEnd(PROFILE_UPDATE, updateStart);
 }
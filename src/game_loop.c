@@ -31,10 +31,13 @@
 #include <SDL_timer.h>
 
 #include "config.h"
+#include "draw/sprite_batch.h"
 #include "events.h"
 #include "net_client.h"
 #include "net_server.h"
+#include "profiler.h"
 #include "sounds.h"
+#include "thing.h"
 
 #ifdef __EMSCRIPTEN__
 #include <autosave.h>
@@ -155,6 +158,7 @@ LoopRunner LoopRunnerNew(void)
 {
 	LoopRunner l;
 	CArrayInit(&l.Loops, sizeof(GameLoopData *));
+	l.Generation = 0;
 	return l;
 }
 static void GameLoopTerminate(GameLoopData *data);
@@ -178,27 +182,50 @@ typedef struct
 	int FrameDurationMs;
 	int FramesSkipped;
 	int MaxFrameskip;
+	// Draw between fixed-rate updates, interpolating thing positions
+	bool Interpolate;
 } LoopRunParams;
 typedef struct
 {
 	LoopRunner *l;
 	GameLoopData *data;
 	LoopRunParams p;
+	// Don't draw; for running the simulation without a renderer
+	bool headless;
+	// Don't wait between frames; each frame advances by a fixed tick
+	bool unthrottled;
 } LoopRunInnerData;
 static LoopRunParams LoopRunParamsNew(const GameLoopData *data);
 static bool LoopRunParamsShouldSleep(LoopRunParams *p);
 static bool LoopRunParamsShouldSkip(LoopRunParams *p);
+static void LoopRunnerDraw(LoopRunInnerData *ctx);
 bool LoopRunnerRunInner(LoopRunInnerData *ctx)
 {
 #ifndef __EMSCRIPTEN__
 	// Frame rate control
-	if (LoopRunParamsShouldSleep(&(ctx->p)))
+	if (ctx->unthrottled)
 	{
-		SDL_Delay(1);
+		ctx->p.TicksElapsed = ctx->p.FrameDurationMs;
+	}
+	else if (LoopRunParamsShouldSleep(&(ctx->p)))
+	{
+		// Not time to update yet; draw an in-between frame if interpolating
+		// (paced by vsync), otherwise wait
+		if (ctx->p.Interpolate && !ctx->headless &&
+			ctx->data->HasDrawnFirst && ctx->p.Result == UPDATE_RESULT_DRAW)
+		{
+			LoopRunnerDraw(ctx);
+		}
+		else
+		{
+			SDL_Delay(1);
+		}
 		return true;
 	}
 #endif
 
+	ProfilerNewFrame(&gProfiler);
+
 	// Input
 	if ((ctx->data->Frames & 1) || !ctx->data->InputEverySecondFrame)
 	{
@@ -209,17 +236,20 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx)
 		}
 	}
 
+	Uint64 t = ProfilerBegin();
 	NetClientPoll(&gNetClient);
 	NetServerPoll(&gNetServer);
+	ProfilerEnd(PROFILE_NET_POLL, t);
 
 	// Update
+	const int generation = ctx->l->Generation;
 	ctx->p.Result = ctx->data->UpdateFunc(ctx->data, ctx->l);
 	GameLoopData *newData = GetCurrentLoop(ctx->l);
 	if (newData == NULL)
 	{
 		return false;
 	}
-	else if (newData != ctx->data)
+	else if (ctx->l->Generation != generation)
 	{
 		GameLoopData *parent = GetParentLoop(ctx->l);
 		CA_FOREACH(GameLoopData *, data, ctx->l->Loops)
@@ -240,8 +270,10 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx)
 		return true;
 	}
 
+	t = ProfilerBegin();
 	NetServerFlush(&gNetServer);
 	NetClientFlush(&gNetClient);
+	ProfilerEnd(PROFILE_NET_FLUSH, t);
 
 	bool draw = !ctx->data->HasDrawnFirst;
 	switch (ctx->p.Result)
@@ -266,36 +298,51 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx)
 #endif
 
 	// Draw
-	if (draw)
+	if (draw && !ctx->headless)
 	{
-		WindowContextPreRender(&gGraphicsDevice.gameWindow);
-		if (gGraphicsDevice.cachedConfig.SecondWindow)
-		{
-			WindowContextPreRender(&gGraphicsDevice.secondWindow);
-		}
-		if (ctx->data->DrawParent)
-		{
-			GameLoopData *parent = GetParentLoop(ctx->l);
-			if (parent && parent->DrawFunc)
-			{
-				GameLoopOnEnter(parent);
-				parent->DrawFunc(parent);
-			}
-		}
-		if (ctx->data->DrawFunc)
-		{
-			ctx->data->DrawFunc(ctx->data);
-		}
-		WindowContextPostRender(&gGraphicsDevice.gameWindow);
-		if (gGraphicsDevice.cachedConfig.SecondWindow)
-		{
-			WindowContextPostRender(&gGraphicsDevice.secondWindow);
-		}
-		ctx->data->HasDrawnFirst = true;
+		LoopRunnerDraw(ctx);
 	}
 
 	return true;
 }
+static void LoopRunnerDraw(LoopRunInnerData *ctx)
+{
+	// Draw at the fraction of time elapsed towards the next update
+	gThingDrawAlpha = 1.0f;
+	if (ctx->p.Interpolate && ctx->p.FrameDurationMs > 0)
+	{
+		gThingDrawAlpha = CLAMP(
+			(float)ctx->p.TicksElapsed / ctx->p.FrameDurationMs, 0.0f, 1.0f);
+	}
+	// Time every draw, including the interpolated ones between updates
+	const Uint64 t = ProfilerBegin();
+	WindowContextPreRender(&gGraphicsDevice.gameWindow);
+	if (gGraphicsDevice.cachedConfig.SecondWindow)
+	{
+		WindowContextPreRender(&gGraphicsDevice.secondWindow);
+	}
+	if (ctx->data->DrawParent)
+	{
+		GameLoopData *parent = GetParentLoop(ctx->l);
+		if (parent && parent->DrawFunc)
+		{
+			GameLoopOnEnter(parent);
+			parent->DrawFunc(parent);
+		}
+	}
+	if (ctx->data->DrawFunc)
+	{
+		ctx->data->DrawFunc(ctx->data);
+	}
+	WindowContextPostRender(&gGraphicsDevice.gameWindow);
+	if (gGraphicsDevice.cachedConfig.SecondWindow)
+	{
+		WindowContextPostRender(&gGraphicsDevice.secondWindow);
+	}
+	SpriteBatchEndFrame(&gSpriteBatch);
+	ProfilerEnd(PROFILE_DRAW, t);
+	ctx->data->HasDrawnFirst = true;
+}
 
 #ifdef __EMSCRIPTEN__
 void EmscriptenMainLoop(void *arg)
@@ -319,6 +366,8 @@ void LoopRunnerRun(LoopRunner *l)
 	ctx.l = l;
 	ctx.data = data;
 	ctx.p = LoopRunParamsNew(data);
+	ctx.headless = false;
+	ctx.unthrottled = false;
 
 #ifdef __EMSCRIPTEN__
 	// TODO use GameLoopData->FPS instead of FPS_FRAMELIMIT?
@@ -333,6 +382,41 @@ void LoopRunnerRun(LoopRunner *l)
 	}
 #endif
 }
+int LoopRunnerRunHeadless(
+	LoopRunner *l, const int maxFrames, const bool unthrottled)
+{
+	GameLoopData *data = GetCurrentLoop(l);
+	if (data == NULL)
+	{
+		return 0;
+	}
+	GameLoopOnEnter(data);
+
+	LoopRunInnerData ctx;
+	ctx.l = l;
+	ctx.data = data;
+	ctx.p = LoopRunParamsNew(data);
+	ctx.headless = true;
+	ctx.unthrottled = unthrottled;
+
+	// Only run the starting loop; stop as soon as it is replaced (at which
+	// point it may have been freed)
+	const int generation = l->Generation;
+	int frames = 0;
+	while (l->Generation == generation &&
+		   (maxFrames <= 0 || frames < maxFrames))
+	{
+		if (!LoopRunnerRunInner(&ctx))
+		{
+			break;
+		}
+		if (l->Generation == generation)
+		{
+			frames = data->Frames;
+		}
+	}
+	return frames;
+}
 static LoopRunParams LoopRunParamsNew(const GameLoopData *data)
 {
 	LoopRunParams p;
@@ -342,6 +426,7 @@ static LoopRunParams LoopRunParamsNew(const GameLoopData *data)
 	p.FrameDurationMs = 1000 / data->FPS;
 	p.FramesSkipped = 0;
 	p.MaxFrameskip = data->FPS / 5;
+	p.Interpolate = ConfigGetBool(&gConfig, "Graphics.FrameInterpolation");
 	return p;
 }
 static bool LoopRunParamsShouldSleep(LoopRunParams *p)
@@ -380,6 +465,7 @@ void LoopRunnerChange(LoopRunner *l, GameLoopData *newData)
 void LoopRunnerPush(LoopRunner *l, GameLoopData *newData)
 {
 	CArrayPushBack(&l->Loops, &newData);
+	l->Generation++;
 }
 void LoopRunnerPop(LoopRunner *l)
 {
@@ -387,6 +473,7 @@ void LoopRunnerPop(LoopRunner *l)
 	GameLoopOnExit(data);
 	GameLoopTerminate(data);
 	CArrayDelete(&l->Loops, l->Loops.size - 1);
+	l->Generation++;
 }
 
 static void GameLoopTerminate(GameLoopData *data)
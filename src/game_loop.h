@@ -43,6 +43,9 @@ typedef enum
 typedef struct
 {
 	CArray Loops; // of GameLoopData *
+	// Incremented whenever a loop is pushed or popped; popped loops are
+	// freed, so compare this instead of loop pointers to detect changes
+	int Generation;
 } LoopRunner;
 
 // Generic game loop manager, with callbacks for update/draw
@@ -76,6 +79,11 @@ GameLoopData *GameLoopDataNew(
 LoopRunner LoopRunnerNew(void);
 void LoopRunnerTerminate(LoopRunner *l);
 void LoopRunnerRun(LoopRunner *l);
+// Run the current loop without drawing, until it is replaced or has run for
+// maxFrames (0 for no limit). Unthrottled loops run as fast as possible.
+// Returns the number of frames run.
+int LoopRunnerRunHeadless(
+	LoopRunner *l, const int maxFrames, const bool unthrottled);
 
 void LoopRunnerChange(LoopRunner *l, GameLoopData *newData);
 void LoopRunnerPush(LoopRunner *l, GameLoopData *newData);
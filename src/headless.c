@@ -0,0 +1,347 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "headless.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <SDL_timer.h>
+
+#include <cdogs/ai_coop.h>
+#include <cdogs/campaigns.h>
+#include <cdogs/config.h>
+#include <cdogs/game_events.h>
+#include <cdogs/gamedata.h>
+#include <cdogs/handle_game_events.h>
+#include <cdogs/log.h>
+#include <cdogs/net_client.h>
+#include <cdogs/net_server.h>
+#include <cdogs/player.h>
+#include <cdogs/profiler.h>
+
+#include "game.h"
+#include "replay.h"
+
+HeadlessOptions HeadlessOptionsDefault(void)
+{
+	HeadlessOptions o;
+	memset(&o, 0, sizeof o);
+	o.NumPlayers = 1;
+	return o;
+}
+
+void HeadlessOptionsSetServer(HeadlessOptions *o)
+{
+	o->Enabled = true;
+	o->Server = true;
+	for (LogModule m = LM_MAIN; m <= LM_NET; m++)
+	{
+		if (LogModuleGetLevel(m) > LL_INFO)
+		{
+			LogModuleSetLevel(m, LL_INFO);
+		}
+	}
+}
+
+static bool LoadCampaign(const char *campaignPath, const GameMode mode);
+static void AddAIPlayers(const int numPlayers);
+static int RunServer(const int firstMission);
+int HeadlessRun(const HeadlessOptions *opts, const char *campaignPath)
+{
+	const bool isReplay = gReplay.Mode == REPLAY_MODE_PLAY;
+	int missionIndex = opts->MissionIndex;
+	GameMode mode;
+	if (isReplay)
+	{
+		if (!ReplayLoad(&gReplay, gReplay.Filename))
+		{
+			printf("Error: failed to load replay\n");
+			return EXIT_FAILURE;
+		}
+		ReplayApplySetup(&gReplay);
+		campaignPath = gReplay.CampaignPath;
+		missionIndex = gReplay.MissionIndex;
+		mode = gReplay.CampaignMode;
+	}
+	else if (campaignPath == NULL)
+	{
+		mode = GAME_MODE_QUICK_PLAY;
+	}
+	else
+	{
+		mode = strstr(campaignPath, "/" CDOGS_DOGFIGHT_DIR "/") != NULL
+				   ? GAME_MODE_DOGFIGHT
+				   : GAME_MODE_NORMAL;
+	}
+	if (!LoadCampaign(campaignPath, mode))
+	{
+		return EXIT_FAILURE;
+	}
+	if (missionIndex < 0 ||
+		missionIndex >= (int)gCampaign.Setting.Missions.size)
+	{
+		printf(
+			"Error: mission %d out of range (campaign has %d missions)\n",
+			missionIndex, (int)gCampaign.Setting.Missions.size);
+		return EXIT_FAILURE;
+	}
+	gCampaign.MissionIndex = missionIndex;
+	if (opts->HasSeed && !isReplay)
+	{
+		ConfigSetInt(&gConfig, "Game.RandomSeed", opts->Seed);
+	}
+	if (opts->Server)
+	{
+		return RunServer(missionIndex);
+	}
+
+	GameEventsInit(&gGameEvents);
+	MissionOptionsTerminate(&gMission);
+	CampaignAndMissionSetup(&gCampaign, &gMission);
+	if (isReplay)
+	{
+		AddAIPlayers(gReplay.NumPlayers);
+		ReplayApplyPlayers(&gReplay);
+	}
+	else
+	{
+		AddAIPlayers(opts->NumPlayers);
+	}
+
+	GameLoopData *g = RunGame(&gCampaign, &gMission, &gMap);
+	const int fps = g->FPS;
+	LoopRunner l = LoopRunnerNew();
+	LoopRunnerPush(&l, g);
+
+	LOG(LM_MAIN, LL_INFO, "Running headless mission %d seed(%d)",
+		gCampaign.MissionIndex, ConfigGetInt(&gConfig, "Game.RandomSeed"));
+	const Uint64 start = SDL_GetPerformanceCounter();
+	const int ticks = LoopRunnerRunHeadless(
+		&l, isReplay ? 0 : opts->MaxTicks, !opts->Realtime);
+	const double seconds = (double)(SDL_GetPerformanceCounter() - start) /
+						   (double)SDL_GetPerformanceFrequency();
+	const bool complete = MissionAllObjectivesComplete(&gMission);
+	// If stopped before the mission ended, finish recording/playback here
+	ReplayEnd(&gReplay);
+	LoopRunnerTerminate(&l);
+	GameEventsTerminate(&gGameEvents);
+
+	const double ticksPerSec = seconds > 0 ? ticks / seconds : 0;
+	printf(
+		"Mission %d %s: %d ticks in %.3fs, %.1f ticks/sec (%.1fx realtime)\n",
+		missionIndex, complete ? "complete" : "incomplete", ticks,
+		seconds, ticksPerSec, fps > 0 ? ticksPerSec / fps : 0);
+	if (gProfiler.Enabled)
+	{
+		for (ProfilePhase p = 0; p < PROFILE_DRAW; p++)
+		{
+			printf(
+				"  %-16s %.3fms/tick\n", ProfilePhaseStr(p),
+				ProfilerGetAverage(&gProfiler, p));
+		}
+	}
+	return gReplay.Desynced ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+// Check for clients this often while idle, and whether they have all left
+// while playing
+#define SERVER_IDLE_MS 250
+// Start the mission without clients that are still loading or equipping
+// after this long; they join the mission in progress when ready
+#define SERVER_READY_TIMEOUT_MS 60000
+static volatile sig_atomic_t sServerQuit = 0;
+static void OnServerSignal(int sig)
+{
+	UNUSED(sig);
+	sServerQuit = 1;
+}
+static void ServerIdle(void);
+static bool RunServerMission(void);
+static int RunServer(const int firstMission)
+{
+	// Keep the game running without local players, as if hosting
+	ConfigGet(&gConfig, "StartServer")->u.Bool.Value = true;
+	const uint16_t port = (uint16_t)ConfigGetInt(&gConfig, "ListenPort");
+	NetServerOpen(&gNetServer, port);
+	if (gNetServer.server == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Failed to start server");
+		return EXIT_FAILURE;
+	}
+	signal(SIGINT, OnServerSignal);
+	signal(SIGTERM, OnServerSignal);
+	LOG(LM_MAIN, LL_INFO, "Server hosting %s on port %u",
+		gCampaign.Setting.Title, port);
+	// Clients send their players before the mission starts
+	GameEventsInit(&gGameEvents);
+
+	bool waitingForReady = false;
+	Uint32 waitStart = 0;
+	while (!sServerQuit)
+	{
+		// Sleep until a client connects
+		if (gNetServer.server->connectedPeers == 0)
+		{
+			waitingForReady = false;
+			ServerIdle();
+			continue;
+		}
+
+		// Start when every client is ready, so that clients connecting
+		// around the same time all make the start
+		if (!NetServerAllPeersReady(&gNetServer))
+		{
+			const Uint32 now = SDL_GetTicks();
+			if (!waitingForReady)
+			{
+				LOG(LM_MAIN, LL_INFO, "Waiting for clients to be ready");
+				waitingForReady = true;
+				waitStart = now;
+			}
+			if (now - waitStart < SERVER_READY_TIMEOUT_MS)
+			{
+				ServerIdle();
+				continue;
+			}
+			LOG(LM_MAIN, LL_WARN,
+				"Timed out waiting for clients; starting without them");
+		}
+		waitingForReady = false;
+
+		if (!RunServerMission())
+		{
+			LOG(LM_MAIN, LL_INFO, "All clients left; waiting for clients");
+		}
+		NetServerUnreadyPeers(&gNetServer);
+		// Start again once the campaign is over
+		if (gCampaign.IsComplete ||
+			gCampaign.MissionIndex >= (int)gCampaign.Setting.Missions.size)
+		{
+			gCampaign.IsComplete = false;
+			gCampaign.MissionIndex = firstMission;
+		}
+	}
+
+	LOG(LM_MAIN, LL_INFO, "Server shutting down");
+	NetServerClose(&gNetServer);
+	GameEventsTerminate(&gGameEvents);
+	return EXIT_SUCCESS;
+}
+static void ServerIdle(void)
+{
+	NetServerWait(&gNetServer, SERVER_IDLE_MS);
+	NetServerPoll(&gNetServer);
+	NetServerFlush(&gNetServer);
+}
+// Returns false if the mission was abandoned because everyone left
+static bool RunServerMission(void)
+{
+	MissionOptionsTerminate(&gMission);
+	CampaignAndMissionSetup(&gCampaign, &gMission);
+	GameLoopData *g = RunGame(&gCampaign, &gMission, &gMap);
+	const int fps = g->FPS;
+	LoopRunner l = LoopRunnerNew();
+	LoopRunnerPush(&l, g);
+	LOG(LM_MAIN, LL_INFO, "Starting mission %d", gCampaign.MissionIndex);
+
+	// Run in short stretches so that we can check for clients leaving
+	bool abandoned = false;
+	for (int frames = 0;;)
+	{
+		const int target = frames + MAX(fps * SERVER_IDLE_MS / 1000, 1);
+		frames = LoopRunnerRunHeadless(&l, target, false);
+		if (frames < target)
+		{
+			// Mission over
+			break;
+		}
+		if (sServerQuit || gNetServer.server == NULL ||
+			gNetServer.server->connectedPeers == 0)
+		{
+			abandoned = true;
+			break;
+		}
+	}
+	LOG(LM_MAIN, LL_INFO, "Mission %d %s", gMission.index,
+		abandoned ? "abandoned"
+				  : (MissionAllObjectivesComplete(&gMission) ? "complete"
+															 : "over"));
+	LoopRunnerTerminate(&l);
+	GameEventsClear(&gGameEvents);
+	return !abandoned;
+}
+
+static bool LoadCampaign(const char *campaignPath, const GameMode mode)
+{
+	gCampaign.Entry.Mode = mode;
+	if (mode == GAME_MODE_QUICK_PLAY)
+	{
+		LOG(LM_MAIN, LL_INFO, "Loading quick play...");
+		if (!CampaignLoad(&gCampaign, &gCampaign.Entry))
+		{
+			printf("Error: failed to load quick play campaign\n");
+			return false;
+		}
+		return true;
+	}
+	LOG(LM_MAIN, LL_INFO, "Loading campaign %s...", campaignPath);
+	CampaignEntry entry;
+	if (!CampaignEntryTryLoad(&entry, campaignPath, GAME_MODE_NORMAL) ||
+		!CampaignLoad(&gCampaign, &entry))
+	{
+		printf("Error: failed to load campaign %s\n", campaignPath);
+		return false;
+	}
+	return true;
+}
+static void AddAIPlayers(const int numPlayers)
+{
+	for (int i = 0; i < MIN(numPlayers, MAX_LOCAL_PLAYERS); i++)
+	{
+		GameEvent e = GameEventNew(GAME_EVENT_PLAYER_DATA);
+		e.u.PlayerData = PlayerDataDefault(i);
+		e.u.PlayerData.UID = gNetClient.FirstPlayerUID + i;
+		GameEventsEnqueue(&gGameEvents, e);
+	}
+	// Process the events to force add the players
+	HandleGameEvents(&gGameEvents, NULL, NULL, NULL, NULL);
+
+	int idx = 0;
+	CA_FOREACH(PlayerData, p, gPlayerDatas)
+	if (!p->IsLocal)
+	{
+		continue;
+	}
+	PlayerTrySetInputDevice(p, INPUT_DEVICE_AI, 0);
+	if (gMission.Weapons.size > 0)
+	{
+		AICoopSelectWeapons(p, idx, &gMission.Weapons);
+	}
+	idx++;
+	CA_FOREACH_END()
+}
@@ -0,0 +1,59 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+// Options for running missions without a window, renderer or audio device
+typedef struct
+{
+	bool Enabled;
+	int MissionIndex;
+	// Random seed for the mission; overrides Game.RandomSeed if set
+	bool HasSeed;
+	int Seed;
+	// Stop after this many game ticks; 0 to run until the mission ends
+	int MaxTicks;
+	// Number of AI-controlled players
+	int NumPlayers;
+	// Throttle to Game.FPS instead of running as fast as possible
+	bool Realtime;
+	// Host the campaign for network clients instead of running AI players,
+	// until interrupted
+	bool Server;
+} HeadlessOptions;
+
+HeadlessOptions HeadlessOptionsDefault(void);
+// Run as a dedicated server, with connections and missions logged
+void HeadlessOptionsSetServer(HeadlessOptions *o);
+
+// Load the campaign (or quick play if NULL) and run a single mission.
+// Prints ticks per second when finished. Returns the process exit code.
+// If running as a server, missions are run in turn while clients are
+// connected, and the server sleeps while there are none.
+int HeadlessRun(const HeadlessOptions *opts, const char *campaignPath);
@@ -122,6 +122,10 @@ static void LoadingScreenDrawInner(
 void LoadingScreenDraw(
 	LoadingScreen *l, const char *loadingText, const float showPct)
 {
+	if (l->g->IsHeadless)
+	{
+		return;
+	}
 	WindowContextPreRender(&l->g->gameWindow);
 
 	LoadingScreenDrawInner(l, loadingText, showPct);
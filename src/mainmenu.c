@@ -483,7 +483,8 @@ typedef struct
 {
 	MenuSystem *MS;
 	LoopRunner *L;
-	int AddrIndex;
+	// The list may be rescanned while the menu is open, so keep the address
+	ENetAddress Addr;
 } JoinLANGameData;
 static void JoinLANGame(menu_t *menu, void *data);
 static void CreateLANServerMenuItems(menu_t *menu, void *data)
@@ -502,20 +503,21 @@ static void CreateLANServerMenuItems(menu_t *menu, void *data)
 		ipbuf[1] = '\0';
 	};
 	// e.g. "Bob's Server (123.45.67.89:12345) - Campaign: Ogre Rampage #4, p:
-	// 4/16 350ms"
+	// 4/16 350ms, in game"
 	sprintf(
-		buf, "%s (%s:%u) - %s: %s (# %d), p: %d/%d %dms",
+		buf, "%s (%s:%u) - %s: %s (# %d), p: %d/%d %dms, %s",
 		si->ServerInfo.Hostname, ipbuf, si->Addr.port,
 		GameModeStr(si->ServerInfo.GameMode), si->ServerInfo.CampaignName,
 		si->ServerInfo.MissionNumber, si->ServerInfo.NumPlayers,
-		si->ServerInfo.MaxPlayers, si->LatencyMS);
+		si->ServerInfo.MaxPlayers, si->LatencyMS,
+		si->ServerInfo.HasStarted ? "in game" : "lobby");
 	menu_t *serverMenu = MenuCreate(buf, MENU_TYPE_RETURN);
 	serverMenu->enterSound = MENU_SOUND_START;
 	JoinLANGameData *jdata;
 	CMALLOC(jdata, sizeof *jdata);
 	jdata->MS = cData->MS;
 	jdata->L = cData->L;
-	jdata->AddrIndex = _ca_index;
+	jdata->Addr = si->Addr;
 	MenuSetPostEnterFunc(serverMenu, JoinLANGame, jdata, true);
 	MenuAddSubmenu(menu, serverMenu);
 	CA_FOREACH_END()
@@ -525,14 +527,8 @@ static void CreateLANServerMenuItems(menu_t *menu, void *data)
 static void JoinLANGame(menu_t *menu, void *data)
 {
 	JoinLANGameData *jdata = data;
-	if (jdata->AddrIndex >= (int)gNetClient.ScannedAddrs.size)
-	{
-		goto bail;
-	}
-	const ScanInfo *sinfo =
-		CArrayGet(&gNetClient.ScannedAddrs, jdata->AddrIndex);
 	LOG(LM_MAIN, LL_INFO, "joining LAN game...");
-	if (NetClientTryConnect(&gNetClient, sinfo->Addr))
+	if (NetClientTryConnect(&gNetClient, jdata->Addr))
 	{
 		LoopRunnerPush(jdata->L, ScreenWaitForCampaignDef());
 		goto bail;
@@ -559,7 +555,7 @@ static void CheckLANServers(menu_t *menu, void *data)
 		// We haven't found any LAN servers in the latest scan
 		MenuDisableSubmenu(menu, cdata->MenuJoinIndex);
 	}
-	if (gNetClient.ScanTicks <= 0)
+	if (!NetClientIsScanning(&gNetClient))
 	{
 		LOG(LM_MAIN, LL_DEBUG, "finding LAN server...");
 		NetClientFindLANServers(&gNetClient);
@@ -129,6 +129,7 @@ void MenuDisplayPlayerControls(
 		}
 		break;
 	case INPUT_DEVICE_AI:
+	case INPUT_DEVICE_REPLAY:
 		sprintf(s, "(%s)",
 			InputDeviceName(pData->inputDevice, pData->deviceIndex));
 		FontStr(s, svec2i(pos.x - FontStrW(s) / 2, y));
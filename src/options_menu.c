@@ -139,6 +139,8 @@ static menu_t *MenuCreateOptionsGraphics(
 		menu, ConfigGet(data->config, "Graphics.Shadows"));
 	MenuAddConfigOptionsItem(menu, ConfigGet(data->config, "Graphics.Gore"));
 	MenuAddConfigOptionsItem(menu, ConfigGet(data->config, "Graphics.Brass"));
+	MenuAddConfigOptionsItem(
+		menu, ConfigGet(data->config, "Graphics.FrameInterpolation"));
 	MenuAddSubmenu(menu, MenuCreateSeparator(""));
 	MenuAddSubmenu(menu, MenuCreateBack("Done"));
 	MenuSetPostInputFunc(menu, PostInputConfigApply, data);
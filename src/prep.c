@@ -85,6 +85,8 @@ typedef struct
 {
 	MenuSystem ms;
 	GameLoopResult (*checkFunc)(void *, LoopRunner *l);
+	// Optional; updates the message each frame
+	const char *(*messageFunc)(void);
 	void *data;
 } ScreenWaitData;
 static void ScreenWaitTerminate(GameLoopData *data);
@@ -92,7 +94,7 @@ static GameLoopResult ScreenWaitUpdate(GameLoopData *data, LoopRunner *l);
 static void ScreenWaitDraw(GameLoopData *data);
 static GameLoopData *ScreenWait(
 	const char *message, GameLoopResult (*checkFunc)(void *, LoopRunner *l),
-	void *data)
+	const char *(*messageFunc)(void), void *data)
 {
 	ScreenWaitData *swData;
 	CMALLOC(swData, sizeof *swData);
@@ -104,6 +106,7 @@ static GameLoopData *ScreenWait(
 		MenuCreateNormal("", message, MENU_TYPE_NORMAL, 0);
 	MenuAddExitType(&swData->ms, MENU_TYPE_RETURN);
 	swData->checkFunc = checkFunc;
+	swData->messageFunc = messageFunc;
 	swData->data = data;
 
 	return GameLoopDataNew(
@@ -127,6 +130,13 @@ static GameLoopResult ScreenWaitUpdate(GameLoopData *data, LoopRunner *l)
 	{
 		return result;
 	}
+	if (swData->messageFunc != NULL)
+	{
+		snprintf(
+			swData->ms.root->u.normal.title,
+			sizeof swData->ms.root->u.normal.title, "%s",
+			swData->messageFunc());
+	}
 	const GameLoopResult menuResult = MenuUpdate(&swData->ms);
 	if (menuResult == UPDATE_RESULT_OK)
 	{
@@ -149,7 +159,7 @@ GameLoopData *ScreenWaitForCampaignDef(void)
 	enet_address_get_host_ip(&gNetClient.peer->address, ipbuf, sizeof ipbuf);
 	sprintf(
 		buf, "Connecting to %s:%u...", ipbuf, gNetClient.peer->address.port);
-	return ScreenWait(buf, CheckCampaignDefComplete, NULL);
+	return ScreenWait(buf, CheckCampaignDefComplete, NULL, NULL);
 }
 static GameLoopResult CheckCampaignDefComplete(void *data, LoopRunner *l)
 {
@@ -786,9 +796,22 @@ static menu_t *MenuCreateAllowedWeapons(
 }
 
 static GameLoopResult CheckGameStart(void *data, LoopRunner *l);
+static const char *GameStartMessage(void);
 GameLoopData *ScreenWaitForGameStart(void)
 {
-	return ScreenWait("Waiting for game start...", CheckGameStart, NULL);
+	return ScreenWait(
+		"Waiting for game start...", CheckGameStart, GameStartMessage, NULL);
+}
+static const char *GameStartMessage(void)
+{
+	static char buf[64];
+	const float progress = NetClientWorldProgress(&gNetClient);
+	if (progress < 0)
+	{
+		return "Waiting for game start...";
+	}
+	sprintf(buf, "Downloading world... %d%%", (int)(progress * 100));
+	return buf;
 }
 static GameLoopResult CheckGameStart(void *data, LoopRunner *l)
 {
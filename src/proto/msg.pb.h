@@ -20,6 +20,8 @@ typedef struct _NServerInfo {
     int32_t MissionNumber;
     int32_t NumPlayers;
     int32_t MaxPlayers;
+    uint32_t QueryTime;
+    bool HasStarted;
 } NServerInfo;
 
 typedef struct _NClientId {
@@ -154,6 +156,7 @@ typedef struct _NActorMove {
     NVec2 Pos;
     bool has_MoveVel;
     NVec2 MoveVel;
+    uint32_t Seq;
 } NActorMove;
 
 typedef struct _NActorState {
@@ -419,7 +422,7 @@ extern "C" {
 #endif
 
 /* Initializer values for message structs */
-#define NServerInfo_init_default                 {0, 0, "", 0, "", 0, 0, 0}
+#define NServerInfo_init_default                 {0, 0, "", 0, "", 0, 0, 0, 0, 0}
 #define NClientId_init_default                   {0, 0}
 #define NCampaignDef_init_default                {"", 0, 0}
 #define NColor_init_default                      {0}
@@ -439,7 +442,7 @@ extern "C" {
 #define NVec2_init_default                       {0, 0}
 #define NGameBegin_init_default                  {0}
 #define NActorAdd_init_default                   {0, 0, 0, 0, 0, 0, 0, 0, false, NVec2_init_default, 0, {NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default, NAmmo_init_default}}
-#define NActorMove_init_default                  {0, false, NVec2_init_default, false, NVec2_init_default}
+#define NActorMove_init_default                  {0, false, NVec2_init_default, false, NVec2_init_default, 0}
 #define NActorState_init_default                 {0, 0}
 #define NActorDir_init_default                   {0, 0}
 #define NActorSlide_init_default                 {0, false, NVec2_init_default}
@@ -472,7 +475,7 @@ extern "C" {
 #define NDoorToggle_init_default                 {0, false, NVec2i_init_default}
 #define NMissionComplete_init_default            {0}
 #define NMissionEnd_init_default                 {0, 0, "", 0}
-#define NServerInfo_init_zero                    {0, 0, "", 0, "", 0, 0, 0}
+#define NServerInfo_init_zero                    {0, 0, "", 0, "", 0, 0, 0, 0, 0}
 #define NClientId_init_zero                      {0, 0}
 #define NCampaignDef_init_zero                   {"", 0, 0}
 #define NColor_init_zero                         {0}
@@ -492,7 +495,7 @@ extern "C" {
 #define NVec2_init_zero                          {0, 0}
 #define NGameBegin_init_zero                     {0}
 #define NActorAdd_init_zero                      {0, 0, 0, 0, 0, 0, 0, 0, false, NVec2_init_zero, 0, {NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero, NAmmo_init_zero}}
-#define NActorMove_init_zero                     {0, false, NVec2_init_zero, false, NVec2_init_zero}
+#define NActorMove_init_zero                     {0, false, NVec2_init_zero, false, NVec2_init_zero, 0}
 #define NActorState_init_zero                    {0, 0}
 #define NActorDir_init_zero                      {0, 0}
 #define NActorSlide_init_zero                    {0, false, NVec2_init_zero}
@@ -535,6 +538,8 @@ extern "C" {
 #define NServerInfo_MissionNumber_tag            6
 #define NServerInfo_NumPlayers_tag               7
 #define NServerInfo_MaxPlayers_tag               8
+#define NServerInfo_QueryTime_tag                9
+#define NServerInfo_HasStarted_tag               10
 #define NClientId_Id_tag                         1
 #define NClientId_FirstPlayerUID_tag             2
 #define NCampaignDef_Path_tag                    1
@@ -598,6 +603,7 @@ extern "C" {
 #define NActorMove_UID_tag                       1
 #define NActorMove_Pos_tag                       2
 #define NActorMove_MoveVel_tag                   3
+#define NActorMove_Seq_tag                       4
 #define NActorState_UID_tag                      1
 #define NActorState_State_tag                    2
 #define NActorDir_UID_tag                        1
@@ -735,7 +741,9 @@ X(a, STATIC,   SINGULAR, INT32,    GameMode,          4) \
 X(a, STATIC,   SINGULAR, STRING,   CampaignName,      5) \
 X(a, STATIC,   SINGULAR, INT32,    MissionNumber,     6) \
 X(a, STATIC,   SINGULAR, INT32,    NumPlayers,        7) \
-X(a, STATIC,   SINGULAR, INT32,    MaxPlayers,        8)
+X(a, STATIC,   SINGULAR, INT32,    MaxPlayers,        8) \
+X(a, STATIC,   SINGULAR, UINT32,   QueryTime,         9) \
+X(a, STATIC,   SINGULAR, BOOL,     HasStarted,       10)
 #define NServerInfo_CALLBACK NULL
 #define NServerInfo_DEFAULT NULL
 
@@ -927,7 +935,8 @@ X(a, STATIC,   REPEATED, MESSAGE,  Ammo,             10)
 #define NActorMove_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UINT32,   UID,               1) \
 X(a, STATIC,   OPTIONAL, MESSAGE,  Pos,               2) \
-X(a, STATIC,   OPTIONAL, MESSAGE,  MoveVel,           3)
+X(a, STATIC,   OPTIONAL, MESSAGE,  MoveVel,           3) \
+X(a, STATIC,   SINGULAR, UINT32,   Seq,               4)
 #define NActorMove_CALLBACK NULL
 #define NActorMove_DEFAULT NULL
 #define NActorMove_Pos_MSGTYPE NVec2
@@ -1294,7 +1303,7 @@ extern const pb_msgdesc_t NMissionEnd_msg;
 #define NActorHeal_size                          32
 #define NActorImpulse_size                       30
 #define NActorMelee_size                         164
-#define NActorMove_size                          30
+#define NActorMove_size                          36
 #define NActorPickupAll_size                     8
 #define NActorPilot_size                         19
 #define NActorReplaceGun_size                    142
@@ -1332,7 +1341,7 @@ extern const pb_msgdesc_t NMissionEnd_msg;
 #define NRemovePickup_size                       17
 #define NRescueCharacter_size                    6
 #define NScore_size                              17
-#define NServerInfo_size                         95
+#define NServerInfo_size                         103
 #define NSound_size                              148
 #define NThingDamage_size                        214
 #define NTileSet_size                            425
@@ -0,0 +1,634 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "replay.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cdogs/actors.h>
+#include <cdogs/campaigns.h>
+#include <cdogs/character_class.h>
+#include <cdogs/config.h>
+#include <cdogs/gamedata.h>
+#include <cdogs/log.h>
+#include <cdogs/mission.h>
+#include <cdogs/objs.h>
+#include <cdogs/utils.h>
+#include <cdogs/weapon_class.h>
+
+#define REPLAY_MAGIC "CDRP"
+#define VERSION 1
+
+Replay gReplay;
+
+// Config groups that affect the simulation
+static const char *configGroups[] = {
+	"Game", "Deathmatch", "Dogfight", "QuickPlay", NULL};
+
+void ReplayInit(Replay *r)
+{
+	memset(r, 0, sizeof *r);
+	CArrayInit(&r->Configs, sizeof(ReplayConfig));
+	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++)
+	{
+		CArrayInit(&r->Players[i].ammo, sizeof(int));
+	}
+	CArrayInit(&r->Runs, sizeof(ReplayRun));
+}
+static void ReplayPlayerTerminate(ReplayPlayer *rp);
+void ReplayTerminate(Replay *r)
+{
+	CFREE(r->Filename);
+	CFREE(r->CampaignPath);
+	CA_FOREACH(ReplayConfig, rc, r->Configs)
+	CFREE(rc->Name);
+	CA_FOREACH_END()
+	CArrayTerminate(&r->Configs);
+	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++)
+	{
+		ReplayPlayerTerminate(&r->Players[i]);
+	}
+	CArrayTerminate(&r->Runs);
+	memset(r, 0, sizeof *r);
+}
+static void ReplayPlayerTerminate(ReplayPlayer *rp)
+{
+	CFREE(rp->Class);
+	for (int i = 0; i < MAX_WEAPONS; i++)
+	{
+		CFREE(rp->Guns[i]);
+	}
+	CArrayTerminate(&rp->ammo);
+	memset(rp, 0, sizeof *rp);
+}
+
+// All values are stored little-endian
+static void WriteU8(FILE *f, const uint8_t v)
+{
+	fputc(v, f);
+}
+static void WriteU16(FILE *f, const uint16_t v)
+{
+	WriteU8(f, (uint8_t)(v & 0xff));
+	WriteU8(f, (uint8_t)(v >> 8));
+}
+static void WriteU32(FILE *f, const uint32_t v)
+{
+	WriteU16(f, (uint16_t)(v & 0xffff));
+	WriteU16(f, (uint16_t)(v >> 16));
+}
+static void WriteU64(FILE *f, const uint64_t v)
+{
+	WriteU32(f, (uint32_t)(v & 0xffffffff));
+	WriteU32(f, (uint32_t)(v >> 32));
+}
+static void WriteString(FILE *f, const char *s)
+{
+	const size_t len = s == NULL ? 0 : strlen(s);
+	WriteU16(f, (uint16_t)len);
+	if (len > 0)
+	{
+		fwrite(s, 1, len, f);
+	}
+}
+bool ReplaySave(const Replay *r, const char *filename)
+{
+	FILE *f = fopen(filename, "wb");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Error saving replay '%s'", filename);
+		return false;
+	}
+	fwrite(REPLAY_MAGIC, 1, strlen(REPLAY_MAGIC), f);
+	WriteU8(f, VERSION);
+
+	WriteU8(f, (uint8_t)r->CampaignMode);
+	WriteString(f, r->CampaignPath);
+	WriteU32(f, r->QuickPlaySeed);
+	WriteU32(f, (uint32_t)r->MissionIndex);
+	WriteU32(f, r->SpawnSeed);
+
+	WriteU16(f, (uint16_t)r->Configs.size);
+	CA_FOREACH(const ReplayConfig, rc, r->Configs)
+	WriteString(f, rc->Name);
+	WriteU32(f, (uint32_t)rc->Value);
+	CA_FOREACH_END()
+
+	WriteU8(f, (uint8_t)r->NumPlayers);
+	for (int i = 0; i < r->NumPlayers; i++)
+	{
+		const ReplayPlayer *rp = &r->Players[i];
+		WriteU8(f, rp->IsAI);
+		WriteString(f, rp->Class);
+		for (int j = 0; j < MAX_WEAPONS; j++)
+		{
+			WriteString(f, rp->Guns[j]);
+		}
+		WriteU16(f, (uint16_t)rp->ammo.size);
+		CA_FOREACH(const int, amount, rp->ammo)
+		WriteU32(f, (uint32_t)*amount);
+		CA_FOREACH_END()
+		WriteU32(f, (uint32_t)rp->Lives);
+		WriteU32(f, (uint32_t)rp->HP);
+	}
+
+	// Commands are run-length encoded; most ticks repeat the last command
+	WriteU32(f, (uint32_t)r->Ticks);
+	WriteU32(f, (uint32_t)r->Runs.size);
+	CA_FOREACH(const ReplayRun, run, r->Runs)
+	WriteU32(f, (uint32_t)run->Count);
+	for (int i = 0; i < r->NumPlayers; i++)
+	{
+		WriteU16(f, (uint16_t)run->Cmds[i]);
+	}
+	CA_FOREACH_END()
+
+	WriteU64(f, r->Hash);
+
+	const bool ok = !ferror(f);
+	fclose(f);
+	if (!ok)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Error writing replay '%s'", filename);
+	}
+	return ok;
+}
+
+typedef struct
+{
+	FILE *f;
+	bool err;
+} Reader;
+static uint8_t ReadU8(Reader *r)
+{
+	const int c = fgetc(r->f);
+	if (c == EOF)
+	{
+		r->err = true;
+		return 0;
+	}
+	return (uint8_t)c;
+}
+static uint16_t ReadU16(Reader *r)
+{
+	const uint16_t lo = ReadU8(r);
+	return (uint16_t)(lo | (ReadU8(r) << 8));
+}
+static uint32_t ReadU32(Reader *r)
+{
+	const uint32_t lo = ReadU16(r);
+	return lo | ((uint32_t)ReadU16(r) << 16);
+}
+static uint64_t ReadU64(Reader *r)
+{
+	const uint64_t lo = ReadU32(r);
+	return lo | ((uint64_t)ReadU32(r) << 32);
+}
+static char *ReadString(Reader *r)
+{
+	const uint16_t len = ReadU16(r);
+	if (len == 0 || r->err)
+	{
+		return NULL;
+	}
+	char *s;
+	CMALLOC(s, len + 1);
+	if (fread(s, 1, len, r->f) != len)
+	{
+		r->err = true;
+	}
+	s[len] = '\0';
+	return s;
+}
+bool ReplayLoad(Replay *r, const char *filename)
+{
+	// Replace the recorded contents but keep the mode and filename
+	const ReplayMode mode = r->Mode;
+	char *rFilename = r->Filename;
+	r->Filename = NULL;
+	ReplayTerminate(r);
+	ReplayInit(r);
+	r->Mode = mode;
+	r->Filename = rFilename;
+	Reader rd = {fopen(filename, "rb"), false};
+	if (rd.f == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Error loading replay '%s'", filename);
+		return false;
+	}
+	char magic[sizeof REPLAY_MAGIC];
+	memset(magic, 0, sizeof magic);
+	if (fread(magic, 1, strlen(REPLAY_MAGIC), rd.f) != strlen(REPLAY_MAGIC) ||
+		strcmp(magic, REPLAY_MAGIC) != 0)
+	{
+		LOG(LM_MAIN, LL_ERROR, "'%s' is not a replay file", filename);
+		rd.err = true;
+		goto bail;
+	}
+	const int version = ReadU8(&rd);
+	if (version != VERSION)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Unsupported replay version %d", version);
+		rd.err = true;
+		goto bail;
+	}
+
+	r->CampaignMode = (GameMode)ReadU8(&rd);
+	r->CampaignPath = ReadString(&rd);
+	r->QuickPlaySeed = ReadU32(&rd);
+	r->MissionIndex = (int)ReadU32(&rd);
+	r->SpawnSeed = ReadU32(&rd);
+
+	const int numConfigs = ReadU16(&rd);
+	for (int i = 0; i < numConfigs && !rd.err; i++)
+	{
+		ReplayConfig rc;
+		rc.Name = ReadString(&rd);
+		rc.Value = (int)ReadU32(&rd);
+		CArrayPushBack(&r->Configs, &rc);
+	}
+
+	r->NumPlayers = ReadU8(&rd);
+	if (r->NumPlayers > MAX_LOCAL_PLAYERS)
+	{
+		rd.err = true;
+		goto bail;
+	}
+	for (int i = 0; i < r->NumPlayers && !rd.err; i++)
+	{
+		ReplayPlayer *rp = &r->Players[i];
+		rp->IsAI = ReadU8(&rd);
+		rp->Class = ReadString(&rd);
+		for (int j = 0; j < MAX_WEAPONS; j++)
+		{
+			rp->Guns[j] = ReadString(&rd);
+		}
+		const int numAmmo = ReadU16(&rd);
+		for (int j = 0; j < numAmmo && !rd.err; j++)
+		{
+			const int amount = (int)ReadU32(&rd);
+			CArrayPushBack(&rp->ammo, &amount);
+		}
+		rp->Lives = (int)ReadU32(&rd);
+		rp->HP = (int)ReadU32(&rd);
+	}
+
+	r->Ticks = (int)ReadU32(&rd);
+	const int numRuns = (int)ReadU32(&rd);
+	for (int i = 0; i < numRuns && !rd.err; i++)
+	{
+		ReplayRun run;
+		memset(&run, 0, sizeof run);
+		run.Count = (int)ReadU32(&rd);
+		for (int j = 0; j < r->NumPlayers; j++)
+		{
+			run.Cmds[j] = ReadU16(&rd);
+		}
+		CArrayPushBack(&r->Runs, &run);
+	}
+
+	r->Hash = ReadU64(&rd);
+
+bail:
+	fclose(rd.f);
+	if (rd.err)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Error reading replay '%s'", filename);
+		return false;
+	}
+	LOG(LM_MAIN, LL_INFO, "Loaded replay '%s': %d ticks, %d runs", filename,
+		r->Ticks, (int)r->Runs.size);
+	return true;
+}
+
+static void RecordConfigs(CArray *configs);
+static void RecordPlayers(Replay *r);
+void ReplayRecordStart(Replay *r)
+{
+	CFREE(r->CampaignPath);
+	r->CampaignPath = NULL;
+	r->CampaignMode = gCampaign.Entry.Mode;
+	if (gCampaign.Entry.Mode != GAME_MODE_QUICK_PLAY)
+	{
+		CSTRDUP(r->CampaignPath, gCampaign.Entry.Path);
+	}
+	r->QuickPlaySeed = gCampaign.QuickPlaySeed;
+	r->MissionIndex = gCampaign.MissionIndex;
+	RecordConfigs(&r->Configs);
+	RecordPlayers(r);
+	CArrayClear(&r->Runs);
+	r->Ticks = 0;
+	r->Hash = 0;
+	LOG(LM_MAIN, LL_INFO, "Recording replay mission(%d) to '%s'",
+		r->MissionIndex, r->Filename);
+}
+static void RecordConfigs(CArray *configs)
+{
+	CA_FOREACH(ReplayConfig, rc, *configs)
+	CFREE(rc->Name);
+	CA_FOREACH_END()
+	CArrayClear(configs);
+	for (int i = 0; configGroups[i] != NULL; i++)
+	{
+		CA_FOREACH(const Config, c, *ConfigGetGroup(&gConfig, configGroups[i]))
+		ReplayConfig rc;
+		switch (c->Type)
+		{
+		case CONFIG_TYPE_INT:
+			rc.Value = c->u.Int.Value;
+			break;
+		case CONFIG_TYPE_ENUM:
+			rc.Value = c->u.Enum.Value;
+			break;
+		case CONFIG_TYPE_BOOL:
+			rc.Value = c->u.Bool.Value;
+			break;
+		default:
+			continue;
+		}
+		char buf[256];
+		sprintf(buf, "%s.%s", configGroups[i], c->Name);
+		CSTRDUP(rc.Name, buf);
+		CArrayPushBack(configs, &rc);
+		CA_FOREACH_END()
+	}
+}
+static void RecordPlayers(Replay *r)
+{
+	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++)
+	{
+		ReplayPlayerTerminate(&r->Players[i]);
+		CArrayInit(&r->Players[i].ammo, sizeof(int));
+	}
+	r->NumPlayers = 0;
+	CA_FOREACH(const PlayerData, p, gPlayerDatas)
+	if (!p->IsLocal || r->NumPlayers == MAX_LOCAL_PLAYERS)
+	{
+		continue;
+	}
+	ReplayPlayer *rp = &r->Players[r->NumPlayers];
+	rp->IsAI = p->inputDevice == INPUT_DEVICE_AI;
+	if (p->Char.Class != NULL)
+	{
+		CSTRDUP(rp->Class, p->Char.Class->Name);
+	}
+	for (int j = 0; j < MAX_WEAPONS; j++)
+	{
+		if (p->guns[j] != NULL)
+		{
+			CSTRDUP(rp->Guns[j], p->guns[j]->name);
+		}
+	}
+	CArrayCopy(&rp->ammo, &p->ammo);
+	rp->Lives = p->Lives;
+	rp->HP = p->HP;
+	r->NumPlayers++;
+	CA_FOREACH_END()
+}
+
+bool ReplayTick(Replay *r, int cmds[MAX_LOCAL_PLAYERS])
+{
+	switch (r->Mode)
+	{
+	case REPLAY_MODE_RECORD: {
+		ReplayRun *last = r->Runs.size > 0
+							  ? CArrayGet(&r->Runs, r->Runs.size - 1)
+							  : NULL;
+		if (last != NULL &&
+			memcmp(last->Cmds, cmds, sizeof last->Cmds) == 0)
+		{
+			last->Count++;
+		}
+		else
+		{
+			ReplayRun run;
+			run.Count = 1;
+			memcpy(run.Cmds, cmds, sizeof run.Cmds);
+			CArrayPushBack(&r->Runs, &run);
+		}
+		r->Ticks++;
+		return true;
+	}
+	case REPLAY_MODE_PLAY: {
+		if (r->runIndex >= (int)r->Runs.size)
+		{
+			return false;
+		}
+		const ReplayRun *run = CArrayGet(&r->Runs, r->runIndex);
+		memcpy(cmds, run->Cmds, sizeof run->Cmds);
+		r->runTick++;
+		if (r->runTick >= run->Count)
+		{
+			r->runIndex++;
+			r->runTick = 0;
+		}
+		return true;
+	}
+	default:
+		return true;
+	}
+}
+
+unsigned int ReplaySpawnSeed(Replay *r, const unsigned int seed)
+{
+	switch (r->Mode)
+	{
+	case REPLAY_MODE_RECORD:
+		r->SpawnSeed = seed;
+		return seed;
+	case REPLAY_MODE_PLAY:
+		return r->SpawnSeed;
+	default:
+		return seed;
+	}
+}
+
+void ReplayEnd(Replay *r)
+{
+	if (r->Mode == REPLAY_MODE_NONE)
+	{
+		return;
+	}
+	const uint64_t hash = ReplayStateHash();
+	switch (r->Mode)
+	{
+	case REPLAY_MODE_RECORD:
+		r->Hash = hash;
+		if (ReplaySave(r, r->Filename))
+		{
+			printf(
+				"Recorded replay '%s': %d ticks, hash %016" PRIx64 "\n",
+				r->Filename, r->Ticks, hash);
+		}
+		// Only record a single mission
+		r->Mode = REPLAY_MODE_NONE;
+		break;
+	case REPLAY_MODE_PLAY:
+		r->Desynced = hash != r->Hash;
+		if (!r->Desynced)
+		{
+			printf("Replay OK: hash %016" PRIx64 "\n", hash);
+		}
+		else
+		{
+			printf(
+				"Replay desync: expected hash %016" PRIx64 ", got %016" PRIx64
+				"\n",
+				r->Hash, hash);
+		}
+		r->Mode = REPLAY_MODE_NONE;
+		break;
+	default:
+		break;
+	}
+}
+
+static const ReplayConfig *FindConfig(const Replay *r, const char *name);
+void ReplayApplySetup(const Replay *r)
+{
+	gCampaign.Entry.Mode = r->CampaignMode;
+	gCampaign.QuickPlaySeed = r->QuickPlaySeed;
+	for (int i = 0; configGroups[i] != NULL; i++)
+	{
+		CA_FOREACH(Config, c, *ConfigGetGroup(&gConfig, configGroups[i]))
+		char buf[256];
+		sprintf(buf, "%s.%s", configGroups[i], c->Name);
+		const ReplayConfig *found = FindConfig(r, buf);
+		if (found == NULL)
+		{
+			continue;
+		}
+		switch (c->Type)
+		{
+		case CONFIG_TYPE_INT:
+			c->u.Int.Value = found->Value;
+			break;
+		case CONFIG_TYPE_ENUM:
+			c->u.Enum.Value = found->Value;
+			break;
+		case CONFIG_TYPE_BOOL:
+			c->u.Bool.Value = !!found->Value;
+			break;
+		default:
+			break;
+		}
+		CA_FOREACH_END()
+	}
+}
+static const ReplayConfig *FindConfig(const Replay *r, const char *name)
+{
+	CA_FOREACH(const ReplayConfig, rc, r->Configs)
+	if (rc->Name != NULL && strcmp(rc->Name, name) == 0)
+	{
+		return rc;
+	}
+	CA_FOREACH_END()
+	return NULL;
+}
+
+void ReplayApplyPlayers(const Replay *r)
+{
+	int idx = 0;
+	CA_FOREACH(PlayerData, p, gPlayerDatas)
+	if (!p->IsLocal)
+	{
+		continue;
+	}
+	if (idx >= r->NumPlayers)
+	{
+		break;
+	}
+	const ReplayPlayer *rp = &r->Players[idx];
+	// AI players are re-simulated; everyone else only follows the recorded
+	// commands
+	PlayerTrySetInputDevice(
+		p, rp->IsAI ? INPUT_DEVICE_AI : INPUT_DEVICE_REPLAY, 0);
+	if (rp->Class != NULL)
+	{
+		p->Char.Class = StrCharacterClass(rp->Class);
+	}
+	for (int j = 0; j < MAX_WEAPONS; j++)
+	{
+		p->guns[j] = rp->Guns[j] != NULL ? StrWeaponClass(rp->Guns[j]) : NULL;
+	}
+	CArrayCopy(&p->ammo, &rp->ammo);
+	PlayerSetLives(p, rp->Lives);
+	p->HP = rp->HP;
+	idx++;
+	CA_FOREACH_END()
+}
+
+#define HASH(_h, _v) (_h) = Hash64((_h), &(_v), sizeof(_v))
+static uint64_t HashThing(uint64_t h, const Thing *t)
+{
+	HASH(h, t->Pos.x);
+	HASH(h, t->Pos.y);
+	HASH(h, t->Vel.x);
+	HASH(h, t->Vel.y);
+	return h;
+}
+uint64_t ReplayStateHash(void)
+{
+	uint64_t h = HASH64_INIT;
+	HASH(h, gMission.time);
+	CA_FOREACH(const TActor, a, gActors)
+	if (!a->isInUse)
+	{
+		continue;
+	}
+	HASH(h, a->uid);
+	HASH(h, a->health);
+	HASH(h, a->dead);
+	h = HashThing(h, &a->thing);
+	CA_FOREACH_END()
+	CA_FOREACH(const TObject, o, gObjs)
+	if (!o->isInUse)
+	{
+		continue;
+	}
+	HASH(h, o->uid);
+	HASH(h, o->Health);
+	h = HashThing(h, &o->thing);
+	CA_FOREACH_END()
+	CA_FOREACH(const TMobileObject, m, gMobObjs)
+	if (!m->isInUse)
+	{
+		continue;
+	}
+	HASH(h, m->UID);
+	h = HashThing(h, &m->thing);
+	CA_FOREACH_END()
+	CA_FOREACH(const PlayerData, p, gPlayerDatas)
+	HASH(h, p->UID);
+	HASH(h, p->Lives);
+	HASH(h, p->Stats.Score);
+	HASH(h, p->Stats.Kills);
+	CA_FOREACH_END()
+	return h;
+}
@@ -0,0 +1,125 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <cdogs/c_array.h>
+#include <cdogs/game_mode.h>
+#include <cdogs/player.h>
+
+// Deterministic input recording and playback
+// Replays store everything needed to rebuild a mission (campaign, mission,
+// seeds, gameplay config and player loadouts) plus the commands of each
+// local player for every simulated tick. Playback feeds the commands back
+// into the game loop in place of input devices.
+
+typedef enum
+{
+	REPLAY_MODE_NONE,
+	REPLAY_MODE_RECORD,
+	REPLAY_MODE_PLAY
+} ReplayMode;
+
+typedef struct
+{
+	char *Name;
+	int Value;
+} ReplayConfig;
+
+typedef struct
+{
+	bool IsAI;
+	char *Class;
+	char *Guns[MAX_WEAPONS];
+	CArray ammo; // of int
+	int Lives;
+	int HP;
+} ReplayPlayer;
+
+// Commands that repeat for a number of consecutive ticks
+typedef struct
+{
+	int Count;
+	int Cmds[MAX_LOCAL_PLAYERS];
+} ReplayRun;
+
+typedef struct
+{
+	ReplayMode Mode;
+	char *Filename;
+
+	GameMode CampaignMode;
+	char *CampaignPath; // NULL for quick play
+	unsigned int QuickPlaySeed;
+	int MissionIndex;
+	// Seed used for PVP spawn positions
+	unsigned int SpawnSeed;
+	CArray Configs; // of ReplayConfig
+	int NumPlayers;
+	ReplayPlayer Players[MAX_LOCAL_PLAYERS];
+	CArray Runs; // of ReplayRun
+	int Ticks;
+	// Hash of the game state when the replay ended
+	uint64_t Hash;
+	// Set if playback ended with a different state hash
+	bool Desynced;
+
+	// Playback position
+	int runIndex;
+	int runTick;
+} Replay;
+
+extern Replay gReplay;
+
+void ReplayInit(Replay *r);
+void ReplayTerminate(Replay *r);
+bool ReplayLoad(Replay *r, const char *filename);
+bool ReplaySave(const Replay *r, const char *filename);
+
+// Capture the current campaign, mission, config and local players
+void ReplayRecordStart(Replay *r);
+// Call once per simulated tick with the local player commands.
+// When recording, the commands are appended; when playing, they are
+// replaced by the recorded ones.
+// Returns false if playback has run out of recorded ticks.
+bool ReplayTick(Replay *r, int cmds[MAX_LOCAL_PLAYERS]);
+// When recording, remember the seed; when playing, return the recorded one
+unsigned int ReplaySpawnSeed(Replay *r, const unsigned int seed);
+// Hash the game state and either save the recording or compare against the
+// recorded hash, setting Desynced on mismatch
+void ReplayEnd(Replay *r);
+
+// Apply recorded config and campaign mission before loading the campaign
+void ReplayApplySetup(const Replay *r);
+// Apply recorded loadouts and input devices to the local players
+void ReplayApplyPlayers(const Replay *r);
+
+// Hash of actor, object and player state, for detecting desyncs
+uint64_t ReplayStateHash(void);
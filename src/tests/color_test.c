@@ -57,6 +57,36 @@ FEATURE(ColorMult, "Multiply")
 			SHOULD_INT_EQUAL(result.g, black.g);
 			SHOULD_INT_EQUAL(result.b, black.b);
 	SCENARIO_END
+
+	SCENARIO("Multiply many pixels")
+		GIVEN("pixels and masks")
+			// Not a multiple of the SIMD width, to cover the remainder
+			color_t src[11], masks[11];
+			for (int i = 0; i < 11; i++)
+			{
+				src[i].r = (uint8_t)(i * 23);
+				src[i].g = (uint8_t)(255 - i * 7);
+				src[i].b = (uint8_t)(i * 91);
+				src[i].a = (uint8_t)(i * 255 / 10);
+				masks[i].r = (uint8_t)(255 - i * 19);
+				masks[i].g = (uint8_t)(i * 25);
+				masks[i].b = 255;
+				masks[i].a = (uint8_t)(i * 13);
+			}
+
+		WHEN("I multiply them together")
+			color_t result[11];
+			ColorMultPixels(
+				(uint32_t *)result, (const uint32_t *)src,
+				(const uint32_t *)masks, 11);
+
+		THEN("the result should be the same as multiplying each color")
+			for (int i = 0; i < 11; i++)
+			{
+				const color_t expected = ColorMult(src[i], masks[i]);
+				SHOULD_MEM_EQUAL(&result[i], &expected, sizeof expected);
+			}
+	SCENARIO_END
 FEATURE_END
 
 FEATURE(ColorAlphaBlend, "Alpha blend")
@@ -0,0 +1,58 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <draw/draw_buffer.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+#define NUM_CMDS 1000
+
+FEATURE(DrawBufferSortCmds, "Sort draw commands")
+	SCENARIO("Sort commands by layer, row and y")
+		GIVEN("a draw buffer")
+			DrawBuffer b;
+			DrawBufferInit(&b, svec2i(4, 4), NULL);
+		AND("commands added in scrambled order")
+			for (int i = 0; i < NUM_CMDS; i++)
+			{
+				const DrawLayer layer = (DrawLayer)((i * 3) % DRAW_LAYER_COUNT);
+				const int row = (i * 13) % 100;
+				const uint32_t sub = (uint32_t)((i * 31) % 5);
+				// Record the insertion order in the pos
+				DrawBufferAddCmd(&b, layer, row, sub, NULL, NULL, svec2i(i, 0));
+			}
+
+		WHEN("I sort the commands")
+			DrawBufferSortCmds(&b);
+
+		THEN("they should be in key order")
+			bool sorted = true;
+			bool stable = true;
+			for (int i = 1; i < (int)b.drawCmds.size; i++)
+			{
+				const DrawCmd *prev = CArrayGet(&b.drawCmds, i - 1);
+				const DrawCmd *c = CArrayGet(&b.drawCmds, i);
+				sorted = sorted && prev->Key <= c->Key;
+				stable = stable && (prev->Key != c->Key || prev->Pos.x < c->Pos.x);
+			}
+			SHOULD_INT_EQUAL((int)b.drawCmds.size, NUM_CMDS);
+			SHOULD_BE_TRUE(sorted);
+		AND("equal keys should keep the order they were added in")
+			SHOULD_BE_TRUE(stable);
+		AND("layers should come first")
+			const DrawCmd *first = CArrayGet(&b.drawCmds, 0);
+			const DrawCmd *last = CArrayGet(&b.drawCmds, NUM_CMDS - 1);
+			SHOULD_INT_EQUAL(DRAW_CMD_LAYER(first->Key), DRAW_LAYER_FLOOR);
+			SHOULD_INT_EQUAL(
+				DRAW_CMD_LAYER(last->Key), DRAW_LAYER_PICKUP_MENUS);
+
+		DrawBufferTerminate(&b);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Draw buffer features are:", TEST_FEATURE(DrawBufferSortCmds))
@@ -0,0 +1,164 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <net_shim.h>
+#include <net_util.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+#define NUM_MSGS 50
+#define WAIT_MS 10000
+
+static ENetAddress LoopbackAddr(const enet_uint16 port)
+{
+	ENetAddress addr;
+	enet_address_set_host_ip(&addr, "127.0.0.1");
+	addr.port = port;
+	return addr;
+}
+
+// Service both hosts and the shim until the client connects, or time out
+static ENetPeer *Connect(ENetHost *server, ENetHost *client, NetShim *shim)
+{
+	ENetPeer *peer =
+		enet_host_connect(client, &shim->Address, NET_CHANNEL_COUNT, 0);
+	const enet_uint32 start = enet_time_get();
+	bool connected = false;
+	while (!connected && enet_time_get() - start < WAIT_MS)
+	{
+		ENetEvent event;
+		NetShimUpdate(shim);
+		while (enet_host_service(server, &event, 0) > 0)
+		{
+		}
+		while (enet_host_service(client, &event, 1) > 0)
+		{
+			connected = connected || event.type == ENET_EVENT_TYPE_CONNECT;
+		}
+	}
+	return connected ? peer : NULL;
+}
+
+static int SendDatagrams(NetShim *shim, const int count)
+{
+	const ENetSocket socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+	uint8_t data[32];
+	memset(data, 0, sizeof data);
+	ENetBuffer buf;
+	buf.data = data;
+	buf.dataLength = sizeof data;
+	for (int i = 0; i < count; i++)
+	{
+		enet_socket_send(socket, &shim->Address, &buf, 1);
+	}
+	enet_socket_destroy(socket);
+	// Give the datagrams time to arrive
+	const enet_uint32 start = enet_time_get();
+	while (enet_time_get() - start < 100)
+	{
+		NetShimUpdate(shim);
+	}
+	return (int)shim->Dropped;
+}
+
+FEATURE(net_shim, "Simulated link")
+	SCENARIO("Reliable messages over a lossy link")
+		GIVEN("a client connected to a server through a lossy shim")
+			enet_initialize();
+			const ENetAddress serverAddr = LoopbackAddr(0);
+			ENetHost *server =
+				enet_host_create(&serverAddr, 1, NET_CHANNEL_COUNT, 0, 0);
+			ENetHost *client =
+				enet_host_create(NULL, 1, NET_CHANNEL_COUNT, 0, 0);
+			NetShimOptions o;
+			SHOULD_BE_TRUE(NetShimOptionsParse(&o, "20,10,0.2,42"));
+			NetShim shim;
+			NetShimInit(&shim);
+			SHOULD_BE_TRUE(NetShimOpen(
+				&shim, &o, LoopbackAddr(server->address.port)));
+			ENetPeer *peer = Connect(server, client, &shim);
+			SHOULD_BE_TRUE(peer != NULL);
+		WHEN("the client sends reliable messages")
+			NetStats sent, received;
+			NetStatsInit(&sent);
+			NetStatsInit(&received);
+			NMissionComplete mc = NMissionComplete_init_default;
+			for (int i = 0; peer != NULL && i < NUM_MSGS; i++)
+			{
+				mc.ShowMsg = i % 2;
+				NetSendPacket(
+					peer, &sent, NET_CHANNEL_RELIABLE,
+					NetEncode(GAME_EVENT_MISSION_COMPLETE, &mc));
+			}
+			int inOrder = 0;
+			const enet_uint32 start = enet_time_get();
+			while (received.In[GAME_EVENT_MISSION_COMPLETE].Count < NUM_MSGS &&
+				   enet_time_get() - start < WAIT_MS)
+			{
+				ENetEvent event;
+				NetShimUpdate(&shim);
+				while (enet_host_service(client, &event, 0) > 0)
+				{
+				}
+				while (enet_host_service(server, &event, 1) > 0)
+				{
+					if (event.type != ENET_EVENT_TYPE_RECEIVE)
+					{
+						continue;
+					}
+					NMissionComplete r;
+					NetDecode(event.packet, &r, NMissionComplete_fields);
+					const int expected =
+						(int)received.In[GAME_EVENT_MISSION_COMPLETE].Count % 2;
+					if ((int)r.ShowMsg == expected)
+					{
+						inOrder++;
+					}
+					NetStatsCount(&received, false, event.packet);
+					enet_packet_destroy(event.packet);
+				}
+			}
+		THEN("they should all arrive in order, with the same byte counts")
+			SHOULD_BE_TRUE(shim.Dropped > 0);
+			SHOULD_INT_EQUAL(
+				(int)received.In[GAME_EVENT_MISSION_COMPLETE].Count, NUM_MSGS);
+			SHOULD_INT_EQUAL(inOrder, NUM_MSGS);
+			const NetStatsCounter out = NetStatsTotal(sent.Out);
+			const NetStatsCounter in = NetStatsTotal(received.In);
+			SHOULD_INT_EQUAL((int)out.Count, NUM_MSGS);
+			SHOULD_INT_EQUAL((int)in.Bytes, (int)out.Bytes);
+			// Each message is just its type and a small pb
+			SHOULD_BE_TRUE(out.Bytes <= NUM_MSGS * 8);
+		enet_host_destroy(client);
+		enet_host_destroy(server);
+		NetShimTerminate(&shim);
+		NetPacketPoolTerminate();
+	SCENARIO_END
+	SCENARIO("Repeatable drops")
+		GIVEN("two shims with the same options")
+			NetShimOptions o;
+			NetShimOptionsParse(&o, "0,0,0.5,7");
+			NetShim s1, s2;
+			NetShimInit(&s1);
+			NetShimInit(&s2);
+			NetShimOpen(&s1, &o, LoopbackAddr(1));
+			NetShimOpen(&s2, &o, LoopbackAddr(1));
+		WHEN("I send them the same datagrams")
+			const int dropped1 = SendDatagrams(&s1, 100);
+			const int dropped2 = SendDatagrams(&s2, 100);
+		THEN("they should drop the same number, about half")
+			SHOULD_INT_EQUAL(dropped1, dropped2);
+			SHOULD_INT_GT(dropped1, 25);
+			SHOULD_INT_LT(dropped1, 75);
+		NetShimTerminate(&s1);
+		NetShimTerminate(&s2);
+		enet_deinitialize();
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Net shim features are:", TEST_FEATURE(net_shim))
@@ -0,0 +1,158 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <net_snapshot.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+static void AddActor(
+	NetSnapshot *s, const int uid, const float x, const float vx,
+	const int health)
+{
+	NetSnapshotEntity e = NetSnapshotEntityNew(
+		SNAPSHOT_ACTOR, uid, svec2(x, 10), svec2(vx, 0));
+	e.Dir = 2;
+	e.State = 1;
+	e.Health = health;
+	NetSnapshotAdd(s, &e);
+}
+static const NetSnapshotEntity *GetEntity(const NetSnapshot *s, const int i)
+{
+	return CArrayGet(&s->Entities, i);
+}
+static bool EntitiesEqual(const NetSnapshot *s1, const NetSnapshot *s2)
+{
+	if (s1->Entities.size != s2->Entities.size)
+	{
+		return false;
+	}
+	for (int i = 0; i < (int)s1->Entities.size; i++)
+	{
+		NetSnapshotEntity e1 = *GetEntity(s1, i);
+		NetSnapshotEntity e2 = *GetEntity(s2, i);
+		e1.Changed = e2.Changed = 0;
+		if (memcmp(&e1, &e2, sizeof e1) != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+FEATURE(net_snapshot, "World snapshots")
+	SCENARIO("Full snapshot")
+		GIVEN("a snapshot with some entities")
+			NetSnapshot s;
+			NetSnapshotInit(&s);
+			s.Seq = 1;
+			s.Tick = 2;
+			s.InputSeq = 7;
+			s.InputTicks = 3;
+			AddActor(&s, 0, 100.5f, 1.25f, 100);
+			AddActor(&s, 5, 20, -0.5f, 30);
+			NetSnapshotEntity e = NetSnapshotEntityNew(
+				SNAPSHOT_PICKUP, 3, svec2(64, 64), svec2_zero());
+			NetSnapshotAdd(&s, &e);
+
+		WHEN("I send it without a baseline")
+			CArray buf;
+			CArrayInit(&buf, sizeof(uint8_t));
+			NetSnapshotWriteDelta(&buf, NULL, &s);
+			NetSnapshotHistory h;
+			NetSnapshotHistoryInit(&h);
+			const NetSnapshot *r = NetSnapshotHistoryRead(&h, buf.data, buf.size);
+
+		THEN("it should be received the same")
+			SHOULD_BE_TRUE(r != NULL);
+			SHOULD_INT_EQUAL((int)r->Seq, 1);
+			SHOULD_INT_EQUAL((int)r->Tick, 2);
+			SHOULD_INT_EQUAL((int)r->InputSeq, 7);
+			SHOULD_INT_EQUAL((int)r->InputTicks, 3);
+			SHOULD_BE_TRUE(EntitiesEqual(r, &s));
+		AND("every entity should be marked as changed")
+			SHOULD_BE_TRUE(GetEntity(r, 0)->Changed != 0);
+			SHOULD_BE_TRUE(GetEntity(r, 1)->Changed != 0);
+		NetSnapshotHistoryTerminate(&h);
+		CArrayTerminate(&buf);
+		NetSnapshotTerminate(&s);
+	SCENARIO_END
+
+	SCENARIO("Delta against a baseline")
+		GIVEN("a received baseline")
+			NetSnapshot base;
+			NetSnapshotInit(&base);
+			base.Seq = 1;
+			base.Tick = 0;
+			AddActor(&base, 1, 100, 1, 100);
+			AddActor(&base, 2, 200, 0, 100);
+			AddActor(&base, 3, 300, 0, 100);
+			CArray buf;
+			CArrayInit(&buf, sizeof(uint8_t));
+			NetSnapshotWriteDelta(&buf, NULL, &base);
+			NetSnapshotHistory h;
+			NetSnapshotHistoryInit(&h);
+			NetSnapshotHistoryRead(&h, buf.data, buf.size);
+			const size_t fullSize = buf.size;
+		AND("a snapshot where one actor kept moving, one was hurt and one "
+			"was removed")
+			NetSnapshot s;
+			NetSnapshotInit(&s);
+			s.Seq = 2;
+			s.Tick = 4;
+			AddActor(&s, 1, 104, 1, 100);
+			AddActor(&s, 2, 200, 0, 75);
+
+		WHEN("I send it as a delta")
+			NetSnapshotWriteDelta(&buf, &base, &s);
+			const NetSnapshot *r = NetSnapshotHistoryRead(&h, buf.data, buf.size);
+
+		THEN("it should be received the same")
+			SHOULD_BE_TRUE(r != NULL);
+			SHOULD_BE_TRUE(EntitiesEqual(r, &s));
+		AND("only the changes should be sent")
+			SHOULD_BE_TRUE(buf.size < fullSize);
+			SHOULD_INT_EQUAL((int)GetEntity(r, 0)->Changed, 0);
+			SHOULD_INT_EQUAL(
+				(int)GetEntity(r, 1)->Changed, SNAPSHOT_FIELD_HEALTH);
+		NetSnapshotHistoryTerminate(&h);
+		CArrayTerminate(&buf);
+		NetSnapshotTerminate(&s);
+		NetSnapshotTerminate(&base);
+	SCENARIO_END
+
+	SCENARIO("Missing baseline")
+		GIVEN("a delta against a baseline that wasn't received")
+			NetSnapshot base;
+			NetSnapshotInit(&base);
+			base.Seq = 1;
+			AddActor(&base, 1, 100, 0, 100);
+			NetSnapshot s;
+			NetSnapshotInit(&s);
+			s.Seq = 2;
+			AddActor(&s, 1, 100, 0, 50);
+			CArray buf;
+			CArrayInit(&buf, sizeof(uint8_t));
+			NetSnapshotWriteDelta(&buf, &base, &s);
+
+		WHEN("I receive it")
+			NetSnapshotHistory h;
+			NetSnapshotHistoryInit(&h);
+			const NetSnapshot *r = NetSnapshotHistoryRead(&h, buf.data, buf.size);
+
+		THEN("it should be dropped")
+			SHOULD_BE_TRUE(r == NULL);
+			SHOULD_BE_TRUE(NetSnapshotHistoryGet(&h, 2) == NULL);
+		NetSnapshotHistoryTerminate(&h);
+		CArrayTerminate(&buf);
+		NetSnapshotTerminate(&s);
+		NetSnapshotTerminate(&base);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Net snapshot features are:", TEST_FEATURE(net_snapshot))
@@ -0,0 +1,271 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <net_util.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+typedef struct
+{
+	int Count;
+	GameEventType Types[8];
+	NActorMove Moves[8];
+} Unpacked;
+static void OnMsg(ENetPacket *packet, void *data)
+{
+	Unpacked *u = data;
+	const GameEventType e = (GameEventType) * (uint32_t *)packet->data;
+	u->Types[u->Count] = e;
+	if (e == GAME_EVENT_ACTOR_MOVE)
+	{
+		NetDecode(packet, &u->Moves[u->Count], NActorMove_fields);
+	}
+	u->Count++;
+}
+
+
+// Count messages, keeping only the latest
+static void OnMsgCount(ENetPacket *packet, void *data)
+{
+	Unpacked *u = data;
+	const GameEventType e = (GameEventType) * (uint32_t *)packet->data;
+	u->Types[0] = e;
+	if (e == GAME_EVENT_ACTOR_MOVE)
+	{
+		NetDecode(packet, &u->Moves[0], NActorMove_fields);
+	}
+	u->Count++;
+}
+
+FEATURE(net_batch, "Batched packets")
+	SCENARIO("Unpack batched messages")
+		GIVEN("a batch with some messages")
+			NetBatch b;
+			NetBatchInit(&b, NET_CHANNEL_RELIABLE);
+			NActorMove m1 = NActorMove_init_default;
+			m1.UID = 3;
+			m1.has_Pos = true;
+			m1.Pos.x = 12.5f;
+			NActorMove m2 = NActorMove_init_default;
+			m2.UID = 7;
+			NetBatchAdd(&b, NULL, GAME_EVENT_ACTOR_MOVE, &m1);
+			NetBatchAdd(&b, NULL, GAME_EVENT_NET_GAME_START, NULL);
+			NetBatchAdd(&b, NULL, GAME_EVENT_ACTOR_MOVE, &m2);
+
+		WHEN("I unpack it")
+			ENetPacket packet;
+			memset(&packet, 0, sizeof packet);
+			packet.data = b.Data;
+			packet.dataLength = b.Size;
+			Unpacked u;
+			memset(&u, 0, sizeof u);
+			const bool isBatch = NetBatchUnpack(&packet, OnMsg, &u);
+
+		THEN("the messages should be the same and in order")
+			SHOULD_BE_TRUE(isBatch);
+			SHOULD_INT_EQUAL(u.Count, 3);
+			SHOULD_INT_EQUAL((int)u.Types[0], (int)GAME_EVENT_ACTOR_MOVE);
+			SHOULD_INT_EQUAL((int)u.Moves[0].UID, 3);
+			SHOULD_BE_TRUE(u.Moves[0].has_Pos);
+			SHOULD_BE_TRUE(u.Moves[0].Pos.x == 12.5f);
+			SHOULD_INT_EQUAL((int)u.Types[1], (int)GAME_EVENT_NET_GAME_START);
+			SHOULD_INT_EQUAL((int)u.Types[2], (int)GAME_EVENT_ACTOR_MOVE);
+			SHOULD_INT_EQUAL((int)u.Moves[2].UID, 7);
+	SCENARIO_END
+
+	SCENARIO("Unbatched message")
+		GIVEN("a single message packet")
+			NActorMove m = NActorMove_init_default;
+			ENetPacket *packet = NetEncode(GAME_EVENT_ACTOR_MOVE, &m);
+
+		WHEN("I try to unpack it")
+			Unpacked u;
+			memset(&u, 0, sizeof u);
+			const bool isBatch = NetBatchUnpack(packet, OnMsg, &u);
+
+		THEN("it should not be treated as a batch")
+			SHOULD_BE_FALSE(isBatch);
+			SHOULD_INT_EQUAL(u.Count, 0);
+		enet_packet_destroy(packet);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(net_encode, "Message encoding")
+	SCENARIO("Large message")
+		GIVEN("a campaign def with a long path")
+			NCampaignDef m = NCampaignDef_init_default;
+			memset(m.Path, 'a', 2000);
+			m.Path[2000] = '\0';
+			m.Mission = 3;
+
+		WHEN("I encode and decode it")
+			ENetPacket *packet = NetEncode(GAME_EVENT_CAMPAIGN_DEF, &m);
+			NCampaignDef d = NCampaignDef_init_default;
+			const bool ok = NetDecode(packet, &d, NCampaignDef_fields);
+
+		THEN("it should be the same")
+			SHOULD_BE_TRUE(ok);
+			SHOULD_INT_EQUAL((int)strlen(d.Path), 2000);
+			SHOULD_INT_EQUAL((int)d.Mission, 3);
+		enet_packet_destroy(packet);
+	SCENARIO_END
+
+	SCENARIO("Packet reuse")
+		GIVEN("a message packet that has been destroyed")
+			NActorMove m = NActorMove_init_default;
+			ENetPacket *packet = NetEncode(GAME_EVENT_ACTOR_MOVE, &m);
+			const void *data = packet->data;
+			enet_packet_destroy(packet);
+
+		WHEN("I encode another message")
+			packet = NetEncode(GAME_EVENT_ACTOR_MOVE, &m);
+
+		THEN("it should reuse the packet data")
+			SHOULD_BE_TRUE(packet->data == data);
+		enet_packet_destroy(packet);
+		NetPacketPoolTerminate();
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(net_world, "World state transfer")
+	SCENARIO("Compressed world in fragments")
+		GIVEN("a compressed world with many messages")
+			NetWorldBlob b;
+			NetWorldBlobInit(&b, 5);
+			NActorMove m = NActorMove_init_default;
+			for (int i = 0; i < 1000; i++)
+			{
+				m.UID = i;
+				NetWorldBlobAdd(&b, GAME_EVENT_ACTOR_MOVE, &m);
+			}
+			NetWorldBlobAdd(&b, GAME_EVENT_NET_GAME_START, NULL);
+			const bool compressed = NetWorldBlobCompress(&b);
+		WHEN("I receive its fragments, then its start")
+			NetWorldTransfer t;
+			NetWorldTransferInit(&t);
+			int fragments = 0;
+			for (size_t offset = 0; offset < b.Compressed.size;
+				 offset += NET_WORLD_FRAGMENT_MAX)
+			{
+				ENetPacket *packet = NetWorldBlobFragment(&b, offset);
+				NetWorldTransferAdd(&t, packet);
+				enet_packet_destroy(packet);
+				fragments++;
+			}
+			const bool completeBeforeStart = NetWorldTransferIsComplete(&t);
+			ENetPacket *packet = NetWorldBlobStart(&b);
+			NetWorldTransferAdd(&t, packet);
+			enet_packet_destroy(packet);
+		THEN("it should be smaller, complete, and unpack in order")
+			SHOULD_BE_TRUE(compressed);
+			SHOULD_BE_TRUE(b.Compressed.size < b.Data.size);
+			SHOULD_BE_TRUE(fragments > 1);
+			SHOULD_BE_FALSE(completeBeforeStart);
+			SHOULD_BE_TRUE(NetWorldTransferIsComplete(&t));
+			SHOULD_BE_TRUE(NetWorldTransferProgress(&t) == 1.0f);
+			Unpacked u;
+			memset(&u, 0, sizeof u);
+			const bool ok = NetWorldTransferUnpack(&t, OnMsgCount, &u);
+			SHOULD_BE_TRUE(ok);
+			SHOULD_INT_EQUAL(u.Count, 1001);
+			SHOULD_INT_EQUAL((int)u.Moves[0].UID, 999);
+			SHOULD_INT_EQUAL((int)u.Types[0], (int)GAME_EVENT_NET_GAME_START);
+			SHOULD_BE_FALSE(t.Active);
+		NetWorldTransferTerminate(&t);
+		NetWorldBlobTerminate(&b);
+		NetPacketPoolTerminate();
+	SCENARIO_END
+	SCENARIO("Repeated fragment")
+		GIVEN("a compressed world in two fragments")
+			NetWorldBlob b;
+			NetWorldBlobInit(&b, 7);
+			NActorMove m = NActorMove_init_default;
+			for (int i = 0; b.Compressed.size <= NET_WORLD_FRAGMENT_MAX;)
+			{
+				for (int j = 0; j < 100; j++, i++)
+				{
+					m.UID = i;
+					NetWorldBlobAdd(&b, GAME_EVENT_ACTOR_MOVE, &m);
+				}
+				NetWorldBlobCompress(&b);
+			}
+		WHEN("I receive its start and its first fragment twice")
+			NetWorldTransfer t;
+			NetWorldTransferInit(&t);
+			ENetPacket *packet = NetWorldBlobStart(&b);
+			NetWorldTransferAdd(&t, packet);
+			enet_packet_destroy(packet);
+			for (int i = 0; i < 2; i++)
+			{
+				packet = NetWorldBlobFragment(&b, 0);
+				NetWorldTransferAdd(&t, packet);
+				enet_packet_destroy(packet);
+			}
+		THEN("it should not be complete")
+			SHOULD_BE_TRUE(b.Compressed.size <= 2 * NET_WORLD_FRAGMENT_MAX);
+			SHOULD_BE_FALSE(NetWorldTransferIsComplete(&t));
+		AND("it should complete once the second fragment arrives")
+			packet = NetWorldBlobFragment(&b, NET_WORLD_FRAGMENT_MAX);
+			NetWorldTransferAdd(&t, packet);
+			enet_packet_destroy(packet);
+			SHOULD_BE_TRUE(NetWorldTransferIsComplete(&t));
+		NetWorldTransferTerminate(&t);
+		NetWorldBlobTerminate(&b);
+		NetPacketPoolTerminate();
+	SCENARIO_END
+	SCENARIO("Oversized world")
+		GIVEN("a world start claiming to be too large")
+			NetWorldBlob b;
+			NetWorldBlobInit(&b, 6);
+			NetWorldBlobAdd(&b, GAME_EVENT_NET_GAME_START, NULL);
+			NetWorldBlobCompress(&b);
+			ENetPacket *packet = NetWorldBlobStart(&b);
+			NetWorldHeader h;
+			memcpy(&h, packet->data + NET_MSG_SIZE, sizeof h);
+			h.CompressedSize = NET_WORLD_SIZE_MAX + 1;
+			memcpy(packet->data + NET_MSG_SIZE, &h, sizeof h);
+		WHEN("I receive it")
+			NetWorldTransfer t;
+			NetWorldTransferInit(&t);
+			NetWorldTransferAdd(&t, packet);
+			enet_packet_destroy(packet);
+		THEN("it should be ignored")
+			SHOULD_BE_FALSE(t.Active);
+			SHOULD_INT_EQUAL((int)t.Data.size, 0);
+		NetWorldTransferTerminate(&t);
+		NetWorldBlobTerminate(&b);
+		NetPacketPoolTerminate();
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(net_interest, "Interest management")
+	SCENARIO("Gun stops firing out of interest")
+		GIVEN("a gun that fires then stops, far from any player")
+			GameEvent fire = GameEventNew(GAME_EVENT_GUN_FIRE);
+			fire.u.GunFire.ActorUID = 1;
+			fire.u.GunFire.has_MuzzlePos = true;
+			fire.u.GunFire.MuzzlePos = Vec2ToNet(svec2(10000, 10000));
+			GameEvent stop = GameEventNew(GAME_EVENT_GUN_STATE);
+			stop.u.GunState.ActorUID = 1;
+			stop.u.GunState.State = GUNSTATE_READY;
+		WHEN("I get their interest")
+			struct vec2 pos;
+			float reach;
+			const bool fireCulled = GameEventGetInterest(&fire, &pos, &reach);
+			const bool stopCulled = GameEventGetInterest(&stop, &pos, &reach);
+		THEN("the shot can be culled by distance")
+			SHOULD_BE_TRUE(fireCulled);
+		AND("the state change should reach every peer")
+			SHOULD_BE_FALSE(stopCulled);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Net util features are:", TEST_FEATURE(net_batch),
+	TEST_FEATURE(net_encode), TEST_FEATURE(net_world),
+	TEST_FEATURE(net_interest))
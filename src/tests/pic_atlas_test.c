@@ -0,0 +1,120 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <pic_atlas.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+#define NUM_RECTS 100
+
+typedef struct
+{
+	int Page;
+	Rect2i Rect;
+} Packed;
+
+static bool AnyOverlap(const Packed *packed, const int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = i + 1; j < n; j++)
+		{
+			if (packed[i].Page == packed[j].Page &&
+				Rect2iOverlap(packed[i].Rect, packed[j].Rect))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+FEATURE(PicAtlasPack, "Pack rects into atlas pages")
+	SCENARIO("Pack rects of different sizes")
+		GIVEN("an atlas")
+			PicAtlas a;
+			PicAtlasInit(&a, svec2i(256, 256));
+
+		WHEN("I pack a lot of different sized rects")
+			Packed packed[NUM_RECTS];
+			for (int i = 0; i < NUM_RECTS; i++)
+			{
+				const struct vec2i size = svec2i(4 + (i * 7) % 29, 4 + (i * 13) % 23);
+				struct vec2i pos;
+				packed[i].Page = PicAtlasPack(&a, size, &pos);
+				packed[i].Rect = Rect2iNew(pos, size);
+			}
+
+		THEN("they should all fit on one page")
+			bool onePage = true;
+			bool inside = true;
+			for (int i = 0; i < NUM_RECTS; i++)
+			{
+				onePage = onePage && packed[i].Page == 0;
+				const Rect2i r = packed[i].Rect;
+				inside = inside && r.Pos.x >= 0 && r.Pos.y >= 0 &&
+					r.Pos.x + r.Size.x <= 256 && r.Pos.y + r.Size.y <= 256;
+			}
+			SHOULD_BE_TRUE(onePage);
+			SHOULD_BE_TRUE(inside);
+		AND("none of them should overlap")
+			SHOULD_BE_FALSE(AnyOverlap(packed, NUM_RECTS));
+
+		PicAtlasTerminate(&a);
+	SCENARIO_END
+
+	SCENARIO("Pack more rects than a page can hold")
+		GIVEN("an atlas")
+			PicAtlas a;
+			PicAtlasInit(&a, svec2i(64, 64));
+
+		WHEN("I pack more rects than fit on a page")
+			Packed packed[20];
+			for (int i = 0; i < 20; i++)
+			{
+				const struct vec2i size = svec2i(16, 16);
+				struct vec2i pos;
+				packed[i].Page = PicAtlasPack(&a, size, &pos);
+				packed[i].Rect = Rect2iNew(pos, size);
+			}
+
+		THEN("the first page should be filled completely")
+			for (int i = 0; i < 16; i++)
+			{
+				SHOULD_INT_EQUAL(packed[i].Page, 0);
+			}
+		AND("the rest should go on a new page")
+			for (int i = 16; i < 20; i++)
+			{
+				SHOULD_INT_EQUAL(packed[i].Page, 1);
+			}
+			SHOULD_INT_EQUAL((int)a.Pages.size, 2);
+		AND("none of them should overlap")
+			SHOULD_BE_FALSE(AnyOverlap(packed, 20));
+
+		PicAtlasTerminate(&a);
+	SCENARIO_END
+
+	SCENARIO("Pack a rect bigger than a page")
+		GIVEN("an atlas")
+			PicAtlas a;
+			PicAtlasInit(&a, svec2i(64, 64));
+
+		WHEN("I pack a rect bigger than a page")
+			struct vec2i pos;
+			const int page = PicAtlasPack(&a, svec2i(65, 8), &pos);
+
+		THEN("it should not be packed")
+			SHOULD_INT_EQUAL(page, -1);
+			SHOULD_INT_EQUAL((int)a.Pages.size, 0);
+
+		PicAtlasTerminate(&a);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Pic atlas features are:", TEST_FEATURE(PicAtlasPack))
@@ -0,0 +1,18 @@
+# Record a short headless mission, then play the recording back headless.
+# Playback exits with failure if its final state hash differs from the
+# recorded one.
+# Usage: cmake -DCDOGS=<cdogs-sdl> -DREPLAY=<file> -P replay_roundtrip.cmake
+file(REMOVE ${REPLAY})
+execute_process(
+	COMMAND ${CDOGS} --headless --seed=7 --players=2 --ticks=900
+		--record=${REPLAY}
+	RESULT_VARIABLE result)
+if(NOT result EQUAL 0 OR NOT EXISTS ${REPLAY})
+	message(FATAL_ERROR "Recording failed (${result})")
+endif()
+execute_process(
+	COMMAND ${CDOGS} --replay=${REPLAY}
+	RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "Replay desynced (${result})")
+endif()
@@ -0,0 +1,137 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <replay.h>
+
+#include <string.h>
+
+#include <config.h>
+
+
+FEATURE(record_and_play, "Record and play back commands")
+	SCENARIO("Repeated commands")
+		GIVEN("a recording replay")
+			Replay r;
+			ReplayInit(&r);
+			r.Mode = REPLAY_MODE_RECORD;
+			r.NumPlayers = 1;
+
+		WHEN("I record the same command for three ticks then a new one")
+			int cmds[MAX_LOCAL_PLAYERS] = {CMD_LEFT, 0, 0, 0};
+			ReplayTick(&r, cmds);
+			ReplayTick(&r, cmds);
+			ReplayTick(&r, cmds);
+			cmds[0] = CMD_BUTTON1;
+			ReplayTick(&r, cmds);
+
+		THEN("it should have four ticks in two runs")
+			SHOULD_INT_EQUAL(r.Ticks, 4);
+			SHOULD_INT_EQUAL((int)r.Runs.size, 2);
+		AND("playing it back should return the same commands")
+			r.Mode = REPLAY_MODE_PLAY;
+			int played[4];
+			for (int i = 0; i < 4; i++)
+			{
+				int c[MAX_LOCAL_PLAYERS] = {0, 0, 0, 0};
+				ReplayTick(&r, c);
+				played[i] = c[0];
+			}
+			SHOULD_INT_EQUAL(played[0], CMD_LEFT);
+			SHOULD_INT_EQUAL(played[2], CMD_LEFT);
+			SHOULD_INT_EQUAL(played[3], CMD_BUTTON1);
+		AND("playback should end after the recorded ticks")
+			SHOULD_BE_FALSE(ReplayTick(&r, cmds));
+		ReplayTerminate(&r);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(save_and_load, "Save and load")
+	SCENARIO("Save and load")
+		GIVEN("a replay with some values")
+			Replay r1;
+			ReplayInit(&r1);
+			CSTRDUP(r1.CampaignPath, "missions/ogre.cdogscpn");
+			r1.MissionIndex = 2;
+			r1.SpawnSeed = 1234;
+			ReplayConfig rc;
+			CSTRDUP(rc.Name, "Game.RandomSeed");
+			rc.Value = 42;
+			CArrayPushBack(&r1.Configs, &rc);
+			r1.NumPlayers = 1;
+			r1.Players[0].IsAI = true;
+			CSTRDUP(r1.Players[0].Guns[0], "Machine gun");
+			r1.Players[0].Lives = 3;
+			r1.Mode = REPLAY_MODE_RECORD;
+			int cmds[MAX_LOCAL_PLAYERS] = {CMD_UP | CMD_GRENADE, 0, 0, 0};
+			ReplayTick(&r1, cmds);
+			r1.Hash = 0x0123456789abcdefULL;
+		AND("I save it to file")
+			ReplaySave(&r1, "tmp");
+
+		WHEN("I load a second replay from that file")
+			Replay r2;
+			ReplayInit(&r2);
+			const bool loaded = ReplayLoad(&r2, "tmp");
+
+		THEN("it should load")
+			SHOULD_BE_TRUE(loaded);
+		AND("their campaigns and seeds should equal")
+			SHOULD_STR_EQUAL(r2.CampaignPath, r1.CampaignPath);
+			SHOULD_INT_EQUAL(r2.MissionIndex, r1.MissionIndex);
+			SHOULD_INT_EQUAL((int)r2.SpawnSeed, (int)r1.SpawnSeed);
+		AND("their configs should equal")
+			SHOULD_INT_EQUAL((int)r2.Configs.size, 1);
+			const ReplayConfig *rc2 = CArrayGet(&r2.Configs, 0);
+			SHOULD_STR_EQUAL(rc2->Name, rc.Name);
+			SHOULD_INT_EQUAL(rc2->Value, rc.Value);
+		AND("their players should equal")
+			SHOULD_INT_EQUAL(r2.NumPlayers, 1);
+			SHOULD_BE_TRUE(r2.Players[0].IsAI);
+			SHOULD_STR_EQUAL(r2.Players[0].Guns[0], "Machine gun");
+			SHOULD_BE_TRUE(r2.Players[0].Guns[1] == NULL);
+			SHOULD_INT_EQUAL(r2.Players[0].Lives, 3);
+		AND("their commands and hashes should equal")
+			SHOULD_INT_EQUAL(r2.Ticks, 1);
+			const ReplayRun *run = CArrayGet(&r2.Runs, 0);
+			SHOULD_INT_EQUAL(run->Cmds[0], CMD_UP | CMD_GRENADE);
+			SHOULD_BE_TRUE(r2.Hash == r1.Hash);
+		ReplayTerminate(&r1);
+		ReplayTerminate(&r2);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(apply_players, "Apply players")
+	SCENARIO("Human and AI players")
+		GIVEN("two local players")
+			PlayerDataInit(&gPlayerDatas);
+			gConfig = ConfigDefault();
+			NPlayerData pd = PlayerDataDefault(0);
+			PlayerDataAddOrUpdate(pd);
+			pd.UID = 1;
+			PlayerDataAddOrUpdate(pd);
+		AND("a replay recorded with a human then an AI player")
+			Replay r;
+			ReplayInit(&r);
+			r.NumPlayers = 2;
+			r.Players[1].IsAI = true;
+
+		WHEN("I apply the replay players")
+			ReplayApplyPlayers(&r);
+
+		THEN("the human should only follow the recorded commands")
+			const PlayerData *p0 = CArrayGet(&gPlayerDatas, 0);
+			SHOULD_INT_EQUAL((int)p0->inputDevice, (int)INPUT_DEVICE_REPLAY);
+		AND("the AI should be re-simulated")
+			const PlayerData *p1 = CArrayGet(&gPlayerDatas, 1);
+			SHOULD_INT_EQUAL((int)p1->inputDevice, (int)INPUT_DEVICE_AI);
+		ReplayTerminate(&r);
+		PlayerDataTerminate(&gPlayerDatas);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Replay features are:",
+	TEST_FEATURE(record_and_play),
+	TEST_FEATURE(save_and_load),
+	TEST_FEATURE(apply_players)
+)
@@ -58,4 +58,40 @@ FEATURE(path_funcs, "Path functions")
 #endif
 FEATURE_END
 
-CBEHAVE_RUN("Pic features are:", TEST_FEATURE(path_funcs))
+FEATURE(hash_funcs, "Hash functions")
+	SCENARIO("Hash bytes")
+		GIVEN("a byte")
+			const char *data = "a";
+
+		WHEN("I hash it")
+			const uint64_t h = Hash64(HASH64_INIT, data, 1);
+
+		THEN("the result should be its FNV-1a hash")
+			SHOULD_BE_TRUE(h == 0xaf63dc4c8601ec8cull);
+	SCENARIO_END
+
+	SCENARIO("Hash strings")
+		GIVEN("a string")
+			const char *s = "chars/bodies";
+
+		WHEN("I hash it as a string")
+			const uint64_t h = Hash64Str(HASH64_INIT, s);
+
+		THEN("the result should be the hash of its bytes and terminator")
+			SHOULD_BE_TRUE(h == Hash64(HASH64_INIT, s, strlen(s) + 1));
+	SCENARIO_END
+
+	SCENARIO("Hash a NULL string")
+		GIVEN("a hash")
+			const uint64_t h = Hash64(HASH64_INIT, "a", 1);
+
+		WHEN("I hash a NULL string into it")
+			const uint64_t h2 = Hash64Str(h, NULL);
+
+		THEN("the hash should be unchanged")
+			SHOULD_BE_TRUE(h2 == h);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Pic features are:", TEST_FEATURE(path_funcs), TEST_FEATURE(hash_funcs))